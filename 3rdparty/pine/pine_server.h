@@ -72,6 +72,8 @@ namespace pine
 		int m_sock = 0;
 		// the message socket used in thread's accept().
 		int m_msgsock = 0;
+		// read-only guest memory descriptor sent along with the next reply.
+		int m_shared_fd = -1;
 #endif
 
 		/**
@@ -121,6 +123,11 @@ namespace pine
 			MsgUUID = 0xD,          /**< Returns the game UUID. */
 			MsgGameVersion = 0xE,   /**< Returns the game verion. */
 			MsgStatus = 0xF,        /**< Returns the emulator status. */
+			MsgReadBlock = 0x10,    /**< Read a contiguous block of memory. */
+			MsgWriteBlock = 0x11,   /**< Write a contiguous block of memory. */
+			MsgReadBatch = 0x12,    /**< Read values of the same size from a list of addresses. */
+			MsgWriteBatch = 0x13,   /**< Write values of the same size to a list of addresses. */
+			MsgShareMemory = 0x14,  /**< Share main memory read-only with a local client. */
 			MsgUnimplemented = 0xFF /**< Unimplemented IPC message. */
 		};
 
@@ -161,6 +168,12 @@ namespace pine
 
 			const auto error = [&]()
 			{
+#ifndef _WIN32
+				if (m_shared_fd >= 0)
+				{
+					close_portable(std::exchange(m_shared_fd, -1));
+				}
+#endif
 				return IPCBuffer{ 5, MakeFailIPC(ret_buffer) };
 			};
 
@@ -331,6 +344,99 @@ namespace pine
 						return error();
 					break;
 				}
+				// Bulk memory commands, so that tools sampling many addresses don't need a round trip per value
+				//         IPC Message event (1 byte)
+				//         |  Memory address (4 byte)
+				//         |  |           Size (4 byte)
+				//         |  |           |           data (Size bytes, MsgWriteBlock only)
+				//         |  |           |           |
+				// format: XX YY YY YY YY SS SS SS SS ZZ ..
+				// reply: XX [ZZ ..] (raw guest memory, big endian)
+				case MsgReadBlock:
+				{
+					if (!SafetyChecks(buf_cnt, 8, ret_cnt, 0, buf_size))
+						return error();
+					const u32 a = FromArray<u32>(&buf[buf_cnt], 0);
+					const u32 size = FromArray<u32>(&buf[buf_cnt], 4);
+					if (!SafetyChecks(buf_cnt, 8, ret_cnt, size, buf_size))
+						return error();
+					if (!Impl::read_block(a, &ret_buffer[ret_cnt], size))
+						return error();
+					ret_cnt += size;
+					buf_cnt += 8;
+					break;
+				}
+				case MsgWriteBlock:
+				{
+					if (!SafetyChecks(buf_cnt, 8, ret_cnt, 0, buf_size))
+						return error();
+					const u32 a = FromArray<u32>(&buf[buf_cnt], 0);
+					const u32 size = FromArray<u32>(&buf[buf_cnt], 4);
+					if (!SafetyChecks(buf_cnt, usz{8} + size, ret_cnt, 0, buf_size))
+						return error();
+					if (!Impl::write_block(a, &buf[buf_cnt + 8], size))
+						return error();
+					buf_cnt += usz{8} + size;
+					break;
+				}
+				//         IPC Message event (1 byte)
+				//         |  Value size: 1, 2, 4 or 8 (1 byte)
+				//         |  |  Count (4 byte)
+				//         |  |  |           Memory addresses (4 byte each), followed by the value for MsgWriteBatch
+				//         |  |  |           |
+				// format: XX WW NN NN NN NN YY YY YY YY [ZZ ..] ..
+				// reply: XX [ZZ ..] .. (values in the same format as MsgRead8-64)
+				case MsgReadBatch:
+				case MsgWriteBatch:
+				{
+					if (!SafetyChecks(buf_cnt, 5, ret_cnt, 0, buf_size))
+						return error();
+					const u8 width = FromArray<u8>(&buf[buf_cnt], 0);
+					const u32 count = FromArray<u32>(&buf[buf_cnt], 1);
+					const bool is_write = command == MsgWriteBatch;
+					const usz entry_size = is_write ? usz{4} + width : 4;
+					const usz reply_size = is_write ? 0 : usz{count} * width;
+					if (!SafetyChecks(buf_cnt, 5 + entry_size * count, ret_cnt, reply_size, buf_size))
+						return error();
+					bool ok = false;
+					switch (width)
+					{
+					case 1: ok = is_write ? WriteBatch<u8>(&buf[buf_cnt + 5], count) : ReadBatch<u8>(&buf[buf_cnt + 5], count, &ret_buffer[ret_cnt]); break;
+					case 2: ok = is_write ? WriteBatch<u16>(&buf[buf_cnt + 5], count) : ReadBatch<u16>(&buf[buf_cnt + 5], count, &ret_buffer[ret_cnt]); break;
+					case 4: ok = is_write ? WriteBatch<u32>(&buf[buf_cnt + 5], count) : ReadBatch<u32>(&buf[buf_cnt + 5], count, &ret_buffer[ret_cnt]); break;
+					case 8: ok = is_write ? WriteBatch<u64>(&buf[buf_cnt + 5], count) : ReadBatch<u64>(&buf[buf_cnt + 5], count, &ret_buffer[ret_cnt]); break;
+					default: break;
+					}
+					if (!ok)
+						return error();
+					ret_cnt += reply_size;
+					buf_cnt += 5 + entry_size * count;
+					break;
+				}
+				// Main memory is sent as a read-only file descriptor (SCM_RIGHTS) along with the reply,
+				// the client maps it to read guest memory without further requests. Opt-in, not available on Windows.
+				// reply: XX AA AA AA AA SS SS SS SS SS SS SS SS (guest address and size of the shared memory)
+				case MsgShareMemory:
+				{
+#ifdef _WIN32
+					return error();
+#else
+					if (!SafetyChecks(buf_cnt, 0, ret_cnt, 12, buf_size))
+						return error();
+					u32 addr = 0;
+					u64 size = 0;
+					const int fd = Impl::get_shared_memory(addr, size);
+					if (fd < 0)
+						return error();
+					if (m_shared_fd >= 0)
+						close_portable(m_shared_fd);
+					m_shared_fd = fd;
+					ToArray(ret_buffer, addr, ret_cnt);
+					ToArray(ret_buffer, size, ret_cnt + 4);
+					ret_cnt += 12;
+					break;
+#endif
+				}
 				default:
 				{
 					return error();
@@ -340,6 +446,98 @@ namespace pine
 			return IPCBuffer{ ret_cnt, MakeOkIPC(ret_buffer, ret_cnt) };
 		}
 
+		template <typename T>
+		static T ReadValue(u32 addr)
+		{
+			if constexpr (sizeof(T) == 1)
+				return Impl::read8(addr);
+			else if constexpr (sizeof(T) == 2)
+				return Impl::read16(addr);
+			else if constexpr (sizeof(T) == 4)
+				return Impl::read32(addr);
+			else
+				return Impl::read64(addr);
+		}
+
+		template <typename T>
+		static void WriteValue(u32 addr, T value)
+		{
+			if constexpr (sizeof(T) == 1)
+				Impl::write8(addr, value);
+			else if constexpr (sizeof(T) == 2)
+				Impl::write16(addr, value);
+			else if constexpr (sizeof(T) == 4)
+				Impl::write32(addr, value);
+			else
+				Impl::write64(addr, value);
+		}
+
+		/**
+		 * Reads values from a list of addresses.
+		 * return value: false if any address is invalid.
+		 */
+		template <typename T>
+		static bool ReadBatch(char* addrs, u32 count, char* ret_buffer)
+		{
+			for (u32 i = 0; i < count; i++)
+			{
+				const u32 a = FromArray<u32>(addrs, i * 4);
+				if (!Impl::template check_addr<sizeof(T)>(a))
+					return false;
+				ToArray(ret_buffer, ReadValue<T>(a), i * sizeof(T));
+			}
+			return true;
+		}
+
+		/**
+		 * Writes values to a list of addresses, nothing is written if any address is invalid.
+		 * return value: false if any address is invalid.
+		 */
+		template <typename T>
+		static bool WriteBatch(char* entries, u32 count)
+		{
+			constexpr u32 entry_size = 4 + sizeof(T);
+			for (u32 i = 0; i < count; i++)
+			{
+				if (!Impl::template check_addr<sizeof(T)>(FromArray<u32>(entries, i * entry_size), vm::page_writable))
+					return false;
+			}
+			for (u32 i = 0; i < count; i++)
+			{
+				WriteValue<T>(FromArray<u32>(entries, i * entry_size), FromArray<T>(entries, i * entry_size + 4));
+			}
+			return true;
+		}
+
+		/**
+		 * Sends a reply, along with the shared memory descriptor if requested.
+		 * return value: false if the socket failed.
+		 */
+		bool SendReply(const IPCBuffer& res)
+		{
+#ifndef _WIN32
+			if (m_shared_fd >= 0)
+			{
+				::iovec iov{ res.buffer, res.size };
+				alignas(::cmsghdr) char control[CMSG_SPACE(sizeof(int))]{};
+				::msghdr msg{};
+				msg.msg_iov = &iov;
+				msg.msg_iovlen = 1;
+				msg.msg_control = control;
+				msg.msg_controllen = sizeof(control);
+				::cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+				cmsg->cmsg_level = SOL_SOCKET;
+				cmsg->cmsg_type = SCM_RIGHTS;
+				cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+				memcpy(CMSG_DATA(cmsg), &m_shared_fd, sizeof(int));
+				const auto sent = ::sendmsg(m_msgsock, &msg, 0);
+				close_portable(std::exchange(m_shared_fd, -1));
+				return sent >= 0;
+			}
+#endif
+			return write_portable(m_msgsock, res.buffer, res.size) >= 0;
+		}
+
 		/**
 		 * Formats an IPC buffer
 		 * ret_buffer: return buffer to use.
@@ -469,7 +667,7 @@ namespace pine
 					pine_server::IPCBuffer res = ParseCommand(&m_ipc_buffer[4], m_ret_buffer.data(), static_cast<u32>(end_length) - 4);
 
 					// if we cannot send back our answer restart the socket
-					if (write_portable(m_msgsock, res.buffer, res.size) < 0)
+					if (!SendReply(res))
 					{
 						if (!StartSocket())
 							return;
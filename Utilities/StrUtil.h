@@ -42,65 +42,73 @@ namespace fmt
 	// Replaces all occurrences of 'from' with 'to' until 'count' substrings were replaced.
 	std::string replace_all(std::string_view src, std::string_view from, std::string_view to, usz count = umax);
 
-	template <usz list_size>
-	std::string replace_all(std::string src, const std::pair<std::string_view, std::string> (&list)[list_size])
+	// Single pass over 'src', at each position the first matching pattern in 'list' is replaced; replaced text is not rescanned.
+	// 'get' returns the replacement for the matched list index and is called in order of appearance.
+	template <typename List, typename Get>
+	std::string replace_all_list(std::string src, const List& list, Get&& get)
 	{
-		if constexpr (list_size == 0)
-			return src;
+		const std::string_view view = src;
 
-		for (usz pos = 0; pos < src.length(); ++pos)
+		std::string result;
+		usz copied = 0;
+
+		for (usz pos = 0; pos < view.size();)
 		{
-			for (usz i = 0; i < list_size; ++i)
-			{
-				const usz comp_length = list[i].first.length();
+			usz i = 0;
 
-				if (src.length() - pos < comp_length)
-				{
-					continue;
-				}
+			for (; i < std::size(list); i++)
+			{
+				const std::string_view from = list[i].first;
 
-				if (src.substr(pos, comp_length) == list[i].first)
+				if (!from.empty() && view[pos] == from[0] && view.substr(pos, from.size()) == from)
 				{
-					src.erase(pos, comp_length);
-					src.insert(pos, list[i].second.data(), list[i].second.length());
-					pos += list[i].second.length() - 1;
 					break;
 				}
 			}
+
+			if (i == std::size(list))
+			{
+				pos++;
+				continue;
+			}
+
+			if (!copied)
+			{
+				result.reserve(view.size() + view.size() / 2);
+			}
+
+			result.append(view.substr(copied, pos - copied));
+			result.append(get(i));
+			pos += std::string_view(list[i].first).size();
+			copied = pos;
+		}
+
+		if (!copied)
+		{
+			// Nothing matched
+			return src;
 		}
 
-		return src;
+		result.append(view.substr(copied));
+		return result;
 	}
 
 	template <usz list_size>
-	std::string replace_all(std::string src, const std::pair<std::string_view, std::function<std::string()>> (&list)[list_size])
+	std::string replace_all(std::string src, const std::pair<std::string_view, std::string> (&list)[list_size])
 	{
 		if constexpr (list_size == 0)
 			return src;
+		else
+			return replace_all_list(std::move(src), list, [&](usz i) -> const std::string& { return list[i].second; });
+	}
 
-		for (usz pos = 0; pos < src.length(); ++pos)
-		{
-			for (usz i = 0; i < list_size; ++i)
-			{
-				const usz comp_length = list[i].first.length();
-
-				if (src.length() - pos < comp_length)
-				{
-					continue;
-				}
-
-				if (src.substr(pos, comp_length) == list[i].first)
-				{
-					src.erase(pos, comp_length);
-					auto replacement = list[i].second();
-					src.insert(pos, replacement);
-					pos += replacement.length() - 1;
-					break;
-				}
-			}
-		}
-
-		return src;
+	template <usz list_size>
+	std::string replace_all(std::string src, const std::pair<std::string_view, std::function<std::string()>> (&list)[list_size])
+	{
+		if constexpr (list_size == 0)
+			return src;
+		else
+			return replace_all_list(std::move(src), list, [&](usz i) { return list[i].second(); });
 	}
 
 	static inline
@@ -109,28 +117,7 @@ namespace fmt
 		if (list.empty())
 			return src;
 
-		for (usz pos = 0; pos < src.length(); ++pos)
-		{
-			for (usz i = 0; i < list.size(); ++i)
-			{
-				const usz comp_length = list[i].first.length();
-
-				if (src.length() - pos < comp_length)
-				{
-					continue;
-				}
-
-				if (src.substr(pos, comp_length) == list[i].first)
-				{
-					src.erase(pos, comp_length);
-					src.insert(pos, list[i].second);
-					pos += list[i].second.length() - 1;
-					break;
-				}
-			}
-		}
-
-		return src;
+		return replace_all_list(std::move(src), list, [&](usz i) -> const std::string& { return list[i].second; });
 	}
 
 	// Splits the string into a vector of strings using the separators. The vector may contain empty strings unless is_skip_empty is true.
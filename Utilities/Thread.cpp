@@ -3337,3 +3337,222 @@ bool thread_ctrl::is_main()
 {
 	return get_tid() == utils::main_tid;
 }
+
+struct task_pool::state
+{
+	shared_mutex mutex;
+
+	// Jobs which may still have unclaimed slots, ordered by priority (and by submission order)
+	std::vector<shared_ptr<task_job>> queue;
+
+	// Owned threads, they stay parked when the queue is empty
+	std::vector<std::unique_ptr<named_thread<worker>>> threads;
+
+	// Threads waiting for new jobs
+	u32 idle = 0;
+
+	// Incremented on every submission to wake up parked threads
+	atomic_t<u32> signal = 0;
+};
+
+task_pool::state& task_pool::get_state()
+{
+	static state s_pool;
+	return s_pool;
+}
+
+static thread_local bool s_tls_task_pool_thread = false;
+
+task_job::task_job(std::string_view name, u32 slots, task_priority prio, std::function<void(task_job&, u32)> func) noexcept
+	: m_func(std::move(func))
+	, m_slots(slots)
+	, m_pending(slots)
+	, m_start_time(get_system_time())
+	, name(name)
+	, priority(prio)
+{
+}
+
+bool task_job::run_slot()
+{
+	const u32 slot = m_next_slot++;
+
+	if (slot >= m_slots)
+	{
+		return false;
+	}
+
+	if (!m_cancelled)
+	{
+		m_func(*this, slot);
+	}
+
+	retire_slots(1);
+	return true;
+}
+
+void task_job::retire_slots(u32 count)
+{
+	if (count && m_pending.sub_fetch(count) == 0)
+	{
+		const u64 elapsed = get_system_time() - m_start_time;
+
+		// Short jobs (e.g. per-frame work) would only spam the log
+		(elapsed >= 100'000 ? sys_log.notice : sys_log.trace)("Task '%s' finished in %.3fs (progress: %u/%u, cancelled=%d)", name, elapsed / 1000000., m_done.load(), m_total.load(), m_cancelled.load());
+		m_pending.notify_all();
+	}
+}
+
+void task_job::cancel() noexcept
+{
+	m_cancelled = true;
+
+	// Claim all remaining slots at once, nobody is going to run them
+	const u32 next = m_next_slot.fetch_op([&](u32& value)
+	{
+		value = std::max(value, m_slots);
+	});
+
+	retire_slots(m_slots - std::min(next, m_slots));
+}
+
+void task_job::help()
+{
+	while (run_slot())
+	{
+	}
+}
+
+bool task_job::join()
+{
+	if (task_pool::is_current_thread())
+	{
+		// Help with the remaining slots: pool threads waiting on nested jobs cannot starve the pool this way
+		help();
+	}
+
+	while (const u32 pending = m_pending)
+	{
+		m_pending.wait(pending);
+	}
+
+	return !m_cancelled;
+}
+
+void task_pool::worker::operator()()
+{
+	s_tls_task_pool_thread = true;
+
+	run_worker();
+}
+
+void task_pool::run_worker()
+{
+	auto& pool = get_state();
+
+	while (thread_ctrl::state() != thread_state::aborting)
+	{
+		shared_ptr<task_job> job;
+		u32 signal = 0;
+		{
+			std::lock_guard lock(pool.mutex);
+
+			while (!pool.queue.empty())
+			{
+				auto& front = pool.queue.front();
+
+				if (front->m_next_slot < front->m_slots && !front->m_cancelled)
+				{
+					job = front;
+					break;
+				}
+
+				// Remove exhausted job
+				pool.queue.erase(pool.queue.begin());
+			}
+
+			if (!job)
+			{
+				// Registered while holding the lock so submit() does not spawn a thread for it
+				pool.idle++;
+				signal = pool.signal;
+			}
+		}
+
+		if (!job)
+		{
+			// Park until the next submission
+			thread_ctrl::wait_on(pool.signal, signal);
+
+			std::lock_guard lock(pool.mutex);
+			pool.idle--;
+			continue;
+		}
+
+		job->run_slot();
+	}
+}
+
+shared_ptr<task_job> task_pool::submit(std::string_view name, u32 slots, task_priority prio, std::function<void(task_job&, u32)> func)
+{
+	auto job = make_shared<task_job>(name, slots, prio, std::move(func));
+
+	if (!slots)
+	{
+		return job;
+	}
+
+	auto& pool = get_state();
+
+	std::lock_guard lock(pool.mutex);
+
+	// Insert after every job of the same or higher priority
+	const auto pos = std::find_if(pool.queue.begin(), pool.queue.end(), [&](const shared_ptr<task_job>& other)
+	{
+		return other->priority < prio;
+	});
+
+	pool.queue.insert(pos, job);
+
+	// Wake up parked threads first, only spawn new ones if there are not enough of them
+	pool.signal++;
+
+	for (u32 i = pool.idle, limit = get_thread_limit(); i < slots && pool.threads.size() < limit; i++)
+	{
+		pool.threads.emplace_back(std::make_unique<named_thread<worker>>(fmt::format("Task Worker %u", pool.threads.size() + 1)));
+	}
+
+	if (pool.idle)
+	{
+		pool.signal.notify_all();
+	}
+
+	return job;
+}
+
+void task_pool::cancel_all()
+{
+	auto& pool = get_state();
+
+	std::vector<shared_ptr<task_job>> jobs;
+	{
+		std::lock_guard lock(pool.mutex);
+		jobs = std::move(pool.queue);
+		pool.queue.clear();
+	}
+
+	for (const auto& job : jobs)
+	{
+		job->cancel();
+	}
+}
+
+u32 task_pool::get_thread_limit()
+{
+	return std::max<u32>(utils::get_thread_count(), 1);
+}
+
+bool task_pool::is_current_thread()
+{
+	return s_tls_task_pool_thread;
+}
@@ -5,6 +5,7 @@
 #include "util/shared_ptr.hpp"
 
 #include <string>
+#include <functional>
 
 // Hardware core layout
 enum class native_core_arrangement : u32
@@ -889,3 +890,119 @@ public:
 		::operator delete(static_cast<void*>(m_threads), std::align_val_t{alignof(Thread)});
 	}
 };
+
+enum class task_priority : u32
+{
+	low,
+	normal,
+	high,
+};
+
+// Background job executed by the shared task pool
+class task_job final
+{
+	friend class task_pool;
+
+	std::function<void(task_job&, u32)> m_func;
+
+	const u32 m_slots;
+
+	// Next slot index to claim (may overshoot m_slots)
+	atomic_t<u32> m_next_slot{0};
+
+	// Slots which have not finished yet
+	atomic_t<u32> m_pending;
+
+	atomic_t<bool> m_cancelled{false};
+
+	// Progress reported by the job function
+	atomic_t<u64> m_done{0};
+	atomic_t<u64> m_total{0};
+
+	const u64 m_start_time;
+
+	// Claim one slot and run it on the current thread, returns false if no slot was left
+	bool run_slot();
+
+	// Mark slots as finished
+	void retire_slots(u32 count);
+
+public:
+	const std::string name;
+	const task_priority priority;
+
+	task_job(std::string_view name, u32 slots, task_priority prio, std::function<void(task_job&, u32)> func) noexcept;
+
+	task_job(const task_job&) = delete;
+
+	task_job& operator=(const task_job&) = delete;
+
+	// Prevent unclaimed slots from starting (they are retired), running slots should poll is_cancelled()
+	void cancel() noexcept;
+
+	bool is_cancelled() const noexcept
+	{
+		return m_cancelled;
+	}
+
+	void add_total(u64 count) noexcept
+	{
+		m_total += count;
+	}
+
+	void add_done(u64 count = 1) noexcept
+	{
+		m_done += count;
+	}
+
+	u64 get_done() const noexcept
+	{
+		return m_done;
+	}
+
+	u64 get_total() const noexcept
+	{
+		return m_total;
+	}
+
+	bool is_finished() const noexcept
+	{
+		return !m_pending;
+	}
+
+	// Run unclaimed slots on the current thread (latency sensitive callers which would otherwise wait for a free pool thread)
+	void help();
+
+	// Wait for all slots to finish, returns false if the job has been cancelled
+	bool join();
+};
+
+// Process-wide pool of worker threads shared by long background workloads (compilation, installation).
+// A job asks for a number of slots, each slot runs the job function once with its slot index (the function is expected to pull work from a shared cursor).
+// Slots of all jobs are run by at most utils::get_thread_count() threads, higher priority jobs being served first.
+class task_pool final
+{
+	struct worker
+	{
+		void operator()();
+	};
+
+	struct state;
+
+	static state& get_state();
+
+	// Serve the queue, park while there is no unclaimed slot left
+	static void run_worker();
+
+public:
+	static shared_ptr<task_job> submit(std::string_view name, u32 slots, task_priority prio, std::function<void(task_job&, u32)> func);
+
+	// Cancel every queued job (emulation stop)
+	static void cancel_all();
+
+	// Maximum amount of threads running jobs concurrently
+	static u32 get_thread_limit();
+
+	// Check whether the current thread is one of the pool threads
+	static bool is_current_thread();
+};
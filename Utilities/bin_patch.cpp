@@ -10,6 +10,8 @@
 
 #include "util/types.hpp"
 #include "util/asm.hpp"
+#include "util/serialization.hpp"
+#include "util/fnv_hash.hpp"
 
 #include <charconv>
 #include <regex>
@@ -886,13 +888,447 @@ bool patch_engine::read_patch_node(patch_info& info, YAML::Node node, const YAML
 	return is_valid;
 }
 
+// Bump when the layout of the compiled patch files changes
+static constexpr u32 c_compiled_patch_version = 2;
+static const std::string c_compiled_patch_magic = "RPCS3PAT";
+
+// File layout: header size, blobs size, header checksum, header, blobs
+struct compiled_patch_prefix
+{
+	u64 header_size;
+	u64 blobs_size;
+	u64 header_checksum;
+};
+
+// Deserialization can't fail gracefully (it asserts on truncated data), so everything is checked against this first
+static u64 get_compiled_patch_checksum(const u8* data, usz size)
+{
+	usz hash = rpcs3::fnv_seed;
+
+	for (usz i = 0; i < size; i++)
+	{
+		hash = rpcs3::hash64(hash, data[i]);
+	}
+
+	return hash;
+}
+
+static void save_patch_container(utils::serial& ar, const patch_engine::patch_container& container)
+{
+	ar(container.hash, container.version, usz{container.patch_info_map.size()});
+
+	for (const auto& [description, info] : container.patch_info_map)
+	{
+		ar(description, info.patch_version, info.patch_group, info.author, info.notes, usz{info.data_list.size()});
+
+		for (const patch_engine::patch_data& p : info.data_list)
+		{
+			ar(p.type, p.offset, p.original_offset, p.original_value, p.value.long_value);
+		}
+
+		// Only the app versions are stored, the patch config is applied when loading
+		ar(usz{info.titles.size()});
+
+		for (const auto& [title, serials] : info.titles)
+		{
+			ar(title, usz{serials.size()});
+
+			for (const auto& [serial, app_versions] : serials)
+			{
+				ar(serial, usz{app_versions.size()});
+
+				for (const auto& [app_version, config_values] : app_versions)
+				{
+					ar(app_version);
+				}
+			}
+		}
+
+		ar(usz{info.default_config_values.size()});
+
+		for (const auto& [key, config_value] : info.default_config_values)
+		{
+			ar(key, config_value.value, config_value.min, config_value.max, config_value.type, usz{config_value.allowed_values.size()});
+
+			for (const patch_engine::patch_allowed_value& allowed_value : config_value.allowed_values)
+			{
+				ar(allowed_value.label, allowed_value.value);
+			}
+		}
+	}
+}
+
+static void load_patch_container(utils::serial& ar, patch_engine::patch_container& container)
+{
+	usz info_count = 0;
+	ar(container.hash, container.version, info_count);
+
+	for (usz i = 0; i < info_count; i++)
+	{
+		patch_engine::patch_info info{};
+		usz count = 0;
+		ar(info.description, info.patch_version, info.patch_group, info.author, info.notes, count);
+
+		info.data_list.resize(count);
+
+		for (patch_engine::patch_data& p : info.data_list)
+		{
+			ar(p.type, p.offset, p.original_offset, p.original_value, p.value.long_value);
+		}
+
+		ar(count);
+
+		for (usz title_idx = 0; title_idx < count; title_idx++)
+		{
+			std::string title;
+			usz serial_count = 0;
+			ar(title, serial_count);
+
+			patch_engine::patch_serials& serials = info.titles[title];
+
+			for (usz serial_idx = 0; serial_idx < serial_count; serial_idx++)
+			{
+				std::string serial;
+				usz version_count = 0;
+				ar(serial, version_count);
+
+				patch_engine::patch_app_versions& app_versions = serials[serial];
+
+				for (usz version_idx = 0; version_idx < version_count; version_idx++)
+				{
+					app_versions.emplace(ar.pop<std::string>(), patch_engine::patch_config_values{});
+				}
+			}
+		}
+
+		ar(count);
+
+		for (usz value_idx = 0; value_idx < count; value_idx++)
+		{
+			std::string key;
+			usz allowed_count = 0;
+			patch_engine::patch_config_value config_value{};
+			ar(key, config_value.value, config_value.min, config_value.max, config_value.type, allowed_count);
+
+			config_value.allowed_values.resize(allowed_count);
+
+			for (patch_engine::patch_allowed_value& allowed_value : config_value.allowed_values)
+			{
+				ar(allowed_value.label, allowed_value.value);
+			}
+
+			info.default_config_values.emplace(std::move(key), std::move(config_value));
+		}
+
+		info.hash = container.hash;
+		info.version = container.version;
+		container.patch_info_map.emplace(info.description, std::move(info));
+	}
+}
+
+static bool save_compiled_patches(const std::string& cache_path, const fs::stat_t& source_stat, const patch_engine::patch_map& patches)
+{
+	// Index of the containers by serial, so only the ones of the booted title need to be read
+	std::map<std::string, std::vector<u32>> serial_index;
+	std::vector<u64> offsets;
+	std::vector<u64> checksums;
+	utils::serial blobs;
+
+	for (const auto& [hash, container] : patches)
+	{
+		const u32 index = ::size32(offsets);
+		offsets.push_back(blobs.data.size());
+		save_patch_container(blobs, container);
+		checksums.push_back(get_compiled_patch_checksum(blobs.data.data() + offsets.back(), blobs.data.size() - offsets.back()));
+
+		for (const auto& [description, info] : container.patch_info_map)
+		{
+			for (const auto& [title, serials] : info.titles)
+			{
+				for (const auto& [serial, app_versions] : serials)
+				{
+					std::vector<u32>& indices = serial_index[serial];
+
+					if (indices.empty() || indices.back() != index)
+					{
+						indices.push_back(index);
+					}
+				}
+			}
+		}
+	}
+
+	offsets.push_back(blobs.data.size());
+
+	utils::serial ar;
+	ar(c_compiled_patch_magic, c_compiled_patch_version, patch_engine_version, source_stat.mtime, source_stat.size, usz{serial_index.size()});
+
+	for (const auto& [serial, indices] : serial_index)
+	{
+		ar(serial, indices);
+	}
+
+	ar(offsets, checksums);
+
+	const compiled_patch_prefix prefix{ar.data.size(), blobs.data.size(), get_compiled_patch_checksum(ar.data.data(), ar.data.size())};
+
+	if (!fs::create_path(fs::get_parent_dir(cache_path)))
+	{
+		patch_log.error("Failed to create compiled patch directory for %s (%s)", cache_path, fs::g_tls_error);
+		return false;
+	}
+
+	fs::pending_file file(cache_path);
+
+	if (!file.file || file.file.write(&prefix, sizeof(prefix)) != sizeof(prefix) || file.file.write(ar.data.data(), ar.data.size()) != ar.data.size()
+		|| file.file.write(blobs.data.data(), blobs.data.size()) != blobs.data.size() || !file.commit())
+	{
+		patch_log.error("Failed to save compiled patch file %s (%s)", cache_path, fs::g_tls_error);
+		return false;
+	}
+
+	return true;
+}
+
+static bool load_compiled_patches(const std::string& cache_path, const fs::stat_t& source_stat, std::string_view serial, std::vector<patch_engine::patch_container>& containers)
+{
+	fs::file file(cache_path);
+	compiled_patch_prefix prefix{};
+
+	if (!file || !file.read(prefix))
+	{
+		return false;
+	}
+
+	// Also rejects files of older versions, which had a different prefix
+	if (prefix.header_size > file.size() || prefix.blobs_size > file.size() || sizeof(prefix) + prefix.header_size + prefix.blobs_size != file.size())
+	{
+		patch_log.notice("Compiled patch file %s has an unexpected size", cache_path);
+		return false;
+	}
+
+	std::vector<u8> header(prefix.header_size);
+
+	if (file.read(header.data(), header.size()) != header.size() || get_compiled_patch_checksum(header.data(), header.size()) != prefix.header_checksum)
+	{
+		patch_log.error("Compiled patch file %s is corrupted", cache_path);
+		return false;
+	}
+
+	utils::serial ar;
+	ar.set_reading_state(std::move(header));
+
+	std::string magic;
+	u32 version = 0;
+
+	// The header checksum matched, reading it can't run past its end
+	ar(magic, version);
+
+	if (magic != c_compiled_patch_magic || version != c_compiled_patch_version)
+	{
+		return false;
+	}
+
+	std::string engine_version;
+	s64 source_mtime = 0;
+	u64 source_size = 0;
+	usz serial_count = 0;
+
+	ar(engine_version, source_mtime, source_size, serial_count);
+
+	if (engine_version != patch_engine_version || source_mtime != source_stat.mtime || source_size != source_stat.size)
+	{
+		patch_log.notice("Compiled patch file %s is outdated", cache_path);
+		return false;
+	}
+
+	std::vector<u32> indices;
+
+	for (usz i = 0; i < serial_count; i++)
+	{
+		std::string key;
+		std::vector<u32> key_indices;
+		ar(key, key_indices);
+
+		if (key == serial || key == patch_key::all)
+		{
+			indices.insert(indices.end(), key_indices.begin(), key_indices.end());
+		}
+	}
+
+	std::vector<u64> offsets;
+	std::vector<u64> checksums;
+	ar(offsets, checksums);
+
+	std::sort(indices.begin(), indices.end());
+	indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+	const u64 blobs_offset = sizeof(prefix) + prefix.header_size;
+	const usz old_size = containers.size();
+
+	for (u32 index : indices)
+	{
+		if (index + 1 >= offsets.size() || index >= checksums.size() || offsets[index] > offsets[index + 1] || offsets[index + 1] > prefix.blobs_size)
+		{
+			patch_log.error("Compiled patch file %s is corrupted", cache_path);
+			containers.resize(old_size);
+			return false;
+		}
+
+		std::vector<u8> blob(offsets[index + 1] - offsets[index]);
+
+		if (file.read_at(blobs_offset + offsets[index], blob.data(), blob.size()) != blob.size() || get_compiled_patch_checksum(blob.data(), blob.size()) != checksums[index])
+		{
+			patch_log.error("Compiled patch file %s is corrupted", cache_path);
+			containers.resize(old_size);
+			return false;
+		}
+
+		utils::serial blob_ar;
+		blob_ar.set_reading_state(std::move(blob));
+		load_patch_container(blob_ar, containers.emplace_back());
+	}
+
+	patch_log.notice("Loaded %u of %u patch entries from compiled patch file %s", indices.size(), offsets.size() - 1, cache_path);
+	return true;
+}
+
+// Copy the enabled state and configurable values of the patch config
+static void apply_patch_config(patch_engine::patch_info& info, const patch_engine::patch_map& patch_config)
+{
+	const auto config_container = patch_config.find(info.hash);
+
+	if (config_container == patch_config.cend())
+	{
+		return;
+	}
+
+	const auto config_info = config_container->second.patch_info_map.find(info.description);
+
+	if (config_info == config_container->second.patch_info_map.cend())
+	{
+		return;
+	}
+
+	for (auto& [title, serials] : info.titles)
+	{
+		const auto config_serials = config_info->second.titles.find(title);
+
+		if (config_serials == config_info->second.titles.cend())
+		{
+			continue;
+		}
+
+		for (auto& [serial, app_versions] : serials)
+		{
+			const auto config_app_versions = config_serials->second.find(serial);
+
+			if (config_app_versions == config_serials->second.cend())
+			{
+				continue;
+			}
+
+			for (auto& [app_version, config_values] : app_versions)
+			{
+				if (const auto found = config_app_versions->second.find(app_version); found != config_app_versions->second.cend())
+				{
+					config_values = found->second;
+				}
+			}
+		}
+	}
+}
+
+std::string patch_engine::get_compiled_patch_path(const std::string& path)
+{
+	return fs::get_cache_dir() + "patches/" + path.substr(path.find_last_of("/\\") + 1) + ".bin";
+}
+
+bool patch_engine::load_compiled(patch_map& patches, const std::string& path, const std::string& cache_path, std::string_view serial, const patch_map& patch_config)
+{
+	fs::stat_t source_stat{};
+
+	if (!fs::get_stat(path, source_stat) || source_stat.is_directory)
+	{
+		// Do nothing
+		return true;
+	}
+
+	std::vector<patch_container> containers;
+	bool is_valid = true;
+
+	if (!load_compiled_patches(cache_path, source_stat, serial, containers))
+	{
+		patch_map compiled;
+		is_valid = load(compiled, path, "", true);
+
+		// Files with errors are not cached so the errors are reported on every boot until fixed
+		if (is_valid && save_compiled_patches(cache_path, source_stat, compiled))
+		{
+			patch_log.notice("Compiled patch file %s (%u entries)", path, compiled.size());
+		}
+
+		for (auto& [hash, container] : compiled)
+		{
+			containers.push_back(std::move(container));
+		}
+	}
+
+	for (patch_container& container : containers)
+	{
+		for (auto& [description, info] : container.patch_info_map)
+		{
+			const bool is_relevant = std::any_of(info.titles.cbegin(), info.titles.cend(), [&](const auto& title)
+			{
+				return title.second.contains(patch_key::all) || std::any_of(title.second.cbegin(), title.second.cend(), [&](const auto& s) { return s.first == serial; });
+			});
+
+			if (!is_relevant)
+			{
+				continue;
+			}
+
+			info.source_path = path;
+			apply_patch_config(info, patch_config);
+
+			patch_container& dst = patches[container.hash];
+			dst.hash = container.hash;
+			dst.version = container.version;
+
+			// Skip this patch if a higher patch version already exists
+			if (const auto existing = dst.patch_info_map.find(description); existing != dst.patch_info_map.cend())
+			{
+				bool ok;
+				const bool version_is_bigger = utils::compare_versions(info.patch_version, existing->second.patch_version, ok) > 0;
+
+				if (!ok || !version_is_bigger)
+				{
+					patch_log.warning("A higher or equal patch version already exists ('%s' vs '%s') for %s: %s (in file %s)", info.patch_version, existing->second.patch_version, container.hash, description, path);
+					continue;
+				}
+
+				patch_log.warning("A lower patch version was found ('%s' vs '%s') for %s: %s (in file %s)", existing->second.patch_version, info.patch_version, container.hash, description, existing->second.source_path);
+			}
+
+			dst.patch_info_map[description] = std::move(info);
+		}
+	}
+
+	return is_valid;
+}
+
 void patch_engine::append_global_patches()
 {
+	const patch_map patch_config = load_config();
+	const std::string& serial = Emu.GetTitleID();
+
 	// Regular patch.yml
-	load(m_map, get_patches_path() + "patch.yml");
+	const std::string patch_path = get_patches_path() + "patch.yml";
+	load_compiled(m_map, patch_path, get_compiled_patch_path(patch_path), serial, patch_config);
 
 	// Imported patch.yml
-	load(m_map, get_imported_patch_path());
+	const std::string imported_path = get_imported_patch_path();
+	load_compiled(m_map, imported_path, get_compiled_patch_path(imported_path), serial, patch_config);
 }
 
 void patch_engine::append_title_patches(std::string_view title_id)
@@ -903,7 +1339,8 @@ void patch_engine::append_title_patches(std::string_view title_id)
 	}
 
 	// Regular patch.yml
-	load(m_map, fmt::format("%s%s_patch.yml", get_patches_path(), title_id));
+	const std::string path = fmt::format("%s%s_patch.yml", get_patches_path(), title_id);
+	load_compiled(m_map, path, get_compiled_patch_path(path), title_id, load_config());
 }
 
 void unmap_vm_area(std::shared_ptr<vm::block_t>& ptr)
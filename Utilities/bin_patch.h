@@ -181,6 +181,12 @@ public:
 	// Load from file and append to specified patches map
 	static bool load(patch_map& patches, const std::string& path, std::string content = "", bool importing = false, std::stringstream* log_messages = nullptr);
 
+	// Returns the filepath of the compiled cache of a patch file
+	static std::string get_compiled_patch_path(const std::string& path);
+
+	// Load the patches relevant to a serial from the compiled cache of a patch file (rebuilt from the file if it changed) and append to specified patches map
+	static bool load_compiled(patch_map& patches, const std::string& path, const std::string& cache_path, std::string_view serial, const patch_map& patch_config);
+
 	// Read and add a patch node to the patch info
 	static bool read_patch_node(patch_info& info, YAML::Node node, const YAML::Node& root, std::string_view path, std::stringstream* log_messages = nullptr);
 
@@ -772,6 +772,11 @@ int aes_crypt_cbc( aes_context *ctx,
 
     if( mode == AES_DECRYPT )
     {
+#if defined(__SSE2__) || defined(_M_X64)
+        if( aesni_supports( POLARSSL_AESNI_AES ) )
+            return( aesni_crypt_cbc_dec( ctx, length, iv, input, output ) );
+#endif
+
         while( length > 0 )
         {
             memcpy( temp, input, 16 );
@@ -866,6 +871,26 @@ int aes_crypt_ctr( aes_context *ctx,
     int c, i;
     size_t n = *nc_off;
 
+#if defined(__SSE2__) || defined(_M_X64)
+    if( aesni_supports( POLARSSL_AESNI_AES ) )
+    {
+        /* Use up the current stream block, then process whole blocks in bulk */
+        for( ; n != 0 && length > 0; length-- )
+        {
+            *output++ = static_cast<unsigned char>( *input++ ^ stream_block[n] );
+            n = (n + 1) & 0x0F;
+        }
+
+        if( length >= 16 )
+        {
+            aesni_crypt_ctr( ctx, length / 16, nonce_counter, input, output );
+            input  += length & ~static_cast<size_t>( 15 );
+            output += length & ~static_cast<size_t>( 15 );
+            length &= 15;
+        }
+    }
+#endif
+
     while( length-- )
     {
         if( n == 0 ) {
@@ -37,6 +37,13 @@
 #include <intrin.h>
 #endif
 
+#if defined(_MSC_VER)
+#define AESNI_FUNC
+#else
+#include <immintrin.h>
+#define AESNI_FUNC __attribute__((__target__("aes")))
+#endif
+
 /*
  * AES-NI support detection routine
  */
@@ -131,6 +138,161 @@ int aesni_crypt_ecb( aes_context *ctx,
     return( 0 );
 }
 
+/*
+ * Apply one round to the eight blocks in flight
+ */
+#define AESNI_ROUND8( op, k )                                               \
+{                                                                           \
+    b0 = op( b0, k ); b1 = op( b1, k ); b2 = op( b2, k ); b3 = op( b3, k ); \
+    b4 = op( b4, k ); b5 = op( b5, k ); b6 = op( b6, k ); b7 = op( b7, k ); \
+}
+
+/*
+ * AES-NI AES-CBC buffer decryption
+ */
+AESNI_FUNC int aesni_crypt_cbc_dec( aes_context *ctx,
+                                    size_t length,
+                                    unsigned char iv[16],
+                                    const unsigned char *input,
+                                    unsigned char *output )
+{
+    const __m128i *xrk = reinterpret_cast<const __m128i*>( ctx->rk );
+    const int nr = ctx->nr;
+    __m128i rk[15];
+    __m128i prev;
+    int i;
+
+    for( i = 0; i <= nr; i++ )
+        rk[i] = _mm_loadu_si128( xrk + i );
+
+    prev = _mm_loadu_si128( reinterpret_cast<const __m128i*>( iv ) );
+
+    for( ; length >= 128; length -= 128, input += 128, output += 128 )
+    {
+        const __m128i *in = reinterpret_cast<const __m128i*>( input );
+        __m128i *out = reinterpret_cast<__m128i*>( output );
+
+        // All ciphertext blocks are loaded before anything is stored, so input may alias output
+        const __m128i c0 = _mm_loadu_si128( in + 0 ), c1 = _mm_loadu_si128( in + 1 );
+        const __m128i c2 = _mm_loadu_si128( in + 2 ), c3 = _mm_loadu_si128( in + 3 );
+        const __m128i c4 = _mm_loadu_si128( in + 4 ), c5 = _mm_loadu_si128( in + 5 );
+        const __m128i c6 = _mm_loadu_si128( in + 6 ), c7 = _mm_loadu_si128( in + 7 );
+
+        __m128i b0 = c0, b1 = c1, b2 = c2, b3 = c3, b4 = c4, b5 = c5, b6 = c6, b7 = c7;
+
+        AESNI_ROUND8( _mm_xor_si128, rk[0] );
+
+        for( i = 1; i < nr; i++ )
+            AESNI_ROUND8( _mm_aesdec_si128, rk[i] );
+
+        AESNI_ROUND8( _mm_aesdeclast_si128, rk[nr] );
+
+        _mm_storeu_si128( out + 0, _mm_xor_si128( b0, prev ) );
+        _mm_storeu_si128( out + 1, _mm_xor_si128( b1, c0 ) );
+        _mm_storeu_si128( out + 2, _mm_xor_si128( b2, c1 ) );
+        _mm_storeu_si128( out + 3, _mm_xor_si128( b3, c2 ) );
+        _mm_storeu_si128( out + 4, _mm_xor_si128( b4, c3 ) );
+        _mm_storeu_si128( out + 5, _mm_xor_si128( b5, c4 ) );
+        _mm_storeu_si128( out + 6, _mm_xor_si128( b6, c5 ) );
+        _mm_storeu_si128( out + 7, _mm_xor_si128( b7, c6 ) );
+        prev = c7;
+    }
+
+    for( ; length >= 16; length -= 16, input += 16, output += 16 )
+    {
+        const __m128i c = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input ) );
+        __m128i b = _mm_xor_si128( c, rk[0] );
+
+        for( i = 1; i < nr; i++ )
+            b = _mm_aesdec_si128( b, rk[i] );
+
+        b = _mm_aesdeclast_si128( b, rk[nr] );
+
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( output ), _mm_xor_si128( b, prev ) );
+        prev = c;
+    }
+
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( iv ), prev );
+
+    return( 0 );
+}
+
+/*
+ * Return the current counter block and increment the 128-bit big endian counter
+ */
+static inline __m128i aesni_ctr_next( unsigned char nonce_counter[16] )
+{
+    const __m128i block = _mm_loadu_si128( reinterpret_cast<const __m128i*>( nonce_counter ) );
+
+    for( int i = 16; i > 0; i-- )
+        if( ++nonce_counter[i - 1] != 0 )
+            break;
+
+    return( block );
+}
+
+/*
+ * AES-NI AES-CTR en(de)cryption of whole blocks
+ */
+AESNI_FUNC int aesni_crypt_ctr( aes_context *ctx,
+                                size_t blocks,
+                                unsigned char nonce_counter[16],
+                                const unsigned char *input,
+                                unsigned char *output )
+{
+    const __m128i *xrk = reinterpret_cast<const __m128i*>( ctx->rk );
+    const int nr = ctx->nr;
+    __m128i rk[15];
+    int i;
+
+    for( i = 0; i <= nr; i++ )
+        rk[i] = _mm_loadu_si128( xrk + i );
+
+    for( ; blocks >= 8; blocks -= 8, input += 128, output += 128 )
+    {
+        const __m128i *in = reinterpret_cast<const __m128i*>( input );
+        __m128i *out = reinterpret_cast<__m128i*>( output );
+
+        __m128i b0 = aesni_ctr_next( nonce_counter ), b1 = aesni_ctr_next( nonce_counter );
+        __m128i b2 = aesni_ctr_next( nonce_counter ), b3 = aesni_ctr_next( nonce_counter );
+        __m128i b4 = aesni_ctr_next( nonce_counter ), b5 = aesni_ctr_next( nonce_counter );
+        __m128i b6 = aesni_ctr_next( nonce_counter ), b7 = aesni_ctr_next( nonce_counter );
+
+        AESNI_ROUND8( _mm_xor_si128, rk[0] );
+
+        for( i = 1; i < nr; i++ )
+            AESNI_ROUND8( _mm_aesenc_si128, rk[i] );
+
+        AESNI_ROUND8( _mm_aesenclast_si128, rk[nr] );
+
+        _mm_storeu_si128( out + 0, _mm_xor_si128( b0, _mm_loadu_si128( in + 0 ) ) );
+        _mm_storeu_si128( out + 1, _mm_xor_si128( b1, _mm_loadu_si128( in + 1 ) ) );
+        _mm_storeu_si128( out + 2, _mm_xor_si128( b2, _mm_loadu_si128( in + 2 ) ) );
+        _mm_storeu_si128( out + 3, _mm_xor_si128( b3, _mm_loadu_si128( in + 3 ) ) );
+        _mm_storeu_si128( out + 4, _mm_xor_si128( b4, _mm_loadu_si128( in + 4 ) ) );
+        _mm_storeu_si128( out + 5, _mm_xor_si128( b5, _mm_loadu_si128( in + 5 ) ) );
+        _mm_storeu_si128( out + 6, _mm_xor_si128( b6, _mm_loadu_si128( in + 6 ) ) );
+        _mm_storeu_si128( out + 7, _mm_xor_si128( b7, _mm_loadu_si128( in + 7 ) ) );
+    }
+
+    for( ; blocks; blocks--, input += 16, output += 16 )
+    {
+        __m128i b = _mm_xor_si128( aesni_ctr_next( nonce_counter ), rk[0] );
+
+        for( i = 1; i < nr; i++ )
+            b = _mm_aesenc_si128( b, rk[i] );
+
+        b = _mm_aesenclast_si128( b, rk[nr] );
+
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( output ),
+                          _mm_xor_si128( b, _mm_loadu_si128( reinterpret_cast<const __m128i*>( input ) ) ) );
+    }
+
+    return( 0 );
+}
+
+#undef AESNI_ROUND8
+
 #if defined(POLARSSL_HAVE_MSVC_X64_INTRINSICS)
 static inline void clmul256( __m128i a, __m128i b, __m128i* r0, __m128i* r1 )
 {
@@ -61,6 +61,43 @@ int aesni_crypt_ecb( aes_context *ctx,
                      const unsigned char input[16],
                      unsigned char output[16] );
 
+/**
+ * \brief          AES-NI AES-CBC buffer decryption
+ *                 Eight blocks are decrypted at a time, as CBC decryption
+ *                 does not depend on the previous output
+ *
+ * \param ctx      AES context (decryption key schedule)
+ * \param length   length of the input data, multiple of 16
+ * \param iv       initialization vector (updated after use)
+ * \param input    buffer holding the input data
+ * \param output   buffer holding the output data (may be input)
+ *
+ * \return         0 on success (cannot fail)
+ */
+int aesni_crypt_cbc_dec( aes_context *ctx,
+                         size_t length,
+                         unsigned char iv[16],
+                         const unsigned char *input,
+                         unsigned char *output );
+
+/**
+ * \brief          AES-NI AES-CTR en(de)cryption of whole blocks
+ *                 Eight counter blocks are encrypted at a time
+ *
+ * \param ctx      AES context (encryption key schedule)
+ * \param blocks   number of 16-byte blocks
+ * \param nonce_counter The 128-bit big endian nonce and counter (updated after use)
+ * \param input    buffer holding the input data
+ * \param output   buffer holding the output data (may be input)
+ *
+ * \return         0 on success (cannot fail)
+ */
+int aesni_crypt_ctr( aes_context *ctx,
+                     size_t blocks,
+                     unsigned char nonce_counter[16],
+                     const unsigned char *input,
+                     unsigned char *output );
+
 /**
  * \brief          GCM multiplication: c = a * b in GF(2^128)
  *
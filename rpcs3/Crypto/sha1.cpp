@@ -30,6 +30,20 @@
 
 #include "sha1.h"
 #include "utils.h"
+#include "util/sysinfo.hpp"
+
+#if defined(ARCH_X64)
+#include <immintrin.h>
+#elif defined(ARCH_ARM64) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#include <arm_neon.h>
+#define SHA1_ARMV8
+#endif
+
+#if defined(_MSC_VER) || !defined(ARCH_X64)
+#define SHA1_NI_FUNC
+#else
+#define SHA1_NI_FUNC __attribute__((__target__("sha,sse4.1")))
+#endif
 
 /*
  * 32-bit integer manipulation macros (big endian)
@@ -225,6 +239,132 @@ void sha1_process( sha1_context *ctx, const unsigned char data[64] )
     ctx->state[4] += E;
 }
 
+#if defined(ARCH_X64)
+/*
+ * SHA-1 block function using the SHA extensions (SHA-NI).
+ * Every group of four rounds consumes one vector of the message schedule,
+ * the vector of group g + 4 is computed from groups g to g + 3.
+ */
+#define SHA1_NI_ROUNDS4( g, f )                                             \
+{                                                                           \
+    e = ( g ) ? _mm_sha1nexte_epu32( abcd_prev, m[( g ) % 4] )              \
+              : _mm_add_epi32( e0, m[0] );                                  \
+    abcd_prev = abcd;                                                       \
+    abcd = _mm_sha1rnds4_epu32( abcd, e, f );                               \
+    if( ( g ) < 16 )                                                        \
+        m[( g ) % 4] = _mm_sha1msg2_epu32( _mm_xor_si128(                   \
+            _mm_sha1msg1_epu32( m[( g ) % 4], m[( ( g ) + 1 ) % 4] ),       \
+            m[( ( g ) + 2 ) % 4] ), m[( ( g ) + 3 ) % 4] );                 \
+}
+
+static SHA1_NI_FUNC void sha1_process_shani( uint32_t state[5], const unsigned char *data, size_t blocks )
+{
+    const __m128i mask = _mm_set_epi64x( 0x0001020304050607ll, 0x08090a0b0c0d0e0fll );
+
+    __m128i abcd = _mm_shuffle_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( state ) ), 0x1b );
+    __m128i e0 = _mm_set_epi32( static_cast<int>( state[4] ), 0, 0, 0 );
+
+    for( ; blocks; blocks--, data += 64 )
+    {
+        const __m128i abcd_save = abcd;
+        const __m128i e0_save = e0;
+
+        __m128i m[4], e, abcd_prev = abcd;
+
+        for( int i = 0; i < 4; i++ )
+            m[i] = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( data + i * 16 ) ), mask );
+
+        SHA1_NI_ROUNDS4(  0, 0 ); SHA1_NI_ROUNDS4(  1, 0 ); SHA1_NI_ROUNDS4(  2, 0 ); SHA1_NI_ROUNDS4(  3, 0 ); SHA1_NI_ROUNDS4(  4, 0 );
+        SHA1_NI_ROUNDS4(  5, 1 ); SHA1_NI_ROUNDS4(  6, 1 ); SHA1_NI_ROUNDS4(  7, 1 ); SHA1_NI_ROUNDS4(  8, 1 ); SHA1_NI_ROUNDS4(  9, 1 );
+        SHA1_NI_ROUNDS4( 10, 2 ); SHA1_NI_ROUNDS4( 11, 2 ); SHA1_NI_ROUNDS4( 12, 2 ); SHA1_NI_ROUNDS4( 13, 2 ); SHA1_NI_ROUNDS4( 14, 2 );
+        SHA1_NI_ROUNDS4( 15, 3 ); SHA1_NI_ROUNDS4( 16, 3 ); SHA1_NI_ROUNDS4( 17, 3 ); SHA1_NI_ROUNDS4( 18, 3 ); SHA1_NI_ROUNDS4( 19, 3 );
+
+        // A before the last four rounds, rotated, is E after them
+        e0 = _mm_sha1nexte_epu32( abcd_prev, e0_save );
+        abcd = _mm_add_epi32( abcd, abcd_save );
+    }
+
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( state ), _mm_shuffle_epi32( abcd, 0x1b ) );
+    state[4] = static_cast<uint32_t>( _mm_extract_epi32( e0, 3 ) );
+}
+
+#undef SHA1_NI_ROUNDS4
+#endif /* ARCH_X64 */
+
+#if defined(SHA1_ARMV8)
+/*
+ * SHA-1 block function using the ARMv8 cryptographic extension
+ */
+#define SHA1_ARMV8_ROUNDS4( g, op, k )                                      \
+{                                                                           \
+    const uint32x4_t wk = vaddq_u32( m[( g ) % 4], vdupq_n_u32( k ) );      \
+    const uint32_t e_next = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );        \
+    abcd = op( abcd, e, wk );                                               \
+    e = e_next;                                                             \
+    if( ( g ) < 16 )                                                        \
+        m[( g ) % 4] = vsha1su1q_u32( vsha1su0q_u32( m[( g ) % 4],          \
+            m[( ( g ) + 1 ) % 4], m[( ( g ) + 2 ) % 4] ), m[( ( g ) + 3 ) % 4] ); \
+}
+
+static void sha1_process_armv8( uint32_t state[5], const unsigned char *data, size_t blocks )
+{
+    uint32x4_t abcd = vld1q_u32( state );
+    uint32_t e = state[4];
+
+    for( ; blocks; blocks--, data += 64 )
+    {
+        const uint32x4_t abcd_save = abcd;
+        const uint32_t e_save = e;
+
+        uint32x4_t m[4];
+
+        for( int i = 0; i < 4; i++ )
+            m[i] = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data + i * 16 ) ) );
+
+        SHA1_ARMV8_ROUNDS4(  0, vsha1cq_u32, 0x5A827999 ); SHA1_ARMV8_ROUNDS4(  1, vsha1cq_u32, 0x5A827999 );
+        SHA1_ARMV8_ROUNDS4(  2, vsha1cq_u32, 0x5A827999 ); SHA1_ARMV8_ROUNDS4(  3, vsha1cq_u32, 0x5A827999 );
+        SHA1_ARMV8_ROUNDS4(  4, vsha1cq_u32, 0x5A827999 ); SHA1_ARMV8_ROUNDS4(  5, vsha1pq_u32, 0x6ED9EBA1 );
+        SHA1_ARMV8_ROUNDS4(  6, vsha1pq_u32, 0x6ED9EBA1 ); SHA1_ARMV8_ROUNDS4(  7, vsha1pq_u32, 0x6ED9EBA1 );
+        SHA1_ARMV8_ROUNDS4(  8, vsha1pq_u32, 0x6ED9EBA1 ); SHA1_ARMV8_ROUNDS4(  9, vsha1pq_u32, 0x6ED9EBA1 );
+        SHA1_ARMV8_ROUNDS4( 10, vsha1mq_u32, 0x8F1BBCDC ); SHA1_ARMV8_ROUNDS4( 11, vsha1mq_u32, 0x8F1BBCDC );
+        SHA1_ARMV8_ROUNDS4( 12, vsha1mq_u32, 0x8F1BBCDC ); SHA1_ARMV8_ROUNDS4( 13, vsha1mq_u32, 0x8F1BBCDC );
+        SHA1_ARMV8_ROUNDS4( 14, vsha1mq_u32, 0x8F1BBCDC ); SHA1_ARMV8_ROUNDS4( 15, vsha1pq_u32, 0xCA62C1D6 );
+        SHA1_ARMV8_ROUNDS4( 16, vsha1pq_u32, 0xCA62C1D6 ); SHA1_ARMV8_ROUNDS4( 17, vsha1pq_u32, 0xCA62C1D6 );
+        SHA1_ARMV8_ROUNDS4( 18, vsha1pq_u32, 0xCA62C1D6 ); SHA1_ARMV8_ROUNDS4( 19, vsha1pq_u32, 0xCA62C1D6 );
+
+        abcd = vaddq_u32( abcd, abcd_save );
+        e += e_save;
+    }
+
+    vst1q_u32( state, abcd );
+    state[4] = e;
+}
+
+#undef SHA1_ARMV8_ROUNDS4
+#endif /* SHA1_ARMV8 */
+
+/*
+ * SHA-1 process consecutive blocks, using the SHA instructions of the host when available
+ */
+static void sha1_process_blocks( sha1_context *ctx, const unsigned char *data, size_t blocks )
+{
+#if defined(ARCH_X64)
+    static const bool s_use_shani = utils::has_sha();
+
+    if( s_use_shani )
+    {
+        sha1_process_shani( ctx->state, data, blocks );
+        return;
+    }
+#elif defined(SHA1_ARMV8)
+    sha1_process_armv8( ctx->state, data, blocks );
+    return;
+#endif
+
+    for( ; blocks; blocks--, data += 64 )
+        sha1_process( ctx, data );
+}
+
 /*
  * SHA-1 process buffer
  */
@@ -249,17 +389,17 @@ void sha1_update( sha1_context *ctx, const unsigned char *input, size_t ilen )
     if( left && ilen >= fill )
     {
         memcpy( ctx->buffer + left, input, fill );
-        sha1_process( ctx, ctx->buffer );
+        sha1_process_blocks( ctx, ctx->buffer, 1 );
         input += fill;
         ilen  -= fill;
         left = 0;
     }
 
-    while( ilen >= 64 )
+    if( ilen >= 64 )
     {
-        sha1_process( ctx, input );
-        input += 64;
-        ilen  -= 64;
+        sha1_process_blocks( ctx, input, ilen / 64 );
+        input += ilen & ~static_cast<size_t>( 63 );
+        ilen  &= 63;
     }
 
     if( ilen > 0 )
@@ -1307,13 +1307,14 @@ package_install_result package_reader::extract_data(std::deque<package_reader>&
 		{
 			const usz thread_count = std::min<usz>(utils::get_thread_count(), reader.m_install_entries.size());
 
-			named_thread_group workers("PKG Installer "sv, std::max<u32>(::narrow<u32>(thread_count), 1) - 1, [&]()
+			// The calling thread participates as well
+			const auto job = task_pool::submit("PKG Installer", std::max<u32>(::narrow<u32>(thread_count), 1) - 1, task_priority::low, [&](task_job&, u32)
 			{
 				reader.extract_worker();
 			});
 
 			reader.extract_worker();
-			workers.join();
+			job->join();
 		}
 
 		num_failures += reader.m_num_failures;
@@ -1442,19 +1443,13 @@ usz package_reader::decrypt(u64 offset, u64 size, const uchar* key, void* local_
 		// Set encryption key for stream cipher
 		aes_setkey_enc(&ctx, key, 128);
 
-		// Initialize stream cipher for start position
+		// Initialize stream cipher for start position (big-endian counter, incremented for every block)
 		be_t<u128> input = m_header.klicensee.value() + offset / 16;
 
-		// Increment stream position for every block
-		for (u64 i = 0; i < blocks; i++, input++)
-		{
-			u128 key;
-
-			aes_crypt_ecb(&ctx, AES_ENCRYPT, reinterpret_cast<const u8*>(&input), reinterpret_cast<u8*>(&key));
+		u8 stream_block[16]{};
+		usz stream_offset = 0;
 
-			const u128 v = read_from_ptr<u128>(out_data, i * 16);
-			write_to_ptr<u128>(out_data, i * 16, v ^ key);
-		}
+		aes_crypt_ctr(&ctx, blocks * 16, &stream_offset, reinterpret_cast<u8*>(&input), stream_block, out_data, out_data);
 	}
 	else
 	{
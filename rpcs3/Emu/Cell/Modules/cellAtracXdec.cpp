@@ -124,16 +124,21 @@ void AtracXdecDecoder::alloc_avcodec()
 	ctx->thread_type = FF_THREAD_SLICE; // Silences a warning by FFmpeg about requesting frame threading with a custom get_buffer2(). Default is FF_THREAD_FRAME & FF_THREAD_SLICE
 	ctx->get_buffer2 = [](AVCodecContext* s, AVFrame* frame, int /*flags*/) -> int
 	{
+		const auto decoder = static_cast<AtracXdecDecoder*>(s->opaque);
+
 		for (s32 i = 0; i < frame->ch_layout.nb_channels; i++)
 		{
-			frame->data[i] = static_cast<AtracXdecDecoder*>(s->opaque)->work_mem.get_ptr() + ATXDEC_MAX_FRAME_LENGTH + ATXDEC_SAMPLES_PER_FRAME * sizeof(f32) * i;
+			frame->data[i] = decoder->work_mem.get_ptr() + ATXDEC_MAX_FRAME_LENGTH + ATXDEC_SAMPLES_PER_FRAME * sizeof(f32) * i;
 			frame->linesize[i] = ATXDEC_SAMPLES_PER_FRAME * sizeof(f32);
 		}
 
-		frame->buf[0] = av_buffer_create(frame->data[0], ATXDEC_SAMPLES_PER_FRAME * sizeof(f32) * frame->ch_layout.nb_channels, [](void*, uint8_t*){}, nullptr, 0);
-		return 0;
+		// The buffer is reused for every frame, only the reference is allocated
+		frame->buf[0] = av_buffer_ref(decoder->frame_buf);
+		return frame->buf[0] ? 0 : AVERROR(ENOMEM);
 	};
 
+	frame_buf = nullptr;
+
 	packet = av_packet_alloc();
 	if (!packet)
 	{
@@ -151,6 +156,7 @@ void AtracXdecDecoder::free_avcodec()
 {
 	av_packet_free(&packet);
 	av_frame_free(&frame);
+	av_buffer_unref(&frame_buf);
 	avcodec_free_context(&ctx);
 }
 
@@ -170,9 +176,19 @@ void AtracXdecDecoder::init_avcodec()
 		fmt::throw_exception("avcodec_open2() failed (err=0x%x='%s')", err, utils::av_error_to_string(err));
 	}
 
+	// Reference counted, so that FFmpeg doesn't copy every packet (previous buffers are released on reconfiguration)
+	av_buffer_unref(&packet->buf);
 	packet->data = work_mem.get_ptr();
 	packet->size = nbytes;
 	packet->buf = av_buffer_create(work_mem.get_ptr(), nbytes, [](void*, uint8_t*){}, nullptr, 0);
+
+	av_buffer_unref(&frame_buf);
+	frame_buf = av_buffer_create(work_mem.get_ptr() + ATXDEC_MAX_FRAME_LENGTH, ATXDEC_SAMPLES_PER_FRAME * sizeof(f32) * nch_in, [](void*, uint8_t*){}, nullptr, 0);
+
+	if (!packet->buf || !frame_buf)
+	{
+		fmt::throw_exception("av_buffer_create() failed");
+	}
 }
 
 error_code AtracXdecDecoder::set_config_info(u32 sampling_freq, u32 ch_config_idx, u32 nbytes)
@@ -260,6 +276,70 @@ error_code AtracXdecDecoder::parse_ats_header(vm::cptr<u8> au_start_addr)
 	return set_config_info(sampling_freq, ch_config_idx, nbytes); // Cannot return error here, values were already checked
 }
 
+// Floor for values in the s32 range, std::floor() is a library call per sample on x86-64 without SSE4.1
+static inline s32 atracXdecFloor(f32 value)
+{
+#if defined(__SSE4_1__) || defined(ARCH_ARM64)
+	return static_cast<s32>(std::floor(value));
+#else
+	const s32 truncated = static_cast<s32>(value);
+	return truncated - (value < static_cast<f32>(truncated));
+#endif
+}
+
+template <typename T, typename F>
+static void atracXdecInterleave(const AVFrame& frame, u32 nch_in, const u8* ch_map, u32 samples_num, be_t<T>* output, F&& convert)
+{
+	for (u32 channel_idx = 0; channel_idx < nch_in; channel_idx++)
+	{
+		const f32* samples = reinterpret_cast<const f32*>(frame.data[channel_idx]);
+		be_t<T>* out = output + ch_map[channel_idx];
+
+		for (u32 sample_idx = 0; sample_idx < samples_num; sample_idx++)
+		{
+			out[sample_idx * nch_in] = convert(samples[sample_idx]);
+		}
+	}
+}
+
+// Converts planar f32 FFmpeg output to interleaved big endian LLE output (also used by rpcs3_bench).
+// Samples are clamped with min/max instead of branching on every sample, the results are identical.
+void atracXdecConvertPcm(const AVFrame& frame, u32 bw_pcm, u32 ch_config_idx, u32 nch_in, u32 samples_num, void* output)
+{
+	const u8* const ch_map = ATXDEC_AVCODEC_CH_MAP[ch_config_idx - 1];
+
+	switch (bw_pcm)
+	{
+	case CELL_ADEC_ATRACX_WORD_SZ_FLOAT:
+		atracXdecInterleave(frame, nch_in, ch_map, samples_num, static_cast<be_t<f32>*>(output), [](f32 sample)
+		{
+			return std::min(std::max(sample, -1.f), std::bit_cast<f32>(std::bit_cast<u32>(1.f) - 1));
+		});
+		break;
+
+	case CELL_ADEC_ATRACX_WORD_SZ_16BIT:
+		atracXdecInterleave(frame, nch_in, ch_map, samples_num, static_cast<be_t<s16>*>(output), [](f32 sample)
+		{
+			return sample >= 1.f ? s16{INT16_MAX} : static_cast<s16>(atracXdecFloor(std::max(sample, -1.f) * 0x8000u));
+		});
+		break;
+
+	case CELL_ADEC_ATRACX_WORD_SZ_24BIT:
+		atracXdecInterleave(frame, nch_in, ch_map, samples_num, static_cast<be_t<s32>*>(output), [](f32 sample)
+		{
+			return sample >= 1.f ? s32{0x007fffff} : atracXdecFloor(std::max(sample, -1.f) * 0x00800000u) & 0x00ffffff;
+		});
+		break;
+
+	case CELL_ADEC_ATRACX_WORD_SZ_32BIT:
+		atracXdecInterleave(frame, nch_in, ch_map, samples_num, static_cast<be_t<s32>*>(output), [](f32 sample)
+		{
+			return sample >= 1.f ? s32{INT32_MAX} : atracXdecFloor(std::max(sample, -1.f) * 0x80000000u);
+		});
+		break;
+	}
+}
+
 void AtracXdecContext::exec(ppu_thread& ppu)
 {
 	perf_meter<"ATXDEC"_u64> perf0;
@@ -499,113 +579,7 @@ void AtracXdecContext::exec(ppu_thread& ppu)
 				}
 
 				// Convert FFmpeg output to LLE output
-				const auto output_f32 = vm::static_ptr_cast<f32>(output).get_ptr();
-				const auto output_s16 = vm::static_ptr_cast<s16>(output).get_ptr();
-				const auto output_s32 = vm::static_ptr_cast<s32>(output).get_ptr();
-				const u8* const ch_map = ATXDEC_AVCODEC_CH_MAP[decoder.ch_config_idx - 1];
-				const u32 nch_in = decoder.nch_in;
-
-				switch (decoder.bw_pcm)
-				{
-				case CELL_ADEC_ATRACX_WORD_SZ_FLOAT:
-					for (u32 channel_idx = 0; channel_idx < nch_in; channel_idx++)
-					{
-						const f32* samples = reinterpret_cast<f32*>(decoder.frame->data[channel_idx]);
-
-						for (u32 in_sample_idx = 0, out_sample_idx = ch_map[channel_idx]; in_sample_idx < decoded_samples_num; in_sample_idx++, out_sample_idx += nch_in)
-						{
-							const f32 sample = samples[in_sample_idx];
-
-							if (sample >= std::bit_cast<f32>(std::bit_cast<u32>(1.f) - 1))
-							{
-								output_f32[out_sample_idx] = std::bit_cast<be_t<f32>>("\x3f\x7f\xff\xff"_u32); // Prevents an unnecessary endian swap
-							}
-							else if (sample <= -1.f)
-							{
-								output_f32[out_sample_idx] = -1.f;
-							}
-							else
-							{
-								output_f32[out_sample_idx] = sample;
-							}
-						}
-					}
-					break;
-
-				case CELL_ADEC_ATRACX_WORD_SZ_16BIT:
-					for (u32 channel_idx = 0; channel_idx < nch_in; channel_idx++)
-					{
-						const f32* samples = reinterpret_cast<f32*>(decoder.frame->data[channel_idx]);
-
-						for (u32 in_sample_idx = 0, out_sample_idx = ch_map[channel_idx]; in_sample_idx < decoded_samples_num; in_sample_idx++, out_sample_idx += nch_in)
-						{
-							const f32 sample = samples[in_sample_idx];
-
-							if (sample >= 1.f)
-							{
-								output_s16[out_sample_idx] = INT16_MAX;
-							}
-							else if (sample <= -1.f)
-							{
-								output_s16[out_sample_idx] = INT16_MIN;
-							}
-							else
-							{
-								output_s16[out_sample_idx] = static_cast<s16>(std::floor(sample * 0x8000u));
-							}
-						}
-					}
-					break;
-
-				case CELL_ADEC_ATRACX_WORD_SZ_24BIT:
-					for (u32 channel_idx = 0; channel_idx < nch_in; channel_idx++)
-					{
-						const f32* samples = reinterpret_cast<f32*>(decoder.frame->data[channel_idx]);
-
-						for (u32 in_sample_idx = 0, out_sample_idx = ch_map[channel_idx]; in_sample_idx < decoded_samples_num; in_sample_idx++, out_sample_idx += nch_in)
-						{
-							const f32 sample = samples[in_sample_idx];
-
-							if (sample >= 1.f)
-							{
-								output_s32[out_sample_idx] = 0x007fffff;
-							}
-							else if (sample <= -1.f)
-							{
-								output_s32[out_sample_idx] = 0x00800000;
-							}
-							else
-							{
-								output_s32[out_sample_idx] = static_cast<s32>(std::floor(sample * 0x00800000u)) & 0x00ffffff;
-							}
-						}
-					}
-					break;
-
-				case CELL_ADEC_ATRACX_WORD_SZ_32BIT:
-					for (u32 channel_idx = 0; channel_idx < nch_in; channel_idx++)
-					{
-						const f32* samples = reinterpret_cast<f32*>(decoder.frame->data[channel_idx]);
-
-						for (u32 in_sample_idx = 0, out_sample_idx = ch_map[channel_idx]; in_sample_idx < decoded_samples_num; in_sample_idx++, out_sample_idx += nch_in)
-						{
-							const f32 sample = samples[in_sample_idx];
-
-							if (sample >= 1.f)
-							{
-								output_s32[out_sample_idx] = INT32_MAX;
-							}
-							else if (sample <= -1.f)
-							{
-								output_s32[out_sample_idx] = INT32_MIN;
-							}
-							else
-							{
-								output_s32[out_sample_idx] = static_cast<s32>(std::floor(sample * 0x80000000u));
-							}
-						}
-					}
-				}
+				atracXdecConvertPcm(*decoder.frame, decoder.bw_pcm, decoder.ch_config_idx, decoder.nch_in, decoded_samples_num, output.get_ptr());
 
 				first_decode = false;
 
@@ -196,8 +196,9 @@ struct AtracXdecDecoder
 	AVCodecContext* ctx;
 	AVPacket* packet;
 	AVFrame* frame;
+	AVBufferRef* frame_buf; // Wraps the PCM area of the work memory, referenced by every decoded frame
 
-	u8 spurs_stuff[84]; // 120 bytes on LLE, pointers to CellSpurs, CellSpursTaskset, etc.
+	u8 spurs_stuff[76]; // 120 bytes on LLE, pointers to CellSpurs, CellSpursTaskset, etc.
 
 	be_t<u32> spurs_task_id;  // CellSpursTaskId
 
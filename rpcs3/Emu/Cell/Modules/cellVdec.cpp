@@ -163,12 +163,154 @@ struct vdec_frame
 	bool pic_item_received = false;
 	CellVdecPicAttr attr = CELL_VDEC_PICITEM_ATTR_NORMAL;
 
+	// Picture converted by the decoder thread ahead of cellVdecGetPicture (see vdec_pic_format_key)
+	std::vector<u8> picture;
+	u64 picture_format = 0;
+
 	AVFrame* operator ->() const
 	{
 		return avf.get();
 	}
 };
 
+// Identifies the output of a picture conversion (0 = none)
+static constexpr u64 vdec_pic_format_key(u32 format_type, u8 alpha)
+{
+	return u64{1} << 32 | u64{alpha} << 8 | (format_type & 0xff);
+}
+
+// Host pixel format and plane layout of a guest picture
+struct vdec_picture_layout
+{
+	AVPixelFormat format = AV_PIX_FMT_NONE;
+	bool alpha = false;
+	int line[4]{};
+	usz offset[3]{};
+	usz size = 0;
+
+	vdec_picture_layout(u32 format_type, int w, int h)
+	{
+		switch (format_type)
+		{
+		case CELL_VDEC_PICFMT_ARGB32_ILV: format = AV_PIX_FMT_ARGB; alpha = true; break;
+		case CELL_VDEC_PICFMT_RGBA32_ILV: format = AV_PIX_FMT_RGBA; alpha = true; break;
+		case CELL_VDEC_PICFMT_UYVY422_ILV: format = AV_PIX_FMT_UYVY422; break;
+		case CELL_VDEC_PICFMT_YUV420_PLANAR: format = AV_PIX_FMT_YUV420P; break;
+		default: return;
+		}
+
+		// TODO:
+		// It's possible that we need to align the pitch to 128 here.
+		// PS HOME seems to rely on this somehow in certain cases.
+
+		if (alpha)
+		{
+			// RGBA32 or ARGB32
+			line[0] = w * 4;
+			size = usz{line[0] * 1u} * h;
+			return;
+		}
+
+		// YUV420P or UYVY422
+		if (const int ret = av_image_fill_linesizes(line, format, w); ret < 0)
+		{
+			fmt::throw_exception("vdec_picture_layout: av_image_fill_linesizes failed (format_type=%d, w=%d, ret=0x%x): %s", format_type, w, ret, utils::av_error_to_string(ret));
+		}
+
+		offset[1] = usz{w * 1u} * h;
+		offset[2] = usz{w * 1u} * h * 5 / 4;
+		size = format == AV_PIX_FMT_YUV420P ? offset[2] + usz{line[2] * 1u} * ((h + 1) / 2) : usz{line[0] * 1u} * h;
+	}
+};
+
+// Maximum amount of slices a picture conversion is split into
+static u32 vdec_get_max_slices()
+{
+	return std::min<u32>(task_pool::get_thread_limit(), 4);
+}
+
+// Smaller pictures are converted on the calling thread, dispatching the slices would cost more than it saves
+static constexpr usz s_vdec_min_sliced_pixels = 640 * 360;
+
+// Convert a decoded YUV420 frame into a guest picture. The frame is split into horizontal slices converted on the task pool.
+// 'sws' caches one context per slice and 'alpha_plane' the constant alpha rows, they must not be used by several threads at once.
+void vdec_convert_picture(std::vector<SwsContext*>& sws, std::vector<u8>& alpha_plane, const AVFrame& frame, u32 format_type, u8 alpha, u8* out, u32 max_slices)
+{
+	const int w = frame.width;
+	const int h = frame.height;
+	const vdec_picture_layout layout(format_type, w, h);
+
+	ensure(layout.format != AV_PIX_FMT_NONE);
+
+	const AVPixelFormat in_f = layout.alpha ? AV_PIX_FMT_YUVA420P : static_cast<AVPixelFormat>(frame.format);
+
+	if (usz{w * 1u} * h < s_vdec_min_sliced_pixels)
+	{
+		max_slices = 1;
+	}
+
+	// Each slice is converted as a separate image, keep them at even rows so that they start on a chroma row
+	const u32 max_rows = utils::align<u32>(utils::aligned_div<u32>(h, std::clamp<u32>(h / 64, 1, std::max<u32>(max_slices, 1))), 2);
+	const u32 slices = utils::aligned_div<u32>(h, max_rows);
+
+	if (sws.size() < slices)
+	{
+		sws.resize(slices);
+	}
+
+	// Contexts are only recreated when the picture size or format changes, do it here so a failure is reported on the calling thread
+	for (u32 index = 0; index < slices; index++)
+	{
+		const int rows = std::min<int>(max_rows, h - index * max_rows);
+
+		sws[index] = sws_getCachedContext(sws[index], w, rows, in_f, w, rows, layout.format, SWS_POINT, nullptr, nullptr, nullptr);
+
+		if (!sws[index])
+		{
+			fmt::throw_exception("vdec_convert_picture: sws_getCachedContext failed (w=%d, h=%d, in_f=%d, out_f=%d)", w, rows, +in_f, +layout.format);
+		}
+	}
+
+	// The alpha plane is constant, all slices can share the same rows
+	if (layout.alpha && (alpha_plane.size() < usz{w * 1u} * max_rows || alpha_plane[0] != alpha))
+	{
+		alpha_plane.assign(std::max<usz>(alpha_plane.size(), usz{w * 1u} * max_rows), alpha);
+	}
+
+	const auto convert_slice = [&](u32 index)
+	{
+		const int y = index * max_rows;
+		const int rows = std::min<int>(max_rows, h - y);
+
+		const u8* in_data[4] = { frame.data[0] + y * frame.linesize[0], frame.data[1] + y / 2 * frame.linesize[1], frame.data[2] + y / 2 * frame.linesize[2], alpha_plane.data() };
+		const int in_line[4] = { frame.linesize[0], frame.linesize[1], frame.linesize[2], w * 1 };
+		u8* out_data[4] = { out + usz{layout.line[0] * 1u} * y };
+
+		if (!layout.alpha)
+		{
+			out_data[1] = out + layout.offset[1] + usz{layout.line[1] * 1u} * (y / 2);
+			out_data[2] = out + layout.offset[2] + usz{layout.line[2] * 1u} * (y / 2);
+		}
+
+		sws_scale(sws[index], in_data, in_line, 0, rows, out_data, layout.line);
+	};
+
+	if (slices == 1)
+	{
+		convert_slice(0);
+		return;
+	}
+
+	const auto job = task_pool::submit("VDEC Picture Conversion", slices, task_priority::high, [&](task_job&, u32 slot)
+	{
+		convert_slice(slot);
+	});
+
+	// Don't wait for a pool thread if all of them are busy
+	job->help();
+	job->join();
+}
+
 struct vdec_context final
 {
 	static const u32 id_base = 0xf0000000;
@@ -187,7 +329,10 @@ struct vdec_context final
 	const AVCodec* codec{};
 	const AVCodecDescriptor* codec_desc{};
 	AVCodecContext* ctx{};
-	SwsContext* sws{};
+	std::vector<SwsContext*> sws; // Used by cellVdecGetPicture
+	std::vector<SwsContext*> sws_ahead; // Used by the decoder thread
+	std::vector<u8> alpha_plane; // Used by cellVdecGetPicture
+	std::vector<u8> alpha_plane_ahead; // Used by the decoder thread
 
 	shared_mutex mutex; // Used for 'out' queue (TODO)
 
@@ -206,6 +351,10 @@ struct vdec_context final
 	std::deque<vdec_frame> out_queue;
 	const u32 out_max = 60;
 
+	atomic_t<u64> last_pic_format = 0; // Format of the last picture output, later pictures are converted to it ahead of time
+	std::vector<std::vector<u8>> picture_pool; // Recycled picture buffers
+	const u32 ahead_max = 8; // Maximum amount of converted pictures in the 'out' queue
+
 	atomic_t<s32> au_count{0};
 
 	lf_queue<vdec_cmd> in_cmd;
@@ -289,7 +438,50 @@ struct vdec_context final
 	~vdec_context()
 	{
 		avcodec_free_context(&ctx);
-		sws_freeContext(sws);
+
+		for (SwsContext* context : sws)
+		{
+			sws_freeContext(context);
+		}
+
+		for (SwsContext* context : sws_ahead)
+		{
+			sws_freeContext(context);
+		}
+	}
+
+	// Convert the picture to the format the game requested last, so cellVdecGetPicture only needs to copy it
+	void convert_ahead(vdec_frame& frame)
+	{
+		const u64 pic_format = last_pic_format;
+
+		if (!pic_format || (frame->format != AV_PIX_FMT_YUV420P && frame->format != AV_PIX_FMT_YUVJ420P))
+		{
+			return;
+		}
+
+		const u32 format_type = pic_format & 0xff;
+		const u8 alpha = static_cast<u8>(pic_format >> 8);
+
+		{
+			std::lock_guard lock{mutex};
+
+			// Don't hold too many converted pictures if the game doesn't keep up
+			if (std::count_if(out_queue.begin(), out_queue.end(), [](const vdec_frame& f) { return f.picture_format != 0; }) >= ahead_max)
+			{
+				return;
+			}
+
+			if (!picture_pool.empty())
+			{
+				frame.picture = std::move(picture_pool.back());
+				picture_pool.pop_back();
+			}
+		}
+
+		frame.picture.resize(vdec_picture_layout(format_type, frame->width, frame->height).size);
+		vdec_convert_picture(sws_ahead, alpha_plane_ahead, *frame.avf, format_type, alpha, frame.picture.data(), vdec_get_max_slices());
+		frame.picture_format = pic_format;
 	}
 
 	void exec(ppu_thread& ppu, u32 vid)
@@ -593,6 +785,8 @@ struct vdec_context final
 							break;
 						}
 
+						convert_ahead(decoded_frames.front());
+
 						{
 							std::lock_guard lock{mutex};
 							out_queue.push_back(std::move(decoded_frames.front()));
@@ -1256,19 +1450,13 @@ error_code cellVdecGetPictureExt(ppu_thread& ppu, u32 handle, vm::cptr<CellVdecP
 
 	if (outBuff)
 	{
-		const int w = frame->width;
-		const int h = frame->height;
-
-		AVPixelFormat out_f = AV_PIX_FMT_YUV420P;
-
-		std::unique_ptr<u8[]> alpha_plane;
-
 		switch (const u32 type = format->formatType)
 		{
-		case CELL_VDEC_PICFMT_ARGB32_ILV: out_f = AV_PIX_FMT_ARGB; alpha_plane.reset(new u8[w * h]); break;
-		case CELL_VDEC_PICFMT_RGBA32_ILV: out_f = AV_PIX_FMT_RGBA; alpha_plane.reset(new u8[w * h]); break;
-		case CELL_VDEC_PICFMT_UYVY422_ILV: out_f = AV_PIX_FMT_UYVY422; break;
-		case CELL_VDEC_PICFMT_YUV420_PLANAR: out_f = AV_PIX_FMT_YUV420P; break;
+		case CELL_VDEC_PICFMT_ARGB32_ILV:
+		case CELL_VDEC_PICFMT_RGBA32_ILV:
+		case CELL_VDEC_PICFMT_UYVY422_ILV:
+		case CELL_VDEC_PICFMT_YUV420_PLANAR:
+			break;
 		default:
 		{
 			fmt::throw_exception("cellVdecGetPictureExt: Unknown formatType (handle=0x%x, seq_id=%d, cmd_id=%d, type=%d)", handle, frame.seq_id, frame.cmd_id, type);
@@ -1277,51 +1465,43 @@ error_code cellVdecGetPictureExt(ppu_thread& ppu, u32 handle, vm::cptr<CellVdecP
 
 		// TODO: color matrix
 
-		if (alpha_plane)
-		{
-			std::memset(alpha_plane.get(), format->alpha, w * h);
-		}
-
-		AVPixelFormat in_f = AV_PIX_FMT_YUV420P;
-
 		switch (frame->format)
 		{
 		case AV_PIX_FMT_YUVJ420P:
 			cellVdec.error("cellVdecGetPictureExt: experimental AVPixelFormat (handle=0x%x, seq_id=%d, cmd_id=%d, format=%d). This may cause suboptimal video quality.", handle, frame.seq_id, frame.cmd_id, frame->format);
 			[[fallthrough]];
 		case AV_PIX_FMT_YUV420P:
-			in_f = alpha_plane ? AV_PIX_FMT_YUVA420P : static_cast<AVPixelFormat>(frame->format);
 			break;
 		default:
 			fmt::throw_exception("cellVdecGetPictureExt: Unknown frame format (%d)", frame->format);
 		}
 
-		cellVdec.trace("cellVdecGetPictureExt: handle=0x%x, seq_id=%d, cmd_id=%d, w=%d, h=%d, frameFormat=%d, formatType=%d, in_f=%d, out_f=%d, alpha_plane=%d, alpha=%d, colorMatrixType=%d", handle, frame.seq_id, frame.cmd_id, w, h, frame->format, format->formatType, +in_f, +out_f, !!alpha_plane, format->alpha, format->colorMatrixType);
-
-		vdec->sws = sws_getCachedContext(vdec->sws, w, h, in_f, w, h, out_f, SWS_POINT, nullptr, nullptr, nullptr);
+		const u64 pic_format = vdec_pic_format_key(format->formatType, format->alpha);
+		const bool converted = frame.picture_format == pic_format;
 
-		u8* in_data[4] = { frame->data[0], frame->data[1], frame->data[2], alpha_plane.get() };
-		int in_line[4] = { frame->linesize[0], frame->linesize[1], frame->linesize[2], w * 1 };
-		u8* out_data[4] = { outBuff.get_ptr() };
-		int out_line[4] = { w * 4 }; // RGBA32 or ARGB32
+		// Following pictures will be converted by the decoder thread
+		vdec->last_pic_format.release(pic_format);
 
-		// TODO:
-		// It's possible that we need to align the pitch to 128 here.
-		// PS HOME seems to rely on this somehow in certain cases.
+		cellVdec.trace("cellVdecGetPictureExt: handle=0x%x, seq_id=%d, cmd_id=%d, w=%d, h=%d, frameFormat=%d, formatType=%d, alpha=%d, colorMatrixType=%d, converted=%d", handle, frame.seq_id, frame.cmd_id, frame->width, frame->height, frame->format, format->formatType, format->alpha, format->colorMatrixType, converted);
 
-		if (!alpha_plane)
+		if (converted)
 		{
-			// YUV420P or UYVY422
-			out_data[1] = out_data[0] + w * h;
-			out_data[2] = out_data[0] + w * h * 5 / 4;
-
-			if (const int ret = av_image_fill_linesizes(out_line, out_f, w); ret < 0)
-			{
-				fmt::throw_exception("cellVdecGetPictureExt: av_image_fill_linesizes failed (handle=0x%x, seq_id=%d, cmd_id=%d, ret=0x%x): %s", handle, frame.seq_id, frame.cmd_id, ret, utils::av_error_to_string(ret));
-			}
+			std::memcpy(outBuff.get_ptr(), frame.picture.data(), frame.picture.size());
+		}
+		else
+		{
+			vdec_convert_picture(vdec->sws, vdec->alpha_plane, *frame.avf, format->formatType, format->alpha, outBuff.get_ptr(), vdec_get_max_slices());
 		}
+	}
 
-		sws_scale(vdec->sws, in_data, in_line, 0, h, out_data, out_line);
+	if (frame.picture.capacity())
+	{
+		std::lock_guard lock(vdec->mutex);
+
+		if (vdec->picture_pool.size() < vdec->ahead_max)
+		{
+			vdec->picture_pool.push_back(std::move(frame.picture));
+		}
 	}
 
 	return CELL_OK;
@@ -6,9 +6,15 @@
 #include "PPUOpcodes.h"
 #include "PPUThread.h"
 
+#include "Emu/system_config.h"
+#include "Emu/system_utils.hpp"
+#include "Crypto/sha1.h"
+#include "rpcs3_version.h"
+
 #include <unordered_set>
 #include "util/yaml.hpp"
 #include "util/asm.hpp"
+#include "util/serialization.hpp"
 
 LOG_CHANNEL(ppu_validator);
 
@@ -819,6 +825,229 @@ struct reg_state_t
 
 static constexpr reg_state_t s_reg_const_0{ 0, 1 };
 
+// Bump when the cache layout changes (analyser changes are covered by the build tag)
+static constexpr u32 c_ppu_analysis_version = 1;
+static const std::string c_ppu_analysis_magic = "RPCS3PPA";
+
+// Identifies the analyser by the commit of the build, results of other builds may be wrong and are never used.
+// Returns an empty string for local builds, whose sources may differ from the commit they report.
+static const std::string& ppu_get_analysis_build_tag()
+{
+	static const std::string s_tag = []() -> std::string
+	{
+		if (rpcs3::is_local_build())
+		{
+			return {};
+		}
+
+		const std::string version = rpcs3::get_version().to_string();
+
+		uchar hash[20]{};
+		sha1(reinterpret_cast<const uchar*>(version.data()), version.size(), hash);
+		return fmt::format("%s", fmt::base57(hash, 8));
+	}();
+
+	return s_tag;
+}
+
+// Returns the analysis cache file of the module, keyed by the build and everything the analysis depends on
+static std::string ppu_get_analysis_cache_path(const ppu_module<lv2_obj>& info, u32 lib_toc, u32 entry, u32 sec_end, const std::vector<u32>& applied, const std::vector<u32>& exported_funcs)
+{
+	if (!g_cfg.core.ppu_analysis_cache || ppu_get_analysis_build_tag().empty() || info.path.empty() || std::all_of(std::begin(info.sha1), std::end(info.sha1), FN(x == 0)))
+	{
+		return {};
+	}
+
+	sha1_context ctx;
+	sha1_starts(&ctx);
+
+	const auto update = [&](const auto& value)
+	{
+		sha1_update(&ctx, reinterpret_cast<const uchar*>(&value), sizeof(value));
+	};
+
+	sha1_update(&ctx, info.sha1, sizeof(info.sha1));
+	update(c_ppu_analysis_version);
+	update(lib_toc);
+	update(entry);
+	update(sec_end);
+	update(info.is_relocatable);
+	update(info.relocs.size());
+
+	// Load addresses (relocatable modules)
+	update(info.segs.size());
+
+	for (const auto& seg : info.segs)
+	{
+		update(seg.addr);
+		update(seg.size);
+		update(seg.type);
+	}
+
+	update(info.secs.size());
+
+	for (const auto& sec : info.secs)
+	{
+		update(sec.addr);
+		update(sec.size);
+		update(sec.type);
+		update(sec.flags);
+	}
+
+	// The patched values are not covered by the file hash
+	update(applied.size());
+
+	for (u32 addr : applied)
+	{
+		update(addr);
+
+		if (const auto ptr = info.get_ptr<u32>(addr))
+		{
+			update(u32{*ptr});
+		}
+	}
+
+	update(exported_funcs.size());
+
+	for (u32 addr : exported_funcs)
+	{
+		update(addr);
+	}
+
+	update(info.stub_addr_to_constant_state_of_registers.size());
+
+	for (const auto& [stub_addr, states] : info.stub_addr_to_constant_state_of_registers)
+	{
+		update(stub_addr);
+		update(states.size());
+
+		for (const auto& [mask, value] : states)
+		{
+			update(mask.mask);
+			update(value);
+		}
+	}
+
+	uchar key[20]{};
+	sha1_finish(&ctx, key);
+
+	std::string cache_path = info.cache;
+
+	if (cache_path.empty())
+	{
+		// Same location as PPU LLVM objects
+		cache_path = rpcs3::utils::get_cache_dir(info.path);
+		fmt::append(cache_path, "ppu-%s-%s/", fmt::base57(info.sha1), info.path.substr(info.path.find_last_of('/') + 1));
+	}
+
+	fmt::append(cache_path, "analysis-%s-%s.dat", ppu_get_analysis_build_tag(), fmt::base57(key));
+	return cache_path;
+}
+
+// Remove analysis results of other builds from the directory of the module
+static void ppu_remove_obsolete_analysis_cache(const std::string& path)
+{
+	const std::string dir = fs::get_parent_dir(path);
+	const std::string prefix = "analysis-" + ppu_get_analysis_build_tag() + "-";
+
+	for (const fs::dir_entry& entry : fs::dir(dir))
+	{
+		if (entry.is_directory || !entry.name.starts_with("analysis-") || !entry.name.ends_with(".dat") || entry.name.starts_with(prefix))
+		{
+			continue;
+		}
+
+		if (fs::remove_file(dir + "/" + entry.name))
+		{
+			ppu_log.notice("Removed obsolete PPU analysis cache %s", entry.name);
+		}
+	}
+}
+
+static bool ppu_load_analysis_cache(const std::string& path, std::vector<ppu_function>& funcs)
+{
+	fs::file file(path);
+
+	if (!file || file.size() < 20)
+	{
+		return false;
+	}
+
+	std::vector<u8> data = file.to_vector<u8>();
+
+	// Verify the trailing hash before parsing
+	uchar hash[20]{};
+	sha1(data.data(), data.size() - 20, hash);
+
+	if (std::memcmp(hash, data.data() + data.size() - 20, sizeof(hash)) != 0)
+	{
+		ppu_log.error("PPU analysis cache is corrupted: %s", path);
+		return false;
+	}
+
+	data.resize(data.size() - 20);
+
+	const usz size = data.size();
+
+	utils::serial ar;
+	ar.set_reading_state(std::move(data));
+
+	std::string magic;
+	u32 version = 0;
+	usz count = 0;
+
+	if (!ar(magic, version) || magic != c_ppu_analysis_magic || version != c_ppu_analysis_version || !ar(count))
+	{
+		return false;
+	}
+
+	std::vector<ppu_function> result(count);
+
+	for (auto& func : result)
+	{
+		ar(func.addr, func.toc, func.size, func.blocks);
+	}
+
+	if (!ar.is_valid() || ar.pos != size)
+	{
+		ppu_log.error("PPU analysis cache is corrupted: %s", path);
+		return false;
+	}
+
+	funcs.insert(funcs.end(), std::make_move_iterator(result.begin()), std::make_move_iterator(result.end()));
+	return true;
+}
+
+static void ppu_save_analysis_cache(const std::string& path, std::span<const ppu_function> funcs)
+{
+	utils::serial ar;
+	ar(c_ppu_analysis_magic, c_ppu_analysis_version, usz{funcs.size()});
+
+	for (const auto& func : funcs)
+	{
+		ar(func.addr, func.toc, func.size, func.blocks);
+	}
+
+	uchar hash[20]{};
+	sha1(ar.data.data(), ar.data.size(), hash);
+
+	if (!fs::create_path(fs::get_parent_dir(path)))
+	{
+		ppu_log.error("Failed to create PPU analysis cache directory for %s (%s)", path, fs::g_tls_error);
+		return;
+	}
+
+	fs::pending_file file(path);
+
+	if (!file.file || file.file.write(ar.data.data(), ar.data.size()) != ar.data.size() || file.file.write(hash, sizeof(hash)) != sizeof(hash) || !file.commit())
+	{
+		ppu_log.error("Failed to save PPU analysis cache %s (%s)", path, fs::g_tls_error);
+		return;
+	}
+
+	ppu_remove_obsolete_analysis_cache(path);
+}
+
 template <>
 bool ppu_module<lv2_obj>::analyse(u32 lib_toc, u32 entry, const u32 sec_end, const std::vector<u32>& applied, const std::vector<u32>& exported_funcs, std::function<bool()> check_aborted)
 {
@@ -827,6 +1056,15 @@ bool ppu_module<lv2_obj>::analyse(u32 lib_toc, u32 entry, const u32 sec_end, con
 		return false;
 	}
 
+	const usz old_funcs_size = funcs.size();
+	const std::string analysis_cache = ppu_get_analysis_cache_path(*this, lib_toc, entry, sec_end, applied, exported_funcs);
+
+	if (!analysis_cache.empty() && ppu_load_analysis_cache(analysis_cache, funcs))
+	{
+		ppu_log.notice("Block analysis: %zu blocks (loaded from %s)", funcs.size() - old_funcs_size, analysis_cache);
+		return true;
+	}
+
 	// Assume first segment is executable
 	const u32 start = segs[0].addr;
 
@@ -3274,5 +3512,11 @@ bool ppu_module<lv2_obj>::analyse(u32 lib_toc, u32 entry, const u32 sec_end, con
 	}
 
 	ppu_log.notice("Block analysis: %zu blocks (%zu enqueued)", funcs.size(), block_queue.size());
+
+	if (!analysis_cache.empty())
+	{
+		ppu_save_analysis_cache(analysis_cache, std::span(funcs).subspan(old_funcs_size));
+	}
+
 	return true;
 }
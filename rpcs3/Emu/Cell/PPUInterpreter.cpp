@@ -591,8 +591,8 @@ extern void ppu_execute_syscall(ppu_thread& ppu, u64 code);
 
 extern u32 ppu_lwarx(ppu_thread& ppu, u32 addr);
 extern u64 ppu_ldarx(ppu_thread& ppu, u32 addr);
-extern bool ppu_stwcx(ppu_thread& ppu, u32 addr, u32 reg_value);
-extern bool ppu_stdcx(ppu_thread& ppu, u32 addr, u64 reg_value);
+extern bool ppu_stwcx(ppu_thread& ppu, u32 addr, u32 reg_value, u32 pc);
+extern bool ppu_stdcx(ppu_thread& ppu, u32 addr, u64 reg_value, u32 pc);
 extern void ppu_trap(ppu_thread& ppu, u64 addr);
 
 // NaNs production precedence: NaN from Va, Vb, Vc
@@ -4427,11 +4427,11 @@ auto STWCX()
 	if constexpr (Build == 0xf1a6)
 		return ppu_exec_select<Flags...>::template select<>();
 
-	static const auto exec = [](ppu_thread& ppu, ppu_opcode_t op) {
+	static const auto exec = [](ppu_thread& ppu, ppu_opcode_t op, be_t<u32>* this_op) {
 	const u64 addr = op.ra ? ppu.gpr[op.ra] + ppu.gpr[op.rb] : ppu.gpr[op.rb];
-	ppu_cr_set(ppu, 0, false, false, ppu_stwcx(ppu, vm::cast(addr), static_cast<u32>(ppu.gpr[op.rs])), ppu.xer.so);
+	ppu_cr_set(ppu, 0, false, false, ppu_stwcx(ppu, vm::cast(addr), static_cast<u32>(ppu.gpr[op.rs]), vm::get_addr(this_op)), ppu.xer.so);
 	};
-	RETURN_(ppu, op);
+	RETURN_(ppu, op, this_op);
 }
 
 template <u32 Build, ppu_exec_bit... Flags>
@@ -4547,11 +4547,11 @@ auto STDCX()
 	if constexpr (Build == 0xf1a6)
 		return ppu_exec_select<Flags...>::template select<>();
 
-	static const auto exec = [](ppu_thread& ppu, ppu_opcode_t op) {
+	static const auto exec = [](ppu_thread& ppu, ppu_opcode_t op, be_t<u32>* this_op) {
 	const u64 addr = op.ra ? ppu.gpr[op.ra] + ppu.gpr[op.rb] : ppu.gpr[op.rb];
-	ppu_cr_set(ppu, 0, false, false, ppu_stdcx(ppu, vm::cast(addr), ppu.gpr[op.rs]), ppu.xer.so);
+	ppu_cr_set(ppu, 0, false, false, ppu_stdcx(ppu, vm::cast(addr), ppu.gpr[op.rs], vm::get_addr(this_op)), ppu.xer.so);
 	};
-	RETURN_(ppu, op);
+	RETURN_(ppu, op, this_op);
 }
 
 template <u32 Build, ppu_exec_bit... Flags>
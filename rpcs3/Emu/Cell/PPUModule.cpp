@@ -1561,7 +1561,8 @@ const char* get_prx_name_by_cia(u32 addr)
 	return nullptr;
 }
 
-shared_ptr<lv2_prx> ppu_load_prx(const ppu_prx_object& elf, bool virtual_load, const std::string& path, s64 file_offset, utils::serial* ar)
+// If deferred_analysis is set, the analysis is returned as a callback instead of being run (it may be run on another thread)
+shared_ptr<lv2_prx> ppu_load_prx(const ppu_prx_object& elf, bool virtual_load, const std::string& path, s64 file_offset, utils::serial* ar, std::function<void()>* deferred_analysis)
 {
 	if (elf != elf_error::ok)
 	{
@@ -1994,6 +1995,17 @@ shared_ptr<lv2_prx> ppu_load_prx(const ppu_prx_object& elf, bool virtual_load, c
 
 	prx->applied_patches = applied;
 	prx->is_relocatable = true;
+
+	if (deferred_analysis)
+	{
+		*deferred_analysis = [prx = prx.get(), toc, end, exported_funcs = std::move(exported_funcs)]()
+		{
+			prx->analyse(toc, 0, end, prx->applied_patches, exported_funcs);
+		};
+
+		return prx;
+	}
+
 	prx->analyse(toc, 0, end, applied, exported_funcs);
 
 	if (!ar && !virtual_load)
@@ -2004,6 +2016,11 @@ shared_ptr<lv2_prx> ppu_load_prx(const ppu_prx_object& elf, bool virtual_load, c
 	return prx;
 }
 
+shared_ptr<lv2_prx> ppu_load_prx(const ppu_prx_object& elf, bool virtual_load, const std::string& path, s64 file_offset, utils::serial* ar)
+{
+	return ppu_load_prx(elf, virtual_load, path, file_offset, ar, nullptr);
+}
+
 void ppu_unload_prx(const lv2_prx& prx)
 {
 	if (prx.segs.empty() || prx.segs[0].ptr != vm::base(prx.segs[0].addr))
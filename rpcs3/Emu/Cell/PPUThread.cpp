@@ -9,6 +9,7 @@
 #include "Emu/localized_string.h"
 #include "Emu/perf_meter.hpp"
 #include "Emu/Memory/vm_reservation.h"
+#include "Emu/Memory/vm_reservation_stats.h"
 #include "Emu/Memory/vm_locking.h"
 #include "Emu/RSX/Core/RSXReservationLock.hpp"
 #include "Emu/VFS.h"
@@ -3226,6 +3227,8 @@ const auto ppu_stcx_accurate_tx = build_function_asm<u64(*)(u32 raddr, u64 rtime
 
 	Label tx1 = build_transaction_enter(c, fall, [&]()
 	{
+		c.add(x86::qword_ptr(args[2], ::offset32(&ppu_thread::ftx) - ::offset32(&ppu_thread::rdata)), 1);
+		c.or_(x86::dword_ptr(args[2], ::offset32(&ppu_thread::ftx_status) - ::offset32(&ppu_thread::rdata)), x86::eax);
 		build_get_tsc(c);
 		c.sub(x86::rax, stamp0);
 		c.movabs(x86::r13, reinterpret_cast<u64>(&g_rtm_tx_limit2));
@@ -3371,7 +3374,7 @@ const auto ppu_stcx_accurate_tx = build_function_asm<u64(*)(u32 raddr, u64 rtime
 });
 
 template <typename T>
-static bool ppu_store_reservation(ppu_thread& ppu, u32 addr, u64 reg_value)
+static bool ppu_store_reservation(ppu_thread& ppu, u32 addr, u64 reg_value, u32 pc)
 {
 	perf_meter<"STCX"_u32> perf0;
 
@@ -3387,6 +3390,27 @@ static bool ppu_store_reservation(ppu_thread& ppu, u32 addr, u64 reg_value)
 	auto& res = vm::reservation_acquire(addr);
 	const u64 rtime = ppu.rtime;
 
+	const bool sample_stats = vm::reservation_stats_sample();
+	const u64 ftx0 = ppu.ftx;
+
+	if (sample_stats) [[unlikely]]
+	{
+		ppu.ftx_status = 0;
+	}
+
+	const auto record_stats = [&, stats_addr = addr](bool success)
+	{
+		vm::reservation_stats_record(vm::reservation_sample{
+			.addr = stats_addr,
+			.pc = pc,
+			.cpu_id = ppu.id,
+			.event = success ? vm::reservation_event::store_success : vm::reservation_event::store_failure,
+			.tx_aborts = static_cast<u32>(ppu.ftx - ftx0),
+			.tx_status = ppu.ftx_status,
+			.waiters = vm::reservation_notifier_count(stats_addr),
+		});
+	};
+
 	be_t<u64> old_data = 0;
 	std::memcpy(&old_data, &ppu.rdata[addr & 0x78], sizeof(old_data));
 	be_t<u64> new_data = old_data;
@@ -3416,6 +3440,11 @@ static bool ppu_store_reservation(ppu_thread& ppu, u32 addr, u64 reg_value)
 				data += 0;
 			}
 
+			if (sample_stats) [[unlikely]]
+			{
+				record_stats(false);
+			}
+
 			ppu.raddr = 0;
 			ppu.res_cached = 0;
 			return false;
@@ -3424,6 +3453,11 @@ static bool ppu_store_reservation(ppu_thread& ppu, u32 addr, u64 reg_value)
 
 	if (old_data != data || rtime != (res & -128))
 	{
+		if (sample_stats) [[unlikely]]
+		{
+			record_stats(false);
+		}
+
 		ppu.raddr = 0;
 		ppu.res_cached = 0;
 		return false;
@@ -3684,9 +3718,20 @@ static bool ppu_store_reservation(ppu_thread& ppu, u32 addr, u64 reg_value)
 		ppu.res_cached = ppu.raddr;
 		ppu.rtime += 128;
 		ppu.raddr = 0;
+
+		if (sample_stats) [[unlikely]]
+		{
+			record_stats(true);
+		}
+
 		return true;
 	}
 
+	if (sample_stats) [[unlikely]]
+	{
+		record_stats(false);
+	}
+
 	const u32 notify = ppu.res_notify;
 
 	// Do not risk postponing too much (because this is probably an indefinite loop)
@@ -3708,14 +3753,15 @@ static bool ppu_store_reservation(ppu_thread& ppu, u32 addr, u64 reg_value)
 	return false;
 }
 
-extern bool ppu_stwcx(ppu_thread& ppu, u32 addr, u32 reg_value)
+// 'pc' is the address of the instruction (ppu.cia is not updated by the interpreter and LLVM), only used for statistics
+extern bool ppu_stwcx(ppu_thread& ppu, u32 addr, u32 reg_value, u32 pc)
 {
-	return ppu_store_reservation<u32>(ppu, addr, reg_value);
+	return ppu_store_reservation<u32>(ppu, addr, reg_value, pc);
 }
 
-extern bool ppu_stdcx(ppu_thread& ppu, u32 addr, u64 reg_value)
+extern bool ppu_stdcx(ppu_thread& ppu, u32 addr, u64 reg_value, u32 pc)
 {
-	return ppu_store_reservation<u64>(ppu, addr, reg_value);
+	return ppu_store_reservation<u64>(ppu, addr, reg_value, pc);
 }
 
 struct jit_core_allocator
@@ -4594,6 +4640,25 @@ extern void ppu_precompile(std::vector<std::string>& dir_queue, std::vector<ppu_
 	exec_worker();
 }
 
+// Compiles the main executable while the guest runs on the interpreter fallback (tiered compilation)
+struct ppu_tiered_compiler
+{
+	static constexpr auto thread_name = "PPU Tiered Compiler"sv;
+
+	void operator()()
+	{
+		const u64 start = get_system_time();
+
+		// Function entries are repointed from ppu_recompiler_fallback_ghc to the compiled code once linked
+		ppu_initialize(g_fxo->get<main_ppu_module<lv2_obj>>());
+
+		if (!Emu.IsStopped())
+		{
+			ppu_log.success("LLVM: Main executable switched to compiled code after %.3fs", (get_system_time() - start) / 1000000.);
+		}
+	}
+};
+
 extern void ppu_initialize()
 {
 	if (!g_fxo->is_init<main_ppu_module<lv2_obj>>())
@@ -4700,8 +4765,12 @@ extern void ppu_initialize()
 		dir_queue.emplace_back(firmware_sprx_path);
 	}
 
+	// Compile the main executable in the background instead of blocking the boot (only when its cache is missing, not when loading a savestate)
+	const bool tiered_main = compile_main && g_cfg.core.ppu_decoder == ppu_decoder_type::llvm && g_cfg.core.ppu_llvm_tiered_compilation && !Emu.DeserialManager();
+
 	// Avoid compilation if main's cache exists or it is a standalone SELF with no PARAM.SFO
-	if (compile_main && g_cfg.core.llvm_precompilation && !Emu.GetTitleID().empty() && !Emu.IsChildProcess())
+	// Tiered compilation skips it as well: the other executables are compiled once they are loaded
+	if (compile_main && !tiered_main && g_cfg.core.llvm_precompilation && !Emu.GetTitleID().empty() && !Emu.IsChildProcess())
 	{
 		// Try to add all related directories
 		const std::set<std::string> dirs = Emu.GetGameDirs();
@@ -4718,7 +4787,7 @@ extern void ppu_initialize()
 	}
 
 	// Initialize main module cache
-	if (!_main.segs.empty())
+	if (!_main.segs.empty() && !tiered_main)
 	{
 		ppu_initialize(_main);
 	}
@@ -4731,12 +4800,32 @@ extern void ppu_initialize()
 			return;
 		}
 
+		if (tiered_main && ptr == &_main)
+		{
+			// Owned by the tiered compiler thread
+			continue;
+		}
+
 		ppu_initialize(*ptr);
 	}
+
+	// Started after the preloaded libraries, modules loaded later wait for it in ppu_initialize
+	if (tiered_main)
+	{
+		ppu_log.notice("LLVM: Starting the main executable on the interpreter, compiling it in the background");
+		g_fxo->init<named_thread<ppu_tiered_compiler>>();
+	}
 }
 
 bool ppu_initialize(const ppu_module<lv2_obj>& info, bool check_only, u64 file_size)
 {
+	if (!check_only && g_fxo->is_init<named_thread<ppu_tiered_compiler>>() && &info != g_fxo->try_get<main_ppu_module<lv2_obj>>())
+	{
+		// Wait for the main executable to be compiled (tiered compilation)
+		// Both compilations would otherwise modify the JIT module map, function tables and patches at the same time
+		g_fxo->get<named_thread<ppu_tiered_compiler>>()();
+	}
+
 	if (g_cfg.core.ppu_decoder != ppu_decoder_type::llvm)
 	{
 		if (check_only || vm::base(info.segs[0].addr) != info.segs[0].ptr)
@@ -5411,7 +5500,7 @@ bool ppu_initialize(const ppu_module<lv2_obj>& info, bool check_only, u64 file_s
 				settings += ppu_settings::contains_symbol_resolver; // Avoid invalidating all modules for this purpose
 
 			// Write version, hash, CPU, settings
-			fmt::append(obj_name, "v7-kusa-%s-%s-%s.obj", fmt::base57(output, 16), fmt::base57(settings), jit_compiler::cpu(g_cfg.core.llvm_cpu));
+			fmt::append(obj_name, "v8-kusa-%s-%s-%s.obj", fmt::base57(output, 16), fmt::base57(settings), jit_compiler::cpu(g_cfg.core.llvm_cpu));
 		}
 
 		if (cpu ? cpu->state.all_of(cpu_flag::exit) : Emu.IsStopped())
@@ -5485,37 +5574,7 @@ bool ppu_initialize(const ppu_module<lv2_obj>& info, bool check_only, u64 file_s
 			const ppu_module<lv2_obj>& main_module;
 			const std::string& cache_path;
 			const cpu_thread* cpu;
-
-			std::unique_lock<decltype(jit_core_allocator::sem)> core_lock;
-
-			thread_op(atomic_t<u32>& work_cv, std::vector<std::pair<std::string, ppu_module<lv2_obj>>>& workload
-				, const cpu_thread* cpu, const ppu_module<lv2_obj>& main_module, const std::string& cache_path, decltype(jit_core_allocator::sem)& sem) noexcept
-
-				: work_cv(work_cv)
-				, workload(workload)
-				, main_module(main_module)
-				, cache_path(cache_path)
-				, cpu(cpu)
-			{
-				// Save mutex
-				core_lock = std::unique_lock{sem, std::defer_lock};
-			}
-
-			thread_op(const thread_op& other) noexcept
-				: work_cv(other.work_cv)
-				, workload(other.workload)
-				, main_module(other.main_module)
-				, cache_path(other.cache_path)
-				, cpu(other.cpu)
-			{
-				if (auto mtx = other.core_lock.mutex())
-				{
-					// Save mutex
-					core_lock = std::unique_lock{*mtx, std::defer_lock};
-				}
-			}
-
-			thread_op(thread_op&& other) noexcept = default;
+			task_job& job;
 
 			void operator()()
 			{
@@ -5525,7 +5584,7 @@ bool ppu_initialize(const ppu_module<lv2_obj>& info, bool check_only, u64 file_s
 	#ifdef __APPLE__
 				pthread_jit_write_protect_np(false);
 	#endif
-				for (u32 i = work_cv++; i < workload.size(); i = work_cv++, g_progr_pdone++)
+				for (u32 i = work_cv++; i < workload.size(); i = work_cv++, g_progr_pdone++, job.add_done())
 				{
 					if (cpu ? cpu->state.all_of(cpu_flag::exit) : Emu.IsStopped())
 					{
@@ -5558,26 +5617,28 @@ bool ppu_initialize(const ppu_module<lv2_obj>& info, bool check_only, u64 file_s
 
 					ppu_log.success("LLVM: Compiled module %s", obj_name);
 				}
-
-				core_lock.unlock();
 			}
 		};
 
 		// Prevent watchdog thread from terminating
 		g_watchdog_hold_ctr++;
 
-		named_thread_group threads(fmt::format("PPUW.%u.", ++g_fxo->get<thread_index_allocator>().index), thread_count
-			, thread_op(work_cv, workload, cpu, info, cache_path, g_fxo->get<jit_core_allocator>().sem)
-			, [&](u32 /*thread_index*/, thread_op& op)
+		const auto compile_job = task_pool::submit(fmt::format("PPU Compiler %u", ++g_fxo->get<thread_index_allocator>().index), thread_count, task_priority::normal, [&](task_job& job, u32 /*slot*/)
 		{
 			// Allocate "core"
-			op.core_lock.lock();
+			std::lock_guard core_lock(g_fxo->get<jit_core_allocator>().sem);
+
+			// Second check after allocating the core
+			if (work_cv >= workload.size() || (cpu ? cpu->state.all_of(cpu_flag::exit) : Emu.IsStopped()))
+			{
+				return;
+			}
 
-			// Second check before creating another thread
-			return work_cv < workload.size() && (cpu ? !cpu->state.all_of(cpu_flag::exit) : !Emu.IsStopped());
+			thread_op{work_cv, workload, info, cache_path, cpu, job}();
 		});
 
-		threads.join();
+		compile_job->add_total(workload.size());
+		compile_job->join();
 
 		g_watchdog_hold_ctr--;
 	}
@@ -309,6 +309,9 @@ public:
 	// Hypervisor context data
 	rpcs3::hypervisor_context_t hv_ctx; // HV context for gate enter exit. Keep at a low struct offset.
 
+	u64 ftx = 0; // Failed transactions
+	u32 ftx_status = 0; // Combined abort status of failed transactions
+
 	u64 last_ftsc = 0;
 	u64 last_ftime = 0;
 	u32 last_faddr = 0;
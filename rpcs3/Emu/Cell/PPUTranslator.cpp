@@ -3132,7 +3132,7 @@ void PPUTranslator::STDX(ppu_opcode_t op)
 
 void PPUTranslator::STWCX(ppu_opcode_t op)
 {
-	const auto bit = Call(GetType<bool>(), "__stwcx", m_thread, op.ra ? m_ir->CreateAdd(GetGpr(op.ra), GetGpr(op.rb)) : GetGpr(op.rb), GetGpr(op.rs, 32));
+	const auto bit = Call(GetType<bool>(), "__stwcx", m_thread, op.ra ? m_ir->CreateAdd(GetGpr(op.ra), GetGpr(op.rb)) : GetGpr(op.rb), GetGpr(op.rs, 32), Trunc(GetAddr()));
 	SetCrField(0, m_ir->getFalse(), m_ir->getFalse(), bit);
 }
 
@@ -3193,7 +3193,7 @@ void PPUTranslator::SUBFZE(ppu_opcode_t op)
 
 void PPUTranslator::STDCX(ppu_opcode_t op)
 {
-	const auto bit = Call(GetType<bool>(), "__stdcx", m_thread, op.ra ? m_ir->CreateAdd(GetGpr(op.ra), GetGpr(op.rb)) : GetGpr(op.rb), GetGpr(op.rs));
+	const auto bit = Call(GetType<bool>(), "__stdcx", m_thread, op.ra ? m_ir->CreateAdd(GetGpr(op.ra), GetGpr(op.rb)) : GetGpr(op.rb), GetGpr(op.rs), Trunc(GetAddr()));
 	SetCrField(0, m_ir->getFalse(), m_ir->getFalse(), bit);
 }
 
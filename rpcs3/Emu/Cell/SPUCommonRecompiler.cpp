@@ -6,6 +6,7 @@
 #include "Emu/system_progress.hpp"
 #include "Emu/system_utils.hpp"
 #include "Emu/cache_utils.hpp"
+#include "Emu/Cell/timers.hpp"
 #include "Emu/IdManager.h"
 #include "Emu/localized_string.h"
 #include "Crypto/sha1.h"
@@ -831,7 +832,10 @@ void spu_cache::initialize(bool build_existing_cache)
 		progress_dialog.emplace(get_localized_string(localized_string_id::PROGRESS_DIALOG_BUILDING_SPU_CACHE));
 	}
 
-	named_thread_group workers("SPU Worker ", worker_count, [&]() -> uint
+	// How much every worker compiled
+	std::vector<u32> worker_results(worker_count);
+
+	const auto build_job = task_pool::submit("SPU Cache Builder", worker_count, task_priority::normal, [&](task_job& job, u32 slot)
 	{
 #ifdef __APPLE__
 		pthread_jit_write_protect_np(false);
@@ -873,8 +877,8 @@ void spu_cache::initialize(bool build_existing_cache)
 		// Counter for error reporting
 		u32 logged_error = 0;
 
-		// How much every thread compiled
-		uint result = 0;
+		// How much this worker compiled
+		u32 result = 0;
 
 		// Fake LS
 		std::vector<be_t<u32>> ls(0x10000);
@@ -1154,16 +1158,20 @@ void spu_cache::initialize(bool build_existing_cache)
 			g_progr_pdone += pending_progress.exchange(0);
 		}
 
-		return result;
+		worker_results[slot] = result;
+		job.add_done(result);
 	});
 
+	build_job->add_total(func_list.size() + total_precompile);
+	build_job->join();
+
 	u32 built_total = 0;
 
-	// Join (implicitly) and print individual results
-	for (u32 i = 0; i < workers.size(); i++)
+	// Print individual results
+	for (u32 i = 0; i < worker_count; i++)
 	{
-		spu_log.notice("SPU Runtime: Worker %u built %u programs.", i + 1, workers[i]);
-		built_total += workers[i];
+		spu_log.notice("SPU Runtime: Worker %u built %u programs.", i + 1, worker_results[i]);
+		built_total += worker_results[i];
 	}
 
 	spu_log.notice("SPU Runtime: Workers built %u programs.", built_total);
@@ -2080,14 +2088,6 @@ spu_function_t spu_runtime::make_branch_patchpoint(u16 data) const
 #endif
 }
 
-spu_recompiler_base::spu_recompiler_base()
-{
-}
-
-spu_recompiler_base::~spu_recompiler_base()
-{
-}
-
 void spu_recompiler_base::dispatch(spu_thread& spu, void*, u8* rip)
 {
 	// If code verification failed from a patched patchpoint, clear it with a dispatcher jump
@@ -2858,40 +2858,131 @@ struct block_reg_info
 
 	std::vector<node_t> prev_nodes;
 
-	static std::unique_ptr<block_reg_info> create(u32 pc) noexcept
+	// Initialize the state of a new block (the object may be reused)
+	void reset(u32 _pc) noexcept
 	{
-		auto ptr = new block_reg_info{ pc, reg_state_t::make_unknown<s_reg_max>(pc) };
+		pc = _pc;
+		local_state = reg_state_t::make_unknown<s_reg_max>(_pc);
 
-		for (reg_state_t& f : ptr->local_state)
+		for (reg_state_t& f : local_state)
 		{
 			f.flag += vf::is_null;
 		}
 
-		ptr->start_reg_state = ptr->local_state;
-		return std::unique_ptr<block_reg_info>(ptr);
+		has_true_state = false;
+		start_reg_state = local_state;
+		end_reg_state = {};
+		addend_reg_state = {};
+		walkby_state = {};
+		next_nodes_count = 0;
+		prev_nodes.clear();
 	}
 
 	// Evaluate registers state
-	std::array<reg_state_t, s_reg_max>& evaluate_start_state(const std::map<u32, std::unique_ptr<block_reg_info>>& map, bool extensive_evaluation);
+	std::array<reg_state_t, s_reg_max>& evaluate_start_state(const block_reg_info_map& map, bool extensive_evaluation);
 
 	// This function creates new node if not found and links the proceeding node to the old node
 	// In a manner in which no duplicate paths are formed
-	static void create_node(u32 pc_rhs, u32 parent_pc, std::map<u32, std::unique_ptr<block_reg_info>>& map)
+	static void create_node(u32 pc_rhs, u32 parent_pc, block_reg_info_map& map);
+};
+
+// Block register states indexed by LS address, allocated from a pool which is kept between analyses
+// Memory: 512 KB for the index and ~18 KB per pooled state, the pool grows to the largest block count analysed so far
+struct block_reg_info_map
+{
+	std::array<block_reg_info*, SPU_LS_SIZE / 4> index{};
+
+	std::vector<std::unique_ptr<block_reg_info>> pool;
+
+	// Number of pool entries in use
+	usz used = 0;
+
+	// Block addresses (in creation order until sorted)
+	std::vector<u32> addrs;
+
+	bool is_sorted = true;
+
+	block_reg_info* get(u32 pc) const
+	{
+		return ::at32(index, pc / 4);
+	}
+
+	block_reg_info* at(u32 pc) const
+	{
+		return ensure(get(pc));
+	}
+
+	block_reg_info* create(u32 pc)
+	{
+		block_reg_info*& ptr = ::at32(index, pc / 4);
+
+		if (ptr)
+		{
+			return ptr;
+		}
+
+		if (used == pool.size())
+		{
+			pool.emplace_back(std::make_unique<block_reg_info>());
+		}
+
+		ptr = pool[used++].get();
+		ptr->reset(pc);
+
+		is_sorted = is_sorted && (addrs.empty() || addrs.back() < pc);
+		addrs.push_back(pc);
+		return ptr;
+	}
+
+	bool empty() const
+	{
+		return addrs.empty();
+	}
+
+	// Block addresses in ascending order
+	const std::vector<u32>& sorted()
 	{
-		//ensure(parent_node != pc_rhs);
-		ensure(map[parent_pc]);
+		if (!is_sorted)
+		{
+			std::sort(addrs.begin(), addrs.end());
+			is_sorted = true;
+		}
+
+		return addrs;
+	}
 
-		if (!map[pc_rhs])
+	void clear()
+	{
+		for (u32 pc : addrs)
 		{
-			map[pc_rhs] = create(pc_rhs);
+			index[pc / 4] = nullptr;
 		}
 
-		node_t prev_node{parent_pc};
-		map[parent_pc]->next_nodes_count++;
-		map[pc_rhs]->prev_nodes.emplace_back(prev_node);
+		addrs.clear();
+		used = 0;
+		is_sorted = true;
 	}
 };
 
+void block_reg_info::create_node(u32 pc_rhs, u32 parent_pc, block_reg_info_map& map)
+{
+	//ensure(parent_node != pc_rhs);
+	const auto parent = map.at(parent_pc);
+	const auto node = map.create(pc_rhs);
+
+	node_t prev_node{parent_pc};
+	parent->next_nodes_count++;
+	node->prev_nodes.emplace_back(prev_node);
+}
+
+spu_recompiler_base::spu_recompiler_base()
+{
+}
+
+spu_recompiler_base::~spu_recompiler_base()
+{
+}
+
 spu_program spu_recompiler_base::analyse(const be_t<u32>* ls, u32 entry_point, std::map<u32, std::vector<u32>>* out_target_list)
 {
 	// Result: addr + raw instruction data
@@ -4935,8 +5026,14 @@ spu_program spu_recompiler_base::analyse(const be_t<u32>* ls, u32 entry_point, s
 	// Reset tags
 	reg_state_t::alloc_tag(true);
 
-	std::map<u32, std::unique_ptr<block_reg_info>> infos;
-	infos.emplace(entry_point, block_reg_info::create(entry_point));
+	if (!m_reg_infos)
+	{
+		m_reg_infos = std::make_unique<block_reg_info_map>();
+	}
+
+	block_reg_info_map& infos = *m_reg_infos;
+	infos.clear();
+	infos.create(entry_point);
 
 	struct block_reg_state_iterator
 	{
@@ -5032,10 +5129,10 @@ spu_program spu_recompiler_base::analyse(const be_t<u32>* ls, u32 entry_point, s
 		{
 			if (wi == 0)
 			{
-				for (auto& [addr, block] : infos)
+				for (u32 addr : infos.sorted())
 				{
 					// Evaluate state for all blocks
-					block->evaluate_start_state(infos, should_search_patterns);
+					infos.at(addr)->evaluate_start_state(infos, should_search_patterns);
 				}
 			}
 
@@ -5044,13 +5141,12 @@ spu_program spu_recompiler_base::analyse(const be_t<u32>* ls, u32 entry_point, s
 				break;
 			}
 
-			if (!infos[bpc])
+			if (!infos.get(bpc))
 			{
 				std::string out = fmt::format("Blocks:");
 
-				for (auto& [pc, _] : infos)
+				for (u32 pc : infos.sorted())
 				{
-					if (!_) continue;
 					fmt::append(out, " [0x%x]", pc);
 				}
 
@@ -5073,7 +5169,7 @@ spu_program spu_recompiler_base::analyse(const be_t<u32>* ls, u32 entry_point, s
 				spu_log.fatal("%s", out);
 			}
 
-			true_state_walkby = &ensure(infos[bpc])->evaluate_start_state(infos, should_search_patterns);
+			true_state_walkby = &infos.at(bpc)->evaluate_start_state(infos, should_search_patterns);
 
 			for (reg_state_t& f : *true_state_walkby)
 			{
@@ -5085,7 +5181,7 @@ spu_program spu_recompiler_base::analyse(const be_t<u32>* ls, u32 entry_point, s
 			}
 		}
 
-		auto& vregs = is_form_block ? infos[bpc]->local_state : *true_state_walkby;
+		auto& vregs = is_form_block ? infos.at(bpc)->local_state : *true_state_walkby;
 		const auto atomic16 = is_pattern_match ? &::at32(reg_state_it, wi).atomic16 : &dummy16;
 		const auto rchcnt_loop = is_pattern_match ? &::at32(reg_state_it, wi).rchcnt_loop : &dummy_loop;
 
@@ -5244,7 +5340,7 @@ spu_program spu_recompiler_base::analyse(const be_t<u32>* ls, u32 entry_point, s
 			{
 				wi++;
 
-				auto& block = infos[bpc];
+				const auto block = infos.at(bpc);
 
 				if (bpc == entry_point || (g_cfg.core.spu_block_size != spu_block_size_type::safe && (m_ret_info[bpc / 4] || m_entry_info[bpc / 4])))
 				{
@@ -5569,7 +5665,7 @@ spu_program spu_recompiler_base::analyse(const be_t<u32>* ls, u32 entry_point, s
 
 					if (!infos.empty())
 					{
-						reg_state_it.emplace_back(::at32(infos, entry_point)->pc).iterator_id = iterator_id_alloc++;;
+						reg_state_it.emplace_back(infos.at(entry_point)->pc).iterator_id = iterator_id_alloc++;;
 					}
 				}
 			}
@@ -5664,11 +5760,6 @@ spu_program spu_recompiler_base::analyse(const be_t<u32>* ls, u32 entry_point, s
 			// Validate new target (TODO)
 			if (target >= lsa && target < limit)
 			{
-				if (!infos[target])
-				{
-					infos[target] = block_reg_info::create(target);
-				}
-
 				block_reg_info::create_node(target, bpc, infos);
 
 				if (!run_on_block[target / 4])
@@ -7165,9 +7256,11 @@ spu_program spu_recompiler_base::analyse(const be_t<u32>* ls, u32 entry_point, s
 			v_reg2 = 3,
 		};
 
-		for (auto it = infos.lower_bound(utils::sub_saturate<u32>(pattern.put_pc, 512)); it != infos.end() && it->first < pattern.put_pc + 512; it++)
+		const auto& block_addrs = infos.sorted();
+
+		for (auto it = std::lower_bound(block_addrs.begin(), block_addrs.end(), utils::sub_saturate<u32>(pattern.put_pc, 512)); it != block_addrs.end() && *it < pattern.put_pc + 512; it++)
 		{
-			for (auto& state : it->second->end_reg_state)
+			for (auto& state : infos.at(*it)->end_reg_state)
 			{
 				if (state.is_const() && (state.value & -0x20) == (CELL_SYNC_ERROR_ALIGN & -0x20))
 				{
@@ -7344,9 +7437,75 @@ void spu_recompiler_base::dump(const spu_program& result, std::string& out)
 	out += '\n';
 }
 
+// Compile queue shared by all SPU LLVM workers, ordered by profiler samples
+struct spu_llvm_queue
+{
+	struct entry
+	{
+		u64 old; // Location of the pre-recompiled function to patch
+		const spu_program* prog;
+		const atomic_t<u64>* samples; // Owned by spu_llvm
+		u64 stamp;
+	};
+
+	shared_mutex mutex;
+	std::vector<entry> items;
+
+	// Number of items in queue, workers wait on it
+	atomic_t<u32> pending = 0;
+
+	// Number of items being compiled
+	atomic_t<u32> busy = 0;
+
+	// Metrics (microseconds)
+	atomic_t<u32> compiled = 0;
+	atomic_t<u64> wait_time = 0;
+	atomic_t<u64> wait_time_max = 0;
+	atomic_t<u64> compile_time = 0;
+
+	void push(u64 old, const spu_program* prog, const atomic_t<u64>* samples)
+	{
+		std::lock_guard lock(mutex);
+		items.emplace_back(entry{old, prog, samples, get_system_time()});
+		pending++;
+	}
+
+	// Take the hottest item; whichever worker is idle first gets it
+	std::optional<entry> pop()
+	{
+		std::lock_guard lock(mutex);
+
+		if (items.empty())
+		{
+			return std::nullopt;
+		}
+
+		usz found = 0;
+		u64 sample_max = 0;
+
+		for (usz i = 0; i < items.size(); i++)
+		{
+			const u64 cur = items[i].samples->load();
+
+			// Ties resolve to the oldest item
+			if (cur > sample_max)
+			{
+				sample_max = cur;
+				found = i;
+			}
+		}
+
+		const entry result = items[found];
+		items.erase(items.begin() + found);
+		busy++;
+		pending--;
+		return result;
+	}
+};
+
 struct spu_llvm_worker
 {
-	lf_queue<std::pair<u64, const spu_program*>> registered;
+	spu_llvm_queue* queue;
 
 	void operator()()
 	{
@@ -7358,43 +7517,20 @@ struct spu_llvm_worker
 
 		bool set_relax_flag = false;
 
-		for (auto slice = registered.pop_all();; [&]
-		{
-			if (slice)
-			{
-				slice.pop_front();
-			}
-
-			if (slice || thread_ctrl::state() == thread_state::aborting)
-			{
-				return;
-			}
-
-			if (set_relax_flag)
-			{
-				spu_thread::g_spu_work_count--;
-				set_relax_flag = false;
-			}
-
-			thread_ctrl::wait_on(registered.get_wait_atomic(), 0);
-			slice = registered.pop_all();
-		}())
+		while (thread_ctrl::state() != thread_state::aborting)
 		{
-			auto* prog = slice.get();
-
-			if (thread_ctrl::state() == thread_state::aborting)
-			{
-				break;
-			}
+			const auto prog = queue->pop();
 
 			if (!prog)
 			{
-				continue;
-			}
+				if (set_relax_flag)
+				{
+					spu_thread::g_spu_work_count--;
+					set_relax_flag = false;
+				}
 
-			if (!prog->second)
-			{
-				break;
+				thread_ctrl::wait_on(queue->pending, 0);
+				continue;
 			}
 
 			if (!compiler)
@@ -7412,7 +7548,10 @@ struct spu_llvm_worker
 				set_relax_flag = true;
 			}
 
-			const auto& func = *prog->second;
+			const u64 compile_start = get_system_time();
+			const u64 wait_time = compile_start - prog->stamp;
+
+			const auto& func = *prog->prog;
 
 			// Get data start
 			const u32 start = func.lower_bound;
@@ -7434,7 +7573,7 @@ struct spu_llvm_worker
 			else if (const auto target = compiler->compile(std::move(func2)))
 			{
 				// Redirect old function (TODO: patch in multiple places)
-				const s64 rel = reinterpret_cast<u64>(target) - prog->first - 5;
+				const s64 rel = reinterpret_cast<u64>(target) - prog->old - 5;
 
 				union
 				{
@@ -7448,16 +7587,23 @@ struct spu_llvm_worker
 				bytes[6] = 0x90;
 				bytes[7] = 0x90;
 
-				atomic_storage<u64>::release(*reinterpret_cast<u64*>(prog->first), result);
+				atomic_storage<u64>::release(*reinterpret_cast<u64*>(prog->old), result);
 			}
 			else
 			{
 				spu_log.fatal("[0x%05x] Compilation failed.", func.entry_point);
+				queue->busy--;
 				break;
 			}
 
 			// Clear fake LS
 			std::memset(ls.data() + start / 4, 0, 4 * (size0 - 1));
+
+			queue->compiled++;
+			queue->wait_time += wait_time;
+			queue->wait_time_max.fetch_op([&](u64& v) { v = std::max(v, wait_time); });
+			queue->compile_time += get_system_time() - compile_start;
+			queue->busy--;
 		}
 
 		if (set_relax_flag)
@@ -7474,6 +7620,7 @@ struct spu_llvm
 	// Workload
 	lf_queue<std::pair<const u64, spu_item*>> registered;
 	atomic_ptr<named_thread_group<spu_llvm_worker>> m_workers;
+	spu_llvm_queue m_queue;
 
 	spu_llvm()
 	{
@@ -7499,9 +7646,6 @@ struct spu_llvm
 			return;
 		}
 
-		// To compile (hash -> item)
-		std::unordered_multimap<u64, spu_item*, value_hash<u64>> enqueued;
-
 		// Mini-profiler (hash -> number of occurrences)
 		std::unordered_map<u64, atomic_t<u64>, value_hash<u64>> samples;
 
@@ -7556,121 +7700,67 @@ struct spu_llvm
 			worker_count = 2;
 		}
 
-		u32 worker_index = 0;
-		u32 notify_compile_count = 0;
-		u32 compile_pending = 0;
-		std::vector<u8> notify_compile(worker_count);
+		if (g_cfg.core.llvm_threads)
+		{
+			worker_count = std::min<u32>(worker_count, g_cfg.core.llvm_threads);
+		}
 
-		m_workers = make_single<named_thread_group<spu_llvm_worker>>("SPUW.", worker_count);
+		m_workers = make_single<named_thread_group<spu_llvm_worker>>("SPUW.", worker_count, spu_llvm_worker{&m_queue});
 		auto workers_ptr = m_workers.load();
-		auto& workers = *workers_ptr;
 
 		while (thread_ctrl::state() != thread_state::aborting)
 		{
+			u32 pushed = 0;
+
 			for (const auto& pair : registered.pop_all())
 			{
-				enqueued.emplace(pair);
-
 				// Interrupt and kick profiler thread
 				const auto lock = prof_mutex.init_always([&]{});
 
-				// Register new blocks to collect samples
-				samples.emplace(pair.first, 0);
-			}
-
-			if (enqueued.empty())
-			{
-				// Send pending notifications
-				if (notify_compile_count)
-				{
-					for (usz i = 0; i < worker_count; i++)
-					{
-						if (notify_compile[i])
-						{
-							(workers.begin() + i)->registered.notify();
-						}
-					}
-				}
-
-				// Interrupt profiler thread and put it to sleep
-				static_cast<void>(prof_mutex.reset());
-				thread_ctrl::wait_on(registered.get_wait_atomic(), 0);
-				std::fill(notify_compile.begin(), notify_compile.end(), 0); // Reset notification flags
-				notify_compile_count = 0;
-				compile_pending = 0;
-				continue;
-			}
-
-			// Find the most used enqueued item
-			u64 sample_max = 0;
-			auto found_it  = enqueued.begin();
-
-			for (auto it = enqueued.begin(), end = enqueued.end(); it != end; ++it)
-			{
-				const u64 cur = ::at32(std::as_const(samples), it->first);
+				// Register new blocks to collect samples (node-based container, the address is stable)
+				const auto& counter = samples.emplace(pair.first, 0).first->second;
 
-				if (cur > sample_max)
-				{
-					sample_max = cur;
-					found_it = it;
-				}
+				m_queue.push(reinterpret_cast<u64>(+pair.second->compiled), &pair.second->data, &counter);
+				pushed++;
 			}
 
-			// Start compiling
-			const spu_program& func = found_it->second->data;
-
-			// Old function pointer (pre-recompiled)
-			const spu_function_t _old = found_it->second->compiled;
-
-			// Remove item from the queue
-			enqueued.erase(found_it);
-
-			// Prefer using an inactive thread
-			for (usz i = 0; i < worker_count && !!(workers.begin() + (worker_index % worker_count))->registered; i++)
+			for (u32 i = 0; i < std::min(pushed, worker_count); i++)
 			{
-				worker_index++;
+				m_queue.pending.notify_one();
 			}
 
-			// Push the workload
-			const bool notify = (workers.begin() + (worker_index % worker_count))->registered.template push<false>(reinterpret_cast<u64>(_old), &func);
-
-			if (notify && !notify_compile[worker_index % worker_count])
+			if (m_queue.pending || m_queue.busy)
 			{
-				notify_compile[worker_index % worker_count] = 1;
-				notify_compile_count++;
+				// Keep sampling while there is work in flight, but check back periodically
+				thread_ctrl::wait_on(registered.get_wait_atomic(), 0, 10'000);
+				continue;
 			}
 
-			compile_pending++;
-
-			// Notify all before queue runs out if there is considerable excess
-			// Optimized that: if there are many workers, it acts soon
-			// If there are only a few workers, it postpones notifications until there is some more workload
-			if (notify_compile_count && std::min<u32>(7, utils::aligned_div<u32>(worker_count * 2, 3) + 2) <= compile_pending)
+			if (const u32 count = m_queue.compiled.exchange(0))
 			{
-				for (usz i = 0; i < worker_count; i++)
-				{
-					if (notify_compile[i])
-					{
-						(workers.begin() + i)->registered.notify();
-					}
-				}
+				const u64 wait_time = m_queue.wait_time.exchange(0);
+				const u64 wait_max = m_queue.wait_time_max.exchange(0);
+				const u64 compile_time = m_queue.compile_time.exchange(0);
 
-				std::fill(notify_compile.begin(), notify_compile.end(), 0); // Reset notification flags
-				notify_compile_count = 0;
-				compile_pending = 0;
+				spu_log.notice("SPU LLVM: Compiled %u functions (queue wait: avg %uus, max %uus; compile: avg %uus)", count, wait_time / count, wait_max, compile_time / count);
 			}
 
-			worker_index++;
+			// Interrupt profiler thread and put it to sleep
+			static_cast<void>(prof_mutex.reset());
+			thread_ctrl::wait_on(registered.get_wait_atomic(), 0);
 		}
 
-		static_cast<void>(prof_mutex.init_always([&]{ samples.clear(); }));
-
 		m_workers.reset();
 
 		for (u32 i = 0; i < worker_count; i++)
 		{
-			(workers.begin() + i)->operator=(thread_state::aborting);
+			(workers_ptr->begin() + i)->operator=(thread_state::aborting);
 		}
+
+		// Workers must be stopped before the sample counters they reference are released
+		workers_ptr.reset();
+
+		static_cast<void>(prof_mutex.init_always([&]{ samples.clear(); }));
 	}
 
 	spu_llvm& operator=(thread_state)
@@ -8060,7 +8150,7 @@ std::unique_ptr<spu_recompiler_base> spu_recompiler_base::make_fast_llvm_recompi
 	return std::make_unique<spu_fast>();
 }
 
-std::array<reg_state_t, s_reg_max>& block_reg_info::evaluate_start_state(const std::map<u32, std::unique_ptr<block_reg_info>>& map, bool extensive_evaluation)
+std::array<reg_state_t, s_reg_max>& block_reg_info::evaluate_start_state(const block_reg_info_map& map, bool extensive_evaluation)
 {
 	if (!has_true_state)
 	{
@@ -8096,7 +8186,7 @@ std::array<reg_state_t, s_reg_max>& block_reg_info::evaluate_start_state(const s
 			const auto it = std::addressof(info_queue[qi]);
 			ensure(qi == info_queue.size() - 1);
 
-			auto& cur_node = ::at32(map, it->block_pc);
+			const auto cur_node = map.at(it->block_pc);
 
 			ensure(it->parent_iterator_index == qi - 1);
 
@@ -8154,7 +8244,7 @@ std::array<reg_state_t, s_reg_max>& block_reg_info::evaluate_start_state(const s
 					has_past_state = true;
 
 					const u32 node_pc = it->state_prev[bi].block_pc;
-					const auto& node = ::at32(map, node_pc);
+					const auto node = map.at(node_pc);
 
 					// Check if the node is resolved
 					if (!node->has_true_state)
@@ -8183,7 +8273,7 @@ std::array<reg_state_t, s_reg_max>& block_reg_info::evaluate_start_state(const s
 					}
 
 					std::array<reg_state_t, s_reg_max>* arg_state{};
-					const auto& node = ::at32(map, it->state_prev[bi].block_pc);
+					const auto node = map.at(it->state_prev[bi].block_pc);
 
 					if (node->has_true_state)
 					{
@@ -8260,7 +8350,7 @@ std::array<reg_state_t, s_reg_max>& block_reg_info::evaluate_start_state(const s
 			else
 			{
 				const u32 prev_pc = cur_node->prev_nodes[it->completed++].prev_pc;
-				const auto& prev_node = ::at32(map, prev_pc);
+				const auto prev_node = map.at(prev_pc);
 
 				// Queue for resolving if needed
 				if (!prev_node->has_true_state)
@@ -159,6 +159,224 @@ public:
 	static spu_function_t g_interpreter;
 };
 
+// Map keyed by LS address with a flat index by instruction slot, used by the analyser instead of hash maps
+// Iteration follows insertion order, references remain valid until the element is erased
+// Memory: 256 KB for the index, allocated with the map
+template <typename T>
+class spu_ls_map
+{
+public:
+	using key_type = u32;
+	using mapped_type = T;
+	using value_type = std::pair<u32, T>;
+
+private:
+	// Erased elements are kept in place with this key
+	static constexpr u32 s_erased = umax;
+
+	std::deque<value_type> m_values;
+
+	// Position in m_values + 1 for each instruction slot (0 = none)
+	std::unique_ptr<u32[]> m_index = std::make_unique<u32[]>(SPU_LS_SIZE / 4);
+
+	usz m_size = 0;
+
+	template <typename V, typename It>
+	class iterator_base
+	{
+		It m_it{};
+		It m_end{};
+
+		void skip_erased()
+		{
+			while (m_it != m_end && m_it->first == s_erased)
+			{
+				++m_it;
+			}
+		}
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::remove_const_t<V>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = V*;
+		using reference = V&;
+
+		iterator_base() = default;
+
+		iterator_base(It it, It end)
+			: m_it(it)
+			, m_end(end)
+		{
+			skip_erased();
+		}
+
+		V& operator*() const
+		{
+			return *m_it;
+		}
+
+		V* operator->() const
+		{
+			return std::addressof(*m_it);
+		}
+
+		iterator_base& operator++()
+		{
+			++m_it;
+			skip_erased();
+			return *this;
+		}
+
+		iterator_base operator++(int)
+		{
+			iterator_base old = *this;
+			operator++();
+			return old;
+		}
+
+		bool operator==(const iterator_base& rhs) const
+		{
+			return m_it == rhs.m_it;
+		}
+	};
+
+	static u32 to_slot(u32 addr)
+	{
+		ensure(addr < SPU_LS_SIZE && addr % 4 == 0);
+		return addr / 4;
+	}
+
+	// Returns 0 for addresses which cannot be present
+	u32 lookup(u32 addr) const
+	{
+		return addr < SPU_LS_SIZE && addr % 4 == 0 ? m_index[addr / 4] : 0;
+	}
+
+public:
+	using iterator = iterator_base<value_type, typename std::deque<value_type>::iterator>;
+	using const_iterator = iterator_base<const value_type, typename std::deque<value_type>::const_iterator>;
+
+	spu_ls_map() = default;
+
+	spu_ls_map(const spu_ls_map&) = delete;
+
+	spu_ls_map& operator=(const spu_ls_map&) = delete;
+
+	iterator begin()
+	{
+		return {m_values.begin(), m_values.end()};
+	}
+
+	iterator end()
+	{
+		return {m_values.end(), m_values.end()};
+	}
+
+	const_iterator begin() const
+	{
+		return {m_values.cbegin(), m_values.cend()};
+	}
+
+	const_iterator end() const
+	{
+		return {m_values.cend(), m_values.cend()};
+	}
+
+	usz size() const
+	{
+		return m_size;
+	}
+
+	bool empty() const
+	{
+		return m_size == 0;
+	}
+
+	usz count(u32 addr) const
+	{
+		return lookup(addr) != 0;
+	}
+
+	bool contains(u32 addr) const
+	{
+		return lookup(addr) != 0;
+	}
+
+	iterator find(u32 addr)
+	{
+		const u32 pos = lookup(addr);
+		return pos ? iterator{m_values.begin() + (pos - 1), m_values.end()} : end();
+	}
+
+	const_iterator find(u32 addr) const
+	{
+		const u32 pos = lookup(addr);
+		return pos ? const_iterator{m_values.cbegin() + (pos - 1), m_values.cend()} : end();
+	}
+
+	template <typename... Args>
+	std::pair<iterator, bool> emplace(u32 addr, Args&&... args)
+	{
+		u32& pos = m_index[to_slot(addr)];
+
+		if (pos)
+		{
+			return {iterator{m_values.begin() + (pos - 1), m_values.end()}, false};
+		}
+
+		m_values.emplace_back(std::piecewise_construct, std::forward_as_tuple(addr), std::forward_as_tuple(std::forward<Args>(args)...));
+		pos = ::size32(m_values);
+		m_size++;
+		return {iterator{m_values.end() - 1, m_values.end()}, true};
+	}
+
+	T& operator[](u32 addr)
+	{
+		return emplace(addr).first->second;
+	}
+
+	usz erase(u32 addr)
+	{
+		if (!lookup(addr))
+		{
+			return 0;
+		}
+
+		u32& pos = m_index[addr / 4];
+
+		auto& value = m_values[pos - 1];
+		value.first = s_erased;
+		value.second = T{};
+		pos = 0;
+		m_size--;
+		return 1;
+	}
+
+	iterator erase(iterator it)
+	{
+		const iterator next = std::next(it);
+		erase(it->first);
+		return next;
+	}
+
+	void clear()
+	{
+		for (const auto& [addr, _] : m_values)
+		{
+			if (addr != s_erased)
+			{
+				m_index[addr / 4] = 0;
+			}
+		}
+
+		m_values.clear();
+		m_size = 0;
+	}
+};
+
+struct block_reg_info_map;
+
 // SPU Recompiler instance base class
 class spu_recompiler_base
 {
@@ -291,10 +509,10 @@ protected:
 	std::bitset<0x10000> m_use_rc;
 
 	// List of possible targets for the instruction (entry shouldn't exist for simple instructions)
-	std::unordered_map<u32, std::vector<u32>, value_hash<u32, 2>> m_targets;
+	spu_ls_map<std::vector<u32>> m_targets;
 
 	// List of block predecessors
-	std::unordered_map<u32, std::vector<u32>, value_hash<u32, 2>> m_preds;
+	spu_ls_map<std::vector<u32>> m_preds;
 
 	// List of function entry points and return points (set after BRSL, BRASL, BISL, BISLED)
 	std::bitset<0x10000> m_entry_info;
@@ -411,6 +629,9 @@ private:
 	// For private use
 	std::vector<u32> workload;
 
+	// Register state of the blocks, reused between analyses
+	std::unique_ptr<block_reg_info_map> m_reg_infos;
+
 public:
 	spu_recompiler_base();
 
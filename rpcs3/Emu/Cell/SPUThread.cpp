@@ -4,6 +4,7 @@
 #include "Emu/Memory/vm.h"
 #include "Emu/Memory/vm_ptr.h"
 #include "Emu/Memory/vm_reservation.h"
+#include "Emu/Memory/vm_reservation_stats.h"
 
 #include "Loader/ELF.h"
 #include "Emu/VFS.h"
@@ -707,6 +708,7 @@ const auto spu_putllc_tx = build_function_asm<u64(*)(u32 raddr, u64 rtime, void*
 	Label tx1 = build_transaction_enter(c, fall, [&]()
 	{
 		c.add(x86::qword_ptr(args[2], ::offset32(&spu_thread::ftx) - ::offset32(&spu_thread::rdata)), 1);
+		c.or_(x86::dword_ptr(args[2], ::offset32(&spu_thread::ftx_status) - ::offset32(&spu_thread::rdata)), x86::eax);
 		build_get_tsc(c);
 		c.sub(x86::rax, stamp0);
 		c.movabs(x86::rbx, reinterpret_cast<u64>(&g_rtm_tx_limit2));
@@ -3799,6 +3801,27 @@ bool spu_thread::do_putllc(const spu_mfc_cmd& args)
 	// Store conditionally
 	const u32 addr = args.eal & -128;
 
+	const bool sample_stats = vm::reservation_stats_sample();
+	const u64 ftx0 = ftx;
+
+	if (sample_stats) [[unlikely]]
+	{
+		ftx_status = 0;
+	}
+
+	const auto record_stats = [&](bool success)
+	{
+		vm::reservation_stats_record(vm::reservation_sample{
+			.addr = addr,
+			.pc = pc,
+			.cpu_id = id,
+			.event = success ? vm::reservation_event::store_success : vm::reservation_event::store_failure,
+			.tx_aborts = static_cast<u32>(ftx - ftx0),
+			.tx_status = ftx_status,
+			.waiters = vm::reservation_notifier_count(addr),
+		});
+	};
+
 	if ([&]()
 	{
 		perf_meter<"PUTLLC."_u64> perf2 = perf0;
@@ -3997,11 +4020,21 @@ bool spu_thread::do_putllc(const spu_mfc_cmd& args)
 			raddr = 0;
 		}
 
+		if (sample_stats) [[unlikely]]
+		{
+			record_stats(true);
+		}
+
 		perf0.reset();
 		return true;
 	}
 	else
 	{
+		if (sample_stats) [[unlikely]]
+		{
+			record_stats(false);
+		}
+
 		if (raddr)
 		{
 			// Last check for event before we clear the reservation
@@ -4993,8 +5026,13 @@ bool spu_thread::process_mfc_cmd()
 		u64 ntime = 0;
 		rsx::reservation_lock rsx_lock(addr, 128);
 
+		const u64 stats_tsc = vm::reservation_stats_sample() ? utils::get_tsc() : 0;
+		u64 stats_retries = 0;
+
 		for (u64 i = 0; i != umax; [&]()
 		{
+			stats_retries++;
+
 			if (state & cpu_flag::pause)
 			{
 				auto& sdata = *vm::get_super_ptr<spu_rdata_t>(addr);
@@ -5077,6 +5115,18 @@ bool spu_thread::process_mfc_cmd()
 		rtime = ntime;
 		mov_rdata(_ref<spu_rdata_t>(ch_mfc_cmd.lsa & 0x3ff80), rdata);
 
+		if (stats_tsc) [[unlikely]]
+		{
+			vm::reservation_stats_record(vm::reservation_sample{
+				.addr = addr,
+				.pc = pc,
+				.cpu_id = id,
+				.event = vm::reservation_event::load,
+				.retries = static_cast<u32>(stats_retries),
+				.ticks = utils::get_tsc() - stats_tsc,
+			});
+		}
+
 		ch_atomic_stat.set_value(MFC_GETLLAR_SUCCESS);
 
 		if (g_cfg.core.mfc_debug)
@@ -6108,6 +6158,10 @@ s64 spu_thread::get_ch_value(u32 ch)
 
 			eventstat_busy_waiting_switch = value ? 1 : 0;
 		}
+
+		const u32 stats_raddr = is_LR_wait && vm::reservation_stats_sample() ? raddr : 0;
+		const u64 stats_tsc = stats_raddr ? utils::get_tsc() : 0;
+		const bool stats_busy_wait = eventstat_busy_waiting_switch == 1;
 		
 		for (bool is_first = true; !events.count; events = get_events(mask1 & ~SPU_EVENT_LR, true, true), is_first = false)
 		{
@@ -6371,6 +6425,19 @@ s64 spu_thread::get_ch_value(u32 ch)
 
 		deregister_cache_line_waiter(cache_line_waiter_index);
 
+		if (stats_raddr) [[unlikely]]
+		{
+			vm::reservation_stats_record(vm::reservation_sample{
+				.addr = stats_raddr,
+				.pc = pc,
+				.cpu_id = id,
+				.event = vm::reservation_event::lr_wait,
+				.busy_wait = stats_busy_wait,
+				.waiters = vm::reservation_notifier_count(stats_raddr),
+				.ticks = utils::get_tsc() - stats_tsc,
+			});
+		}
+
 		wakeup_delay();
 
 		if (is_paused(state - cpu_flag::suspend))
@@ -792,6 +792,7 @@ public:
 
 	u64 ftx = 0; // Failed transactions
 	u64 stx = 0; // Succeeded transactions (pure counters)
+	u32 ftx_status = 0; // Combined abort status of failed transactions
 
 	u64 last_ftsc = 0;
 	u64 last_ftime = 0;
@@ -1250,6 +1250,9 @@ error_code sys_net_bnet_close(ppu_thread& ppu, s32 s)
 		sock.reset();
 	}
 
+	// Let the network thread release its reference as well
+	g_fxo->get<network_context>().wake_poller();
+
 	return CELL_OK;
 }
 
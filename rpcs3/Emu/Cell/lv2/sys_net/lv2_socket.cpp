@@ -78,6 +78,9 @@ void lv2_socket::poll_queue(shared_ptr<ppu_thread> ppu, bs_t<lv2_socket::poll_t>
 		{
 			nc.num_polls.notify_one();
 		}
+
+		// Update the native poll set now rather than on the next event
+		nc.wake_poller();
 	}
 }
 
@@ -114,6 +117,12 @@ u32 lv2_socket::clear_queue(ppu_thread* ppu)
 	return cleared;
 }
 
+// Waiters with a timeout need to be checked periodically even without native events
+bool lv2_socket::has_timed_waiters() const
+{
+	return !queue.empty() && (so_rcvtimeo || so_sendtimeo);
+}
+
 void lv2_socket::handle_events(const pollfd& native_pfd, [[maybe_unused]] bool unset_connecting)
 {
 	bs_t<lv2_socket::poll_t> events_happening{};
@@ -125,7 +134,7 @@ void lv2_socket::handle_events(const pollfd& native_pfd, [[maybe_unused]] bool u
 	if (native_pfd.revents & POLLERR && events.test_and_reset(lv2_socket::poll_t::error))
 		events_happening += lv2_socket::poll_t::error;
 
-	if (events_happening || (!queue.empty() && (so_rcvtimeo || so_sendtimeo)))
+	if (events_happening || has_timed_waiters())
 	{
 		std::lock_guard lock(mutex);
 #ifdef _WIN32
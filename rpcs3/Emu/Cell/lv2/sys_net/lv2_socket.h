@@ -69,6 +69,7 @@ public:
 	void set_poll_event(bs_t<poll_t> event);
 	void poll_queue(shared_ptr<ppu_thread> ppu, bs_t<poll_t> event, std::function<bool(bs_t<poll_t>)> poll_cb);
 	u32 clear_queue(ppu_thread*);
+	bool has_timed_waiters() const;
 	void handle_events(const pollfd& native_fd, bool unset_connecting = false);
 	void queue_wake(ppu_thread* ppu);
 
@@ -6,6 +6,11 @@
 #include "network_context.h"
 #include "sys_net_helpers.h"
 
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
 LOG_CHANNEL(sys_net);
 
 // Used by RPCN to send signaling packets to RPCN server(for UDP hole punching)
@@ -123,6 +128,61 @@ namespace np
 	void init_np_handler_dependencies();
 }
 
+base_network_thread::base_network_thread()
+{
+#ifdef __linux__
+	epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+	wakeup_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	::epoll_event event{EPOLLIN, {}};
+	event.data.fd = wakeup_fd;
+	ensure(epoll_fd >= 0 && wakeup_fd >= 0 && ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wakeup_fd, &event) == 0);
+#endif
+}
+
+base_network_thread::~base_network_thread()
+{
+#ifdef __linux__
+	::close(epoll_fd);
+	::close(wakeup_fd);
+#endif
+}
+
+void base_network_thread::wake_poller()
+{
+#ifdef __linux__
+	const u64 value = 1;
+	[[maybe_unused]] const auto nwritten = ::write(wakeup_fd, &value, sizeof(value));
+#endif
+}
+
+#ifdef __linux__
+bool base_network_thread::is_socket_event(const ::epoll_event& event) const
+{
+	if (event.data.fd != wakeup_fd)
+	{
+		return true;
+	}
+
+	u64 value{};
+	[[maybe_unused]] const auto nread = ::read(wakeup_fd, &value, sizeof(value));
+	return false;
+}
+
+// Translate epoll events to poll events for lv2_socket::handle_events
+static ::pollfd epoll_to_pollfd(const ::epoll_event& event)
+{
+	::pollfd pfd{};
+	pfd.fd = event.data.fd;
+	pfd.revents = static_cast<short>(
+		(event.events & EPOLLIN ? POLLIN : 0) |
+		(event.events & EPOLLOUT ? POLLOUT : 0) |
+		(event.events & EPOLLERR ? POLLERR : 0) |
+		(event.events & EPOLLHUP ? POLLHUP : 0));
+	return pfd;
+}
+#endif
+
 void base_network_thread::add_ppu_to_awake(ppu_thread* ppu)
 {
 	std::lock_guard lock(mutex_ppu_to_awake);
@@ -168,6 +228,26 @@ p2p_thread::p2p_thread()
 	np::init_np_handler_dependencies();
 }
 
+network_thread& network_thread::operator=(thread_state s) noexcept
+{
+	if (s == thread_state::aborting)
+	{
+		wake_poller();
+	}
+
+	return *this;
+}
+
+p2p_thread& p2p_thread::operator=(thread_state s) noexcept
+{
+	if (s == thread_state::aborting)
+	{
+		wake_poller();
+	}
+
+	return *this;
+}
+
 void p2p_thread::bind_sce_np_port()
 {
 	std::lock_guard list_lock(list_p2p_ports_mutex);
@@ -176,14 +256,76 @@ void p2p_thread::bind_sce_np_port()
 
 void network_thread::operator()()
 {
-	std::vector<shared_ptr<lv2_socket>> socklist;
-	socklist.reserve(lv2_socket::id_count);
-
 	{
 		std::lock_guard lock(mutex_ppu_to_awake);
 		ppu_to_awake.clear();
 	}
 
+#ifdef __linux__
+	std::vector<::epoll_event> ready(lv2_socket::id_count + 1);
+
+	while (thread_ctrl::state() != thread_state::aborting)
+	{
+		if (!num_polls)
+		{
+			// Don't keep references to sockets while idle
+			clear_epoll_set();
+
+			thread_ctrl::wait_on(num_polls, 0);
+			continue;
+		}
+
+		update_epoll_set();
+
+		// New waiters interrupt the wait, only sockets with timeouts need the 1ms tick
+		const bool has_timed = std::any_of(epoll_sockets.begin(), epoll_sockets.end(), [](const auto& entry) { return entry.second.timed; });
+		const int count = ::epoll_wait(epoll_fd, ready.data(), ::size32(ready), has_timed ? 1 : -1);
+
+		if (count < 0 && errno != EINTR)
+		{
+			sys_net.error("[Network Thread] epoll_wait failed: %s", get_last_error(false));
+		}
+
+		std::lock_guard lock(mutex_thread_loop);
+
+		for (auto& [fd, entry] : epoll_sockets)
+		{
+			entry.seen = false;
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			if (!is_socket_event(ready[i]))
+			{
+				continue;
+			}
+
+			if (const auto found = epoll_sockets.find(ready[i].data.fd); found != epoll_sockets.end())
+			{
+				found->second.seen = true;
+				found->second.sock->handle_events(epoll_to_pollfd(ready[i]));
+			}
+		}
+
+		for (auto& [fd, entry] : epoll_sockets)
+		{
+			if (entry.timed && !entry.seen)
+			{
+				// Let waiters check for their timeout
+				::pollfd pfd{};
+				pfd.fd = fd;
+				entry.sock->handle_events(pfd);
+			}
+		}
+
+		wake_threads();
+	}
+
+	clear_epoll_set();
+#else
+	std::vector<shared_ptr<lv2_socket>> socklist;
+	socklist.reserve(lv2_socket::id_count);
+
 	std::vector<::pollfd> fds(lv2_socket::id_count);
 #ifdef _WIN32
 	std::vector<bool> connecting(lv2_socket::id_count);
@@ -247,14 +389,123 @@ void network_thread::operator()()
 #endif
 		}
 	}
+#endif
 }
 
+#ifdef __linux__
+void network_thread::update_epoll_set()
+{
+	std::lock_guard lock(mutex_thread_loop);
+
+	for (auto& [fd, entry] : epoll_sockets)
+	{
+		entry.seen = false;
+	}
+
+	// Obtain all native sockets with waiters
+	idm::select<lv2_socket>([&](u32 id, lv2_socket& s)
+	{
+		if (s.get_type() != SYS_NET_SOCK_DGRAM && s.get_type() != SYS_NET_SOCK_STREAM)
+		{
+			return;
+		}
+
+		const auto events = s.get_events();
+		const u32 native_events =
+			(events & lv2_socket::poll_t::read ? EPOLLIN : 0) |
+			(events & lv2_socket::poll_t::write ? EPOLLOUT : 0);
+		const bool timed = s.has_timed_waiters();
+		const int fd = s.get_socket();
+
+		// Closed sockets have no native socket
+		if ((!native_events && !timed) || fd <= 0)
+		{
+			return;
+		}
+
+		epoll_entry& entry = epoll_sockets[fd];
+
+		if (entry.sock.get() != &s)
+		{
+			// New socket or native socket reused after close (the previous registration is gone with it)
+			entry.sock = idm::get_unlocked<lv2_socket>(id);
+			entry.events = 0;
+		}
+
+		entry.seen = true;
+		entry.timed = timed;
+
+		if (entry.events == native_events)
+		{
+			return;
+		}
+
+		::epoll_event event{native_events, {}};
+		event.data.fd = fd;
+
+		const int op = !entry.events ? EPOLL_CTL_ADD : !native_events ? EPOLL_CTL_DEL : EPOLL_CTL_MOD;
+
+		if (::epoll_ctl(epoll_fd, op, fd, &event) != 0)
+		{
+			sys_net.error("[Network Thread] epoll_ctl(op=%d, fd=%d, events=0x%x) failed: %s", op, fd, native_events, get_last_error(false));
+			entry.events = 0;
+			return;
+		}
+
+		entry.events = native_events;
+	});
+
+	// Drop sockets nobody waits on anymore
+	for (auto it = epoll_sockets.begin(); it != epoll_sockets.end();)
+	{
+		if (it->second.seen)
+		{
+			it++;
+			continue;
+		}
+
+		if (it->second.events)
+		{
+			// May fail harmlessly if the native socket has been closed
+			::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->first, nullptr);
+		}
+
+		it = epoll_sockets.erase(it);
+	}
+}
+
+void network_thread::clear_epoll_set()
+{
+	std::lock_guard lock(mutex_thread_loop);
+
+	for (const auto& [fd, entry] : epoll_sockets)
+	{
+		if (entry.events)
+		{
+			::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+		}
+	}
+
+	epoll_sockets.clear();
+}
+#endif
+
 // Must be used under list_p2p_ports_mutex lock!
 void p2p_thread::create_p2p_port(u16 p2p_port)
 {
 	if (!list_p2p_ports.contains(p2p_port))
 	{
-		list_p2p_ports.emplace(std::piecewise_construct, std::forward_as_tuple(p2p_port), std::forward_as_tuple(p2p_port));
+		const auto& [it, _] = list_p2p_ports.emplace(std::piecewise_construct, std::forward_as_tuple(p2p_port), std::forward_as_tuple(p2p_port));
+
+#ifdef __linux__
+		::epoll_event event{EPOLLIN, {}};
+		event.data.fd = it->second.p2p_socket;
+
+		if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, event.data.fd, &event) != 0)
+		{
+			sys_net.error("[P2P] Failed to add P2P socket of port %d to the epoll set: %s", p2p_port, get_last_error(false));
+		}
+#endif
 		const u32 prev_value = num_p2p_ports.fetch_add(1);
 		if (!prev_value)
 		{
@@ -265,6 +516,53 @@ void p2p_thread::create_p2p_port(u16 p2p_port)
 
 void p2p_thread::operator()()
 {
+#ifdef __linux__
+	std::vector<::epoll_event> ready(64);
+
+	while (thread_ctrl::state() != thread_state::aborting)
+	{
+		if (!num_p2p_ports)
+		{
+			thread_ctrl::wait_on(num_p2p_ports, 0);
+			continue;
+		}
+
+		// P2P sockets are registered in the epoll set on creation
+		const int count = ::epoll_wait(epoll_fd, ready.data(), ::size32(ready), -1);
+
+		if (count < 0)
+		{
+			if (errno != EINTR)
+			{
+				sys_net.error("[P2P] epoll_wait failed: %s", get_last_error(false));
+			}
+
+			continue;
+		}
+
+		std::lock_guard lock(list_p2p_ports_mutex);
+
+		for (int i = 0; i < count; i++)
+		{
+			if (!is_socket_event(ready[i]))
+			{
+				continue;
+			}
+
+			for (auto& [_, p2p_port] : list_p2p_ports)
+			{
+				if (p2p_port.p2p_socket == ready[i].data.fd)
+				{
+					while (p2p_port.recv_data())
+						;
+					break;
+				}
+			}
+		}
+
+		wake_threads();
+	}
+#else
 	std::vector<::pollfd> p2p_fd(lv2_socket::id_count);
 
 	while (thread_ctrl::state() != thread_state::aborting)
@@ -326,4 +624,5 @@ void p2p_thread::operator()()
 			sys_net.error("[P2P] Error poll on master P2P socket: %d", get_last_error(false));
 		}
 	}
+#endif
 }
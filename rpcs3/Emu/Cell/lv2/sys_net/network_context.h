@@ -2,13 +2,23 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include "Utilities/mutex.h"
 #include "Emu/Cell/PPUThread.h"
 
 #include "nt_p2p_port.h"
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
 struct base_network_thread
 {
+	base_network_thread();
+	~base_network_thread();
+
+	base_network_thread(const base_network_thread&) = delete;
+
 	void add_ppu_to_awake(ppu_thread* ppu);
 	void del_ppu_to_awake(ppu_thread* ppu);
 
@@ -16,6 +26,18 @@ struct base_network_thread
 	std::vector<ppu_thread*> ppu_to_awake;
 
 	void wake_threads();
+
+	// Interrupt the wait on native sockets (new waiters or thread abort)
+	void wake_poller();
+
+#ifdef __linux__
+	// Persistent epoll set of native sockets, wakeup_fd (eventfd) is always part of it
+	int epoll_fd = -1;
+	int wakeup_fd = -1;
+
+	// Returns false if the wakeup event was reset instead
+	bool is_socket_event(const ::epoll_event& event) const;
+#endif
 };
 
 struct network_thread : base_network_thread
@@ -26,6 +48,26 @@ struct network_thread : base_network_thread
 	static constexpr auto thread_name = "Network Thread";
 
 	void operator()();
+
+	network_thread& operator=(thread_state s) noexcept;
+
+#ifdef __linux__
+private:
+	struct epoll_entry
+	{
+		shared_ptr<lv2_socket> sock;
+		u32 events = 0; // Events registered in the epoll set
+		bool timed = false; // Has waiters with a timeout
+		bool seen = false;
+	};
+
+	// Registered sockets by native socket
+	std::unordered_map<int, epoll_entry> epoll_sockets;
+
+	// Synchronize the epoll set with the events lv2 waiters are polling for
+	void update_epoll_set();
+	void clear_epoll_set();
+#endif
 };
 
 struct p2p_thread : base_network_thread
@@ -42,6 +84,8 @@ struct p2p_thread : base_network_thread
 
 	void bind_sce_np_port();
 	void operator()();
+
+	p2p_thread& operator=(thread_state s) noexcept;
 };
 
 using network_context = named_thread<network_thread>;
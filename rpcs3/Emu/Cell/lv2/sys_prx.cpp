@@ -10,16 +10,19 @@
 
 #include "Emu/Cell/PPUThread.h"
 #include "Emu/Cell/ErrorCodes.h"
+#include "Emu/Cell/timers.hpp"
 #include "Crypto/unedat.h"
 #include "Utilities/StrUtil.h"
 #include "sys_fs.h"
 #include "sys_process.h"
 #include "sys_memory.h"
+#include "util/sysinfo.hpp"
 #include <span>
 
 extern void dump_executable(std::span<const u8> data, const ppu_module<lv2_obj>* _module, std::string_view title_id);
 
 extern shared_ptr<lv2_prx> ppu_load_prx(const ppu_prx_object&, bool virtual_load, const std::string&, s64, utils::serial* = nullptr);
+extern shared_ptr<lv2_prx> ppu_load_prx(const ppu_prx_object&, bool virtual_load, const std::string&, s64, utils::serial*, std::function<void()>* deferred_analysis);
 extern void ppu_unload_prx(const lv2_prx& prx);
 extern bool ppu_initialize(const ppu_module<lv2_obj>&, bool check_only = false, u64 file_size = 0);
 extern void ppu_finalize(const ppu_module<lv2_obj>& info, bool force_mem_release = false);
@@ -177,7 +180,27 @@ extern const std::map<std::string_view, int> g_prx_list
 
 bool ppu_register_library_lock(std::string_view libname, bool lock_lib);
 
-static error_code prx_load_module(const std::string& vpath, u64 flags, vm::ptr<sys_prx_load_module_option_t> /*pOpt*/, fs::file src = {}, s64 file_offset = 0)
+namespace
+{
+	// Module loaded by _sys_prx_load_module and _sys_prx_load_module_list
+	struct prx_load_request
+	{
+		std::string vpath;
+		std::string path;
+		std::string name;
+		s64 file_offset = 0;
+		bool is_firmware_sprx = false;
+		bool hle = false;
+		fs::file src;
+		std::vector<u8> src_data;
+		ppu_prx_object obj;
+		shared_ptr<lv2_prx> prx;
+		std::function<void()> analyse;
+		u32 id = 0;
+	};
+}
+
+static error_code prx_check_load_flags(u64 flags)
 {
 	if (flags != 0)
 	{
@@ -194,23 +217,29 @@ static error_code prx_load_module(const std::string& vpath, u64 flags, vm::ptr<s
 		fmt::throw_exception("sys_prx: Unimplemented fixed address allocations");
 	}
 
+	return CELL_OK;
+}
+
+// Resolve the path, choose between HLE and LLE and open the file
+static error_code prx_load_open(prx_load_request& req)
+{
 	std::string vpath0;
-	std::string path = vfs::get(vpath, nullptr, &vpath0);
-	std::string name = vpath0.substr(vpath0.find_last_of('/') + 1);
+	req.path = vfs::get(req.vpath, nullptr, &vpath0);
+	req.name = vpath0.substr(vpath0.find_last_of('/') + 1);
 
 	bool ignore = false;
 
 	constexpr std::string_view firmware_sprx_dir = "/dev_flash/sys/external/";
-	const bool is_firmware_sprx = vpath0.starts_with(firmware_sprx_dir) && g_prx_list.count(std::string_view(vpath0).substr(firmware_sprx_dir.size()));
+	req.is_firmware_sprx = vpath0.starts_with(firmware_sprx_dir) && g_prx_list.count(std::string_view(vpath0).substr(firmware_sprx_dir.size()));
 
-	if (is_firmware_sprx)
+	if (req.is_firmware_sprx)
 	{
-		if (g_cfg.core.libraries_control.get_set().count(name + ":lle"))
+		if (g_cfg.core.libraries_control.get_set().count(req.name + ":lle"))
 		{
 			// Force LLE
 			ignore = false;
 		}
-		else if (g_cfg.core.libraries_control.get_set().count(name + ":hle"))
+		else if (g_cfg.core.libraries_control.get_set().count(req.name + ":hle"))
 		{
 			// Force HLE
 			ignore = true;
@@ -218,7 +247,7 @@ static error_code prx_load_module(const std::string& vpath, u64 flags, vm::ptr<s
 		else
 		{
 			// Use list
-			ignore = ::at32(g_prx_list, name) != 0;
+			ignore = ::at32(g_prx_list, req.name) != 0;
 		}
 	}
 	else if (vpath0.starts_with("/"))
@@ -228,79 +257,247 @@ static error_code prx_load_module(const std::string& vpath, u64 flags, vm::ptr<s
 		ignore = g_prx_list.count(vpath0) && ::at32(g_prx_list, vpath0);
 	}
 
-	auto hle_load = [&]()
-	{
-		const auto prx = idm::make_ptr<lv2_obj, lv2_prx>();
-
-		prx->name = std::move(name);
-		prx->path = std::move(path);
-
-		sys_prx.warning("Ignored module: \"%s\" (id=0x%x)", vpath, idm::last_id());
-
-		return not_an_error(idm::last_id());
-	};
-
 	if (ignore)
 	{
-		return hle_load();
+		req.hle = true;
+		return CELL_OK;
 	}
 
-	if (!src)
+	if (!req.src)
 	{
-		auto [fs_error, ppath, path0, lv2_file, type] = lv2_file::open(vpath, 0, 0);
+		auto [fs_error, ppath, path0, lv2_file, type] = lv2_file::open(req.vpath, 0, 0);
 
 		if (fs_error)
 		{
-			if (fs_error + 0u == CELL_ENOENT && is_firmware_sprx)
+			if (fs_error + 0u == CELL_ENOENT && req.is_firmware_sprx)
 			{
-				sys_prx.error("firmware SPRX not found: \"%s\" (forcing HLE implementation)", vpath, idm::last_id());
-				return hle_load();
+				sys_prx.error("firmware SPRX not found: \"%s\" (forcing HLE implementation)", req.vpath);
+				req.hle = true;
+				return CELL_OK;
 			}
 
-			return {fs_error, vpath};
+			return {fs_error, req.vpath};
 		}
 
-		src = std::move(lv2_file);
+		req.src = std::move(lv2_file);
 	}
 
-	u128 klic = g_fxo->get<loaded_npdrm_keys>().last_key();
+	return CELL_OK;
+}
 
-	src = decrypt_self(std::move(src), reinterpret_cast<u8*>(&klic));
+// Decrypt and parse the file (doesn't touch the emulated state, may run on any thread)
+static void prx_load_decrypt(prx_load_request& req, u128 klic)
+{
+	if (req.hle)
+	{
+		return;
+	}
+
+	fs::file src = decrypt_self(std::move(req.src), reinterpret_cast<u8*>(&klic));
 
 	if (!src)
+	{
+		return;
+	}
+
+	if (g_cfg.core.ppu_debug)
+	{
+		req.src_data = src.to_vector<u8>();
+	}
+
+	req.obj = std::move(src);
+}
+
+// Allocate memory, relocate and link the module (the analysis is returned in req.analyse)
+static error_code prx_load_link(prx_load_request& req)
+{
+	if (req.hle)
+	{
+		const auto prx = idm::make_ptr<lv2_obj, lv2_prx>();
+
+		prx->name = std::move(req.name);
+		prx->path = std::move(req.path);
+
+		req.id = idm::last_id();
+		sys_prx.warning("Ignored module: \"%s\" (id=0x%x)", req.vpath, req.id);
+		return CELL_OK;
+	}
+
+	// Not opened: decryption failed
+	if (req.obj == elf_error::stream)
 	{
 		return {CELL_PRX_ERROR_UNSUPPORTED_PRX_TYPE, +"Failed to decrypt file"};
 	}
 
-	const auto src_data = g_cfg.core.ppu_debug ? src.to_vector<u8>() : std::vector<u8>{};
+	if (req.obj != elf_error::ok)
+	{
+		return {CELL_PRX_ERROR_UNSUPPORTED_PRX_TYPE, req.obj.get_error()};
+	}
 
-	ppu_prx_object obj = std::move(src);
-	src.close();
+	req.prx = ppu_load_prx(req.obj, false, req.path, req.file_offset, nullptr, &req.analyse);
 
-	if (obj != elf_error::ok)
+	if (!req.prx)
 	{
-		return {CELL_PRX_ERROR_UNSUPPORTED_PRX_TYPE, obj.get_error()};
+		if (g_cfg.core.ppu_debug)
+		{
+			dump_executable({req.src_data.data(), req.src_data.size()}, nullptr, Emu.GetTitleID());
+		}
+
+		return CELL_PRX_ERROR_ILLEGAL_LIBRARY;
 	}
 
-	const auto prx = ppu_load_prx(obj, false, path, file_offset);
+	req.id = idm::last_id();
+	return CELL_OK;
+}
+
+// Finish loading after the analysis
+static void prx_load_initialize(prx_load_request& req)
+{
+	if (!req.prx)
+	{
+		return;
+	}
 
 	if (g_cfg.core.ppu_debug)
 	{
-		dump_executable({src_data.data(), src_data.size()}, prx.get(), Emu.GetTitleID());
+		dump_executable({req.src_data.data(), req.src_data.size()}, req.prx.get(), Emu.GetTitleID());
 	}
 
-	obj.clear();
+	req.obj.clear();
+	req.src_data = {};
 
-	if (!prx)
+	ppu_initialize(*req.prx);
+
+	sys_prx.success("Loaded module: \"%s\" (id=0x%x)", req.vpath, req.id);
+}
+
+// Run func(req) for every request, in parallel if there are multiple LLE modules
+template <typename F>
+static void prx_load_for_each(std::vector<prx_load_request>& list, std::string_view thread_name, F func)
+{
+	const usz lle_count = std::count_if(list.begin(), list.end(), [](const prx_load_request& req) { return !req.hle; });
+
+	if (lle_count <= 1)
 	{
-		return CELL_PRX_ERROR_ILLEGAL_LIBRARY;
+		for (auto& req : list)
+		{
+			func(req);
+		}
+
+		return;
+	}
+
+	atomic_t<usz> next = 0;
+
+	auto worker = [&]()
+	{
+		for (usz i = next++; i < list.size(); i = next++)
+		{
+			func(list[i]);
+		}
+	};
+
+	const u32 thread_count = std::min<u32>(task_pool::get_thread_limit(), ::narrow<u32>(lle_count));
+
+	// The calling thread participates as well (the guest is waiting for the modules anyway)
+	const auto job = task_pool::submit(thread_name, thread_count - 1, task_priority::high, [&](task_job&, u32)
+	{
+		worker();
+	});
+
+	worker();
+	job->join();
+}
+
+// Load modules in order: decryption and analysis run in parallel, linking and initialization in list order
+static error_code prx_load_modules(std::vector<prx_load_request>& list)
+{
+	const u64 start_time = get_system_time();
+
+	for (auto& req : list)
+	{
+		if (error_code result = prx_load_open(req); result < 0)
+		{
+			// Nothing to unload
+			list.clear();
+			return result;
+		}
+	}
+
+	const u128 klic = g_fxo->get<loaded_npdrm_keys>().last_key();
+
+	prx_load_for_each(list, "PRX Decrypt", [&](prx_load_request& req)
+	{
+		prx_load_decrypt(req, klic);
+	});
+
+	const u64 decrypt_time = get_system_time();
+
+	error_code result = CELL_OK;
+	usz linked = 0;
+
+	for (; linked < list.size(); linked++)
+	{
+		if (result = prx_load_link(list[linked]); result < 0)
+		{
+			break;
+		}
+	}
+
+	const u64 link_time = get_system_time();
+
+	prx_load_for_each(list, "PRX Analyser", [](prx_load_request& req)
+	{
+		if (req.analyse)
+		{
+			req.analyse();
+			req.analyse = {};
+		}
+	});
+
+	const u64 analyse_time = get_system_time();
+
+	// Initialize linked modules even if a later one failed, they are unloaded by the caller
+	for (usz i = 0; i < linked; i++)
+	{
+		prx_load_initialize(list[i]);
+	}
+
+	if (list.size() > 1)
+	{
+		const u64 end_time = get_system_time();
+		sys_prx.notice("Loaded %u module(s) in %.3fs (decrypt: %.3fs, link: %.3fs, analysis: %.3fs, initialize: %.3fs)", linked, (end_time - start_time) / 1000000.,
+			(decrypt_time - start_time) / 1000000., (link_time - decrypt_time) / 1000000., (analyse_time - link_time) / 1000000., (end_time - analyse_time) / 1000000.);
 	}
 
-	ppu_initialize(*prx);
+	if (result < 0)
+	{
+		// Keep only the modules to unload
+		list.resize(linked);
+		return result;
+	}
+
+	return CELL_OK;
+}
 
-	sys_prx.success("Loaded module: \"%s\" (id=0x%x)", vpath, idm::last_id());
+static error_code prx_load_module(const std::string& vpath, u64 flags, vm::ptr<sys_prx_load_module_option_t> /*pOpt*/, fs::file src = {}, s64 file_offset = 0)
+{
+	if (error_code result = prx_check_load_flags(flags); result < 0)
+	{
+		return result;
+	}
 
-	return not_an_error(idm::last_id());
+	std::vector<prx_load_request> list(1);
+	list[0].vpath = vpath;
+	list[0].src = std::move(src);
+	list[0].file_offset = file_offset;
+
+	if (error_code result = prx_load_modules(list); result < 0)
+	{
+		return result;
+	}
+
+	return not_an_error(list[0].id);
 }
 
 fs::file make_file_view(fs::file&& file, u64 offset, u64 size);
@@ -437,41 +634,36 @@ error_code _sys_prx_load_module_on_memcontainer_by_fd(ppu_thread& ppu, s32 fd, u
 	return _sys_prx_load_module_by_fd(ppu, fd, offset, flags, pOpt);
 }
 
-static error_code prx_load_module_list(ppu_thread& ppu, s32 count, vm::cpptr<char, u32, u64> path_list, u32 /*mem_ct*/, u64 flags, vm::ptr<sys_prx_load_module_option_t> pOpt, vm::ptr<u32> id_list)
+static error_code prx_load_module_list(ppu_thread& ppu, s32 count, vm::cpptr<char, u32, u64> path_list, u32 /*mem_ct*/, u64 flags, vm::ptr<sys_prx_load_module_option_t> /*pOpt*/, vm::ptr<u32> id_list)
 {
-	if (flags != 0)
+	if (error_code result = prx_check_load_flags(flags); result < 0)
 	{
-		if (flags & SYS_PRX_LOAD_MODULE_FLAGS_INVALIDMASK)
-		{
-			return CELL_EINVAL;
-		}
-
-		if (flags & SYS_PRX_LOAD_MODULE_FLAGS_FIXEDADDR && !g_ps3_process_info.ppc_seg)
-		{
-			return CELL_ENOSYS;
-		}
-
-		fmt::throw_exception("sys_prx: Unimplemented fixed address allocations");
+		return result;
 	}
 
+	std::vector<prx_load_request> list(std::max<s32>(count, 0));
+
 	for (s32 i = 0; i < count; ++i)
 	{
-		const auto result = prx_load_module(path_list[i].get_ptr(), flags, pOpt);
+		list[i].vpath = path_list[i].get_ptr();
+	}
 
-		if (result < 0)
+	if (error_code result = prx_load_modules(list); result < 0)
+	{
+		for (auto it = list.rbegin(); it != list.rend(); it++)
 		{
-			while (--i >= 0)
-			{
-				// Unload already loaded modules
-				_sys_prx_unload_module(ppu, id_list[i], 0, vm::null);
-			}
-
-			// Fill with -1
-			std::memset(id_list.get_ptr(), -1, count * sizeof(id_list[0]));
-			return result;
+			// Unload already loaded modules
+			_sys_prx_unload_module(ppu, it->id, 0, vm::null);
 		}
 
-		id_list[i] = result;
+		// Fill with -1
+		std::memset(id_list.get_ptr(), -1, count * sizeof(id_list[0]));
+		return result;
+	}
+
+	for (s32 i = 0; i < count; ++i)
+	{
+		id_list[i] = list[i].id;
 	}
 
 	return CELL_OK;
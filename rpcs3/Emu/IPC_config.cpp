@@ -55,6 +55,11 @@ int cfg_ipc::get_port() const
 	return ipc_port;
 }
 
+bool cfg_ipc::get_memory_sharing_enabled() const
+{
+	return ipc_memory_sharing.get();
+}
+
 void cfg_ipc::set_server_enabled(const bool enabled)
 {
 	this->ipc_server_enabled.set(enabled);
@@ -64,3 +69,8 @@ void cfg_ipc::set_port(const int port)
 {
 	this->ipc_port.set(port);
 }
+
+void cfg_ipc::set_memory_sharing_enabled(const bool enabled)
+{
+	this->ipc_memory_sharing.set(enabled);
+}
@@ -6,15 +6,18 @@ struct cfg_ipc : cfg::node
 {
 	cfg::_bool ipc_server_enabled{ this, "IPC Server enabled", false };
 	cfg::_int<1025, 65535> ipc_port{ this, "IPC Port", 28012 };
+	cfg::_bool ipc_memory_sharing{ this, "IPC Memory Sharing", false };
 
 	void load();
 	void save() const;
 
 	bool get_server_enabled() const;
 	int get_port() const;
+	bool get_memory_sharing_enabled() const;
 
 	void set_server_enabled(const bool enabled);
 	void set_port(const int port);
+	void set_memory_sharing_enabled(const bool enabled);
 
 private:
 	static std::string get_path();
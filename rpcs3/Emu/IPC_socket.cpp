@@ -3,6 +3,11 @@
 #include "Emu/IPC_config.h"
 #include "IPC_socket.h"
 #include "rpcs3_version.h"
+#include "util/vm.hpp"
+
+#ifdef __linux__
+#include <fcntl.h>
+#endif
 
 
 namespace IPC_socket
@@ -47,6 +52,51 @@ namespace IPC_socket
 		vm::write64(addr, value);
 	}
 
+	bool IPC_impl::read_block(u32 addr, void* dst, u32 size)
+	{
+		return vm::try_access(addr, dst, size, false);
+	}
+
+	bool IPC_impl::write_block(u32 addr, const void* src, u32 size)
+	{
+		return vm::try_access(addr, const_cast<void*>(src), size, true);
+	}
+
+	int IPC_impl::get_shared_memory(u32& addr, u64& size)
+	{
+#ifdef __linux__
+		if (!g_cfg_ipc.get_memory_sharing_enabled())
+		{
+			return -1;
+		}
+
+		const auto block = vm::get(vm::main);
+
+		if (!block || !block->get_common_shm())
+		{
+			return -1;
+		}
+
+		// Reopen the descriptor read-only, clients must not be able to write into guest memory
+		const int fd = ::open(fmt::format("/proc/self/fd/%d", block->get_common_shm()->get_handle()).c_str(), O_RDONLY | O_CLOEXEC);
+
+		if (fd < 0)
+		{
+			IPC.error("Failed to share main memory (errno=%d)", errno);
+			return -1;
+		}
+
+		IPC.notice("Sharing main memory (addr=0x%x, size=0x%x)", block->addr, block->size);
+		addr = block->addr;
+		size = block->size;
+		return fd;
+#else
+		static_cast<void>(addr);
+		static_cast<void>(size);
+		return -1;
+#endif
+	}
+
 	int IPC_impl::get_port()
 	{
 		return g_cfg_ipc.get_port();
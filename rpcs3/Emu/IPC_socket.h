@@ -26,6 +26,11 @@ namespace IPC_socket
 		static void write32(u32 addr, be_t<u32> value);
 		static const be_t<u64>& read64(u32 addr);
 		static void write64(u32 addr, be_t<u64> value);
+		static bool read_block(u32 addr, void* dst, u32 size);
+		static bool write_block(u32 addr, const void* src, u32 size);
+
+		// Returns a read-only file descriptor of main memory and its location, -1 if sharing is disabled or unsupported
+		static int get_shared_memory(u32& addr, u64& size);
 
 		template<typename... Args>
 		static void error(const const_str& fmt, Args&&... args)
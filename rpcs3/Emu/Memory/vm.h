@@ -176,6 +176,12 @@ namespace vm
 		// Get allocated memory count
 		u32 used();
 
+		// Get shared memory backing the whole block (preallocated blocks only)
+		const std::shared_ptr<utils::shm>& get_common_shm() const
+		{
+			return m_common;
+		}
+
 		// Internal
 		u32 imp_used(const vm::writer_lock&) const;
 
@@ -0,0 +1,381 @@
+#include "stdafx.h"
+#include "vm_reservation_stats.h"
+
+#include "Emu/perf_meter.hpp"
+#include "Utilities/File.h"
+#include "Utilities/Thread.h"
+#include "util/atomic.hpp"
+#include "util/sysinfo.hpp"
+#include "util/tsc.hpp"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+u32 g_rsrv_stats_interval = 0;
+
+extern const std::unordered_map<u32, std::string_view>& get_exported_function_names_as_addr_indexed_map();
+
+namespace vm
+{
+	// RTM abort status bits
+	enum : u32
+	{
+		rtm_abort_conflict = 1u << 2,
+		rtm_abort_capacity = 1u << 3,
+	};
+
+	enum : u32
+	{
+		line_flag_spu = 1,
+		line_flag_ppu = 2,
+	};
+
+	struct alignas(128) reservation_line_entry
+	{
+		atomic_t<u32> line; // Line index + 1, 0 if unused
+		atomic_t<u32> pc;
+		atomic_t<u32> cpu_id;
+		atomic_t<u32> flags;
+		atomic_t<u32> max_waiters;
+		atomic_t<u64> stores;
+		atomic_t<u64> store_failures;
+		atomic_t<u64> tx_aborts;
+		atomic_t<u64> tx_conflicts;
+		atomic_t<u64> tx_capacity;
+		atomic_t<u64> loads;
+		atomic_t<u64> load_retries;
+		atomic_t<u64> load_ticks;
+		atomic_t<u64> lr_waits;
+		atomic_t<u64> lr_busy_waits;
+		atomic_t<u64> lr_wait_ticks;
+		atomic_t<u64> lr_busy_wait_ticks;
+	};
+
+	// Open addressing table, lines which don't fit are dropped
+	static constexpr u32 c_table_bits = 14;
+	static constexpr u32 c_table_size = 1u << c_table_bits;
+	static constexpr u32 c_max_probes = 32;
+
+	static std::unique_ptr<reservation_line_entry[]> s_table;
+	static atomic_t<u64> s_dropped = 0;
+
+	static reservation_line_entry* find_line(u32 addr) noexcept
+	{
+		const u32 key = addr / 128 + 1;
+		const u32 hash = (key * 0x9e3779b1u) >> (32 - c_table_bits);
+
+		for (u32 i = 0; i < c_max_probes; i++)
+		{
+			auto& entry = s_table[(hash + i) % c_table_size];
+			u32 old = entry.line.load();
+
+			// Claim a free entry (another thread may claim it for the same line)
+			if (old == key || (old == 0 && (entry.line.compare_exchange(old, key) || old == key)))
+			{
+				return &entry;
+			}
+		}
+
+		s_dropped++;
+		return nullptr;
+	}
+
+	bool reservation_stats_sample_internal() noexcept
+	{
+		static thread_local u32 s_tls_countdown = 0;
+
+		if (s_tls_countdown)
+		{
+			s_tls_countdown--;
+			return false;
+		}
+
+		s_tls_countdown = g_rsrv_stats_interval - 1;
+		return true;
+	}
+
+	void reservation_stats_record(const reservation_sample& sample) noexcept
+	{
+		if (!s_table)
+		{
+			return;
+		}
+
+		const auto entry = find_line(sample.addr);
+
+		if (!entry)
+		{
+			return;
+		}
+
+		const bool is_spu = static_cast<thread_class>(sample.cpu_id >> 24) == thread_class::spu;
+
+		if (!(entry->flags & (is_spu ? line_flag_spu : line_flag_ppu)))
+		{
+			entry->flags |= is_spu ? line_flag_spu : line_flag_ppu;
+		}
+
+		if (sample.waiters > entry->max_waiters)
+		{
+			entry->max_waiters.fetch_op([&](u32& value)
+			{
+				value = std::max(value, sample.waiters);
+			});
+		}
+
+		switch (sample.event)
+		{
+		case reservation_event::store_success:
+		case reservation_event::store_failure:
+		{
+			entry->stores++;
+
+			if (sample.tx_aborts)
+			{
+				entry->tx_aborts += sample.tx_aborts;
+
+				if (sample.tx_status & rtm_abort_conflict)
+				{
+					entry->tx_conflicts++;
+				}
+
+				if (sample.tx_status & rtm_abort_capacity)
+				{
+					entry->tx_capacity++;
+				}
+			}
+
+			if (sample.event == reservation_event::store_failure)
+			{
+				entry->store_failures++;
+				entry->pc.release(sample.pc);
+				entry->cpu_id.release(sample.cpu_id);
+				return;
+			}
+
+			break;
+		}
+		case reservation_event::load:
+		{
+			entry->loads++;
+			entry->load_retries += sample.retries;
+			entry->load_ticks += sample.ticks;
+			break;
+		}
+		case reservation_event::lr_wait:
+		{
+			if (sample.busy_wait)
+			{
+				entry->lr_busy_waits++;
+				entry->lr_busy_wait_ticks += sample.ticks;
+			}
+			else
+			{
+				entry->lr_waits++;
+				entry->lr_wait_ticks += sample.ticks;
+			}
+
+			break;
+		}
+		}
+
+		// Keep the PC of the last failure if there was one
+		if (!entry->store_failures)
+		{
+			entry->pc.release(sample.pc);
+			entry->cpu_id.release(sample.cpu_id);
+		}
+	}
+
+	void reservation_stats_reset(u32 interval)
+	{
+		g_rsrv_stats_interval = 0;
+		s_dropped = 0;
+		s_table.reset();
+
+		if (interval)
+		{
+			s_table = std::make_unique<reservation_line_entry[]>(c_table_size);
+			g_rsrv_stats_interval = interval;
+		}
+	}
+
+	std::vector<reservation_line_stats> reservation_stats_collect()
+	{
+		std::vector<reservation_line_stats> result;
+
+		if (!s_table)
+		{
+			return result;
+		}
+
+		for (u32 i = 0; i < c_table_size; i++)
+		{
+			const auto& entry = s_table[i];
+
+			if (!entry.line)
+			{
+				continue;
+			}
+
+			auto& line = result.emplace_back();
+			line.addr = (entry.line - 1) * 128;
+			line.pc = entry.pc;
+			line.cpu_id = entry.cpu_id;
+			line.spu = !!(entry.flags & line_flag_spu);
+			line.ppu = !!(entry.flags & line_flag_ppu);
+			line.max_waiters = entry.max_waiters;
+			line.stores = entry.stores;
+			line.store_failures = entry.store_failures;
+			line.tx_aborts = entry.tx_aborts;
+			line.tx_conflicts = entry.tx_conflicts;
+			line.tx_capacity = entry.tx_capacity;
+			line.loads = entry.loads;
+			line.load_retries = entry.load_retries;
+			line.load_ticks = entry.load_ticks;
+			line.lr_waits = entry.lr_waits;
+			line.lr_busy_waits = entry.lr_busy_waits;
+			line.lr_wait_ticks = entry.lr_wait_ticks;
+			line.lr_busy_wait_ticks = entry.lr_busy_wait_ticks;
+		}
+
+		std::stable_sort(result.begin(), result.end(), [](const reservation_line_stats& a, const reservation_line_stats& b)
+		{
+			return a.score() > b.score() || (a.score() == b.score() && a.addr < b.addr);
+		});
+
+		return result;
+	}
+
+	static std::string get_pc_name(const reservation_line_stats& line, const std::map<u32, std::string_view>& ppu_funcs)
+	{
+		if (static_cast<thread_class>(line.cpu_id >> 24) == thread_class::spu)
+		{
+			return fmt::format("SPU[0x%07x] LS 0x%05x", line.cpu_id, line.pc);
+		}
+
+		// Nearest preceding exported function
+		if (auto it = ppu_funcs.upper_bound(line.pc); it != ppu_funcs.begin() && line.pc - (--it)->first < 0x10000)
+		{
+			return fmt::format("PPU[0x%07x] 0x%08x (%s+0x%x)", line.cpu_id, line.pc, it->second, line.pc - it->first);
+		}
+
+		return fmt::format("PPU[0x%07x] 0x%08x", line.cpu_id, line.pc);
+	}
+
+	static f64 ticks_to_us(u64 ticks, u64 count)
+	{
+		return count ? ticks * 1000'000. / utils::get_tsc_freq() / count : 0.;
+	}
+
+	static std::map<u32, std::string_view> get_ppu_function_map()
+	{
+		std::map<u32, std::string_view> result;
+
+		for (const auto& [addr, name] : get_exported_function_names_as_addr_indexed_map())
+		{
+			result.emplace(addr, name);
+		}
+
+		return result;
+	}
+
+	std::string reservation_stats_table(const std::vector<reservation_line_stats>& lines, usz max_lines)
+	{
+		const auto ppu_funcs = get_ppu_function_map();
+
+		std::string result = fmt::format("Top %u of %u reservation lines (sampling 1/%u, %u dropped):\n", std::min(max_lines, lines.size()), lines.size(), std::max<u32>(g_rsrv_stats_interval, 1), s_dropped.load());
+		fmt::append(result, "%-10s | %8s | %6s | %8s | %8s | %8s | %8s | %8s | %9s | %8s | %9s | %4s | %s\n",
+			"Address", "Stores", "Fail%", "TX abort", "Conflict", "Capacity", "Loads", "Retries", "Spin(us)", "LR waits", "Wait(us)", "Wait", "PC");
+
+		for (usz i = 0; i < lines.size() && i < max_lines; i++)
+		{
+			const auto& line = lines[i];
+			const u64 waits = line.lr_waits + line.lr_busy_waits;
+
+			fmt::append(result, "0x%08x | %8u | %5.1f%% | %8u | %8u | %8u | %8u | %8u | %9.2f | %8u | %9.2f | %4u | %s\n",
+				line.addr, line.stores, line.stores ? line.store_failures * 100. / line.stores : 0., line.tx_aborts, line.tx_conflicts, line.tx_capacity,
+				line.loads, line.load_retries, ticks_to_us(line.load_ticks, line.loads), waits, ticks_to_us(line.lr_wait_ticks + line.lr_busy_wait_ticks, waits),
+				line.max_waiters, get_pc_name(line, ppu_funcs));
+		}
+
+		return result;
+	}
+
+	std::string reservation_stats_csv(const std::vector<reservation_line_stats>& lines)
+	{
+		const auto ppu_funcs = get_ppu_function_map();
+
+		std::vector<const reservation_line_stats*> sorted;
+		sorted.reserve(lines.size());
+
+		for (const auto& line : lines)
+		{
+			sorted.push_back(&line);
+		}
+
+		std::sort(sorted.begin(), sorted.end(), [](const reservation_line_stats* a, const reservation_line_stats* b)
+		{
+			return a->addr < b->addr;
+		});
+
+		std::string result = "address,page,offset,spu,ppu,stores,store_failures,tx_aborts,tx_conflicts,tx_capacity,loads,load_retries,load_spin_us,lr_waits,lr_wait_us,lr_busy_waits,lr_busy_wait_us,max_waiters,score,pc\n";
+
+		for (const reservation_line_stats* line : sorted)
+		{
+			fmt::append(result, "0x%08x,0x%05x,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%.3f,%u,%.3f,%u,%.3f,%u,%u,\"%s\"\n",
+				line->addr, line->addr >> 12, (line->addr & 0xfff) / 128, +line->spu, +line->ppu, line->stores, line->store_failures,
+				line->tx_aborts, line->tx_conflicts, line->tx_capacity, line->loads, line->load_retries, ticks_to_us(line->load_ticks, 1),
+				line->lr_waits, ticks_to_us(line->lr_wait_ticks, 1), line->lr_busy_waits, ticks_to_us(line->lr_busy_wait_ticks, 1),
+				line->max_waiters, line->score(), get_pc_name(*line, ppu_funcs));
+		}
+
+		return result;
+	}
+
+	void reservation_stats_report()
+	{
+		if (!g_rsrv_stats_interval)
+		{
+			return;
+		}
+
+		// Emulation threads are stopped at this point
+		const auto lines = reservation_stats_collect();
+
+		if (lines.empty())
+		{
+			perf_log.notice("Reservation stats: no reservation operations were sampled.");
+			reservation_stats_reset(0);
+			return;
+		}
+
+		u64 busy_waits = 0, busy_wait_ticks = 0, waits = 0, wait_ticks = 0;
+
+		for (const auto& line : lines)
+		{
+			busy_waits += line.lr_busy_waits;
+			busy_wait_ticks += line.lr_busy_wait_ticks;
+			waits += line.lr_waits;
+			wait_ticks += line.lr_wait_ticks;
+		}
+
+		perf_log.notice("Reservation stats: %s", reservation_stats_table(lines, 20));
+		perf_log.notice("Reservation stats: SPU reservation waits: busy %u (avg %.2fus), sleeping %u (avg %.2fus)", busy_waits, ticks_to_us(busy_wait_ticks, busy_waits), waits, ticks_to_us(wait_ticks, waits));
+
+		const std::string path = fs::get_log_dir() + "reservation_stats.csv";
+
+		if (fs::write_file(path, fs::rewrite, reservation_stats_csv(lines)))
+		{
+			perf_log.notice("Reservation stats: saved %u lines to '%s'", lines.size(), path);
+		}
+		else
+		{
+			perf_log.error("Reservation stats: failed to write '%s' (%s)", path, fs::g_tls_error);
+		}
+
+		reservation_stats_reset(0);
+	}
+}
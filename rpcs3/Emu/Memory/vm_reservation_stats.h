@@ -0,0 +1,93 @@
+#pragma once
+
+#include "util/types.hpp"
+
+#include <string>
+#include <vector>
+
+// Reservation operations are sampled once every N operations per thread, 0 = disabled
+extern u32 g_rsrv_stats_interval;
+
+namespace vm
+{
+	enum class reservation_event : u8
+	{
+		store_success, // PUTLLC/STCX succeeded
+		store_failure, // PUTLLC/STCX failed
+		load, // GETLLAR completed (retries and ticks are the time spent spinning for a stable line)
+		lr_wait, // SPU waited for a lost reservation event (ticks are the time spent waiting)
+	};
+
+	struct reservation_sample
+	{
+		u32 addr = 0; // Any address in the 128-byte line
+		u32 pc = 0; // Guest PC (LS address for SPU)
+		u32 cpu_id = 0;
+		reservation_event event{};
+		bool busy_wait = false; // lr_wait: busy waiting was used instead of sleeping
+		u32 tx_aborts = 0; // Number of aborted RTM transactions
+		u32 tx_status = 0; // Combined RTM abort status bits
+		u32 retries = 0;
+		u32 waiters = 0; // Threads waiting on the reservation notifier
+		u64 ticks = 0; // TSC ticks
+	};
+
+	// Accumulated values for one 128-byte line (raw sampled counts)
+	struct reservation_line_stats
+	{
+		u32 addr = 0;
+		u32 pc = 0; // Guest PC of the last failure (or the last event if none failed)
+		u32 cpu_id = 0;
+		bool spu = false;
+		bool ppu = false;
+		u32 max_waiters = 0;
+		u64 stores = 0;
+		u64 store_failures = 0;
+		u64 tx_aborts = 0;
+		u64 tx_conflicts = 0;
+		u64 tx_capacity = 0;
+		u64 loads = 0;
+		u64 load_retries = 0;
+		u64 load_ticks = 0;
+		u64 lr_waits = 0;
+		u64 lr_busy_waits = 0;
+		u64 lr_wait_ticks = 0;
+		u64 lr_busy_wait_ticks = 0;
+
+		// Contention estimate used for sorting
+		u64 score() const
+		{
+			return store_failures * 4 + tx_aborts * 2 + load_retries + lr_waits;
+		}
+	};
+
+	bool reservation_stats_sample_internal() noexcept;
+
+	// Returns true if the current operation must be recorded
+	inline bool reservation_stats_sample() noexcept
+	{
+		if (!g_rsrv_stats_interval) [[likely]]
+		{
+			return false;
+		}
+
+		return reservation_stats_sample_internal();
+	}
+
+	void reservation_stats_record(const reservation_sample& sample) noexcept;
+
+	// Clear the table and set sampling interval (0 disables sampling)
+	void reservation_stats_reset(u32 interval);
+
+	// Snapshot of all recorded lines sorted by contention
+	std::vector<reservation_line_stats> reservation_stats_collect();
+
+	// Format a top-N table
+	std::string reservation_stats_table(const std::vector<reservation_line_stats>& lines, usz max_lines);
+
+	// Format all lines as CSV sorted by address (for heatmaps)
+	std::string reservation_stats_csv(const std::vector<reservation_line_stats>& lines);
+
+	// Log the top lines and write the CSV to the log directory, then disable sampling
+	void reservation_stats_report();
+}
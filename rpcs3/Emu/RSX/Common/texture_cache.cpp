@@ -2,10 +2,134 @@
 #include "texture_cache_utils.h"
 #include "Utilities/address_range.h"
 #include "util/fnv_hash.hpp"
+#include "util/asm.hpp"
 
 namespace rsx
 {
 	constexpr u32 min_lockable_data_size = 4096; // Increasing this value has worse results even on systems with pages > 4k
+	constexpr u32 max_demotable_data_size = 0x40000; // Hashing larger sections on every lookup costs more than the faults it saves
+	constexpr u8 write_fault_demotion_threshold = 4; // Halved every frame, so this is roughly 2 write faults per frame sustained
+
+	// Saturating write fault counters indexed by page number. Aliased entries can only demote a section early, which is harmless.
+	constexpr u32 write_fault_history_size = 0x4000;
+	static std::array<atomic_t<u8>, write_fault_history_size> g_write_fault_history{};
+	static atomic_t<bool> g_write_fault_history_dirty = false;
+	static atomic_t<u32> g_write_fault_demotions = 0;
+
+	static inline atomic_t<u8>& write_fault_history_for(u32 page)
+	{
+		return g_write_fault_history[page % write_fault_history_size];
+	}
+
+	void record_write_fault(const address_range& range)
+	{
+		for (u32 page = range.start / 4096, last = range.end / 4096; page <= last; page++)
+		{
+			write_fault_history_for(page).fetch_op([](u8& value)
+			{
+				if (value < u8{umax})
+				{
+					value++;
+				}
+			});
+		}
+
+		g_write_fault_history_dirty = true;
+	}
+
+	bool is_write_fault_hotspot(const address_range& range)
+	{
+		if (!g_write_fault_history_dirty)
+		{
+			return false;
+		}
+
+		for (u32 page = range.start / 4096, last = range.end / 4096; page <= last; page++)
+		{
+			if (write_fault_history_for(page) >= write_fault_demotion_threshold)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void decay_write_fault_history()
+	{
+		g_write_fault_demotions = 0;
+
+		if (!g_write_fault_history_dirty.exchange(false))
+		{
+			return;
+		}
+
+		bool any_left = false;
+
+		for (auto& entry : g_write_fault_history)
+		{
+			if (const u8 value = entry.observe())
+			{
+				entry.release(value / 2);
+				any_left |= (value > 1);
+			}
+		}
+
+		if (any_left)
+		{
+			g_write_fault_history_dirty = true;
+		}
+	}
+
+	u32 get_write_fault_demotions()
+	{
+		return g_write_fault_demotions;
+	}
+
+	u64 hash_texture_memory(const address_range& range)
+	{
+		// XXH64 style: four independent lanes keep the multipliers busy, unlike the serial FNV chain
+		constexpr u64 prime1 = 0x9e3779b185ebca87ull;
+		constexpr u64 prime2 = 0xc2b2ae3d27d4eb4full;
+		constexpr u64 prime3 = 0x165667b19e3779f9ull;
+
+		const auto round = [&](u64 acc, u64 value)
+		{
+			return utils::rol64(acc + value * prime2, 31) * prime1;
+		};
+
+		const u8* src = vm::g_sudo_addr + range.start;
+		const u32 length = range.length();
+
+		u64 acc[4] = { prime1 + prime2, prime2, 0, 0 - prime1 };
+		u32 offset = 0;
+
+		for (; offset + 32 <= length; offset += 32)
+		{
+			for (u32 lane = 0; lane < 4; lane++)
+			{
+				acc[lane] = round(acc[lane], read_from_ptr<u64>(src, offset + lane * 8));
+			}
+		}
+
+		u64 hash = utils::rol64(acc[0], 1) + utils::rol64(acc[1], 7) + utils::rol64(acc[2], 12) + utils::rol64(acc[3], 18) + length;
+
+		for (; offset + 8 <= length; offset += 8)
+		{
+			hash = utils::rol64(hash ^ round(0, read_from_ptr<u64>(src, offset)), 27) * prime1 + prime3;
+		}
+
+		for (; offset < length; offset++)
+		{
+			hash = utils::rol64(hash ^ (src[offset] * prime3), 11) * prime1;
+		}
+
+		hash ^= hash >> 33;
+		hash *= prime2;
+		hash ^= hash >> 29;
+		hash *= prime3;
+		return hash ^ (hash >> 32);
+	}
 
 	void buffered_section::init_lockable_range(const address_range& range)
 	{
@@ -34,6 +158,13 @@ namespace rsx
 			protection_strat = section_protection_strategy::hash;
 			mem_hash = 0;
 		}
+		else if (memory_range.length() <= max_demotable_data_size && is_write_fault_hotspot(locked_range))
+		{
+			// The guest keeps writing to this memory, avoid paying for a fault on every write
+			protection_strat = section_protection_strategy::hash;
+			mem_hash = 0;
+			g_write_fault_demotions++;
+		}
 	}
 
 	void buffered_section::invalidate_range()
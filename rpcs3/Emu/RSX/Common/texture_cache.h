@@ -1,11 +1,13 @@
 #pragma once
 
 #include "Emu/RSX/Common/simple_array.hpp"
+#include "Emu/Cell/timers.hpp"
 #include "Emu/RSX/Core/RSXContext.h"
 #include "Emu/RSX/RSXThread.h"
 #include "texture_cache_utils.h"
 #include "texture_cache_predictor.h"
 #include "texture_cache_helpers.h"
+#include "util/fnv_hash.hpp"
 
 #include <unordered_map>
 
@@ -458,6 +460,10 @@ namespace rsx
 		std::unordered_map<address_range, section_storage_type*> m_flush_always_cache;
 		u64 m_flush_always_update_timestamp = 0;
 
+		//Sections uploaded from CPU indexed by content hash and layout. Entries are validated on lookup.
+		std::unordered_map<u64, section_storage_type*> m_content_hash_index;
+		const usz m_max_content_hash_entries = 8192;
+
 		//Memory usage
 		const u32 m_max_zombie_objects = 64; //Limit on how many texture objects to keep around for reuse after they are invalidated
 
@@ -469,6 +475,10 @@ namespace rsx
 		atomic_t<u32> m_texture_upload_calls_this_frame = { 0 };
 		atomic_t<u32> m_texture_upload_misses_this_frame = { 0 };
 		atomic_t<u32> m_texture_copies_ellided_this_frame = { 0 };
+		atomic_t<u32> m_texture_upload_dedup_hits_this_frame = { 0 };
+		atomic_t<u32> m_texture_upload_dedup_misses_this_frame = { 0 };
+		atomic_t<u32> m_write_faults_this_frame = { 0 };
+		atomic_t<u64> m_fault_lock_wait_time_this_frame = { 0 }; // Microseconds spent by access violation handlers acquiring m_cache_mutex
 		static const u32 m_predict_max_flushes_per_frame = 50; // Above this number the predictions are disabled
 
 		// Invalidation
@@ -545,7 +555,8 @@ namespace rsx
 		 * Internal implementation methods and helpers
 		 */
 
-		inline bool region_intersects_cache(const address_range &test_range, bool is_writing)
+		// Does not take the cache lock, false positives are possible
+		inline bool region_may_intersect_cache(const address_range &test_range, bool is_writing) const
 		{
 			AUDIT(test_range.valid());
 
@@ -565,13 +576,24 @@ namespace rsx
 				}
 			}
 
-			// Check that there is at least one valid (locked) section in the test_range
-			reader_lock lock(m_cache_mutex);
-			if (m_storage.range_begin(test_range, locked_range, true) == m_storage.range_end())
+			// Some locked section overlaps the memory blocks of test_range
+			return m_storage.range_may_be_locked(test_range);
+		}
+
+		// Must be called with m_cache_mutex held
+		inline bool region_intersects_locked_sections(const address_range &test_range)
+		{
+			return m_storage.range_begin(test_range, locked_range, true) != m_storage.range_end();
+		}
+
+		inline bool region_intersects_cache(const address_range &test_range, bool is_writing)
+		{
+			if (!region_may_intersect_cache(test_range, is_writing))
 				return false;
 
-			// We do intersect the cache
-			return true;
+			// Check that there is at least one valid (locked) section in the test_range
+			reader_lock lock(m_cache_mutex);
+			return region_intersects_locked_sections(test_range);
 		}
 
 		/**
@@ -1171,6 +1193,7 @@ namespace rsx
 			// Nuke the permanent storage pool
 			m_storage.clear();
 			m_predictor.clear();
+			m_content_hash_index.clear();
 		}
 
 		virtual void on_frame_end()
@@ -1184,6 +1207,7 @@ namespace rsx
 			m_temporary_subresource_cache.clear();
 			m_predictor.on_frame_end();
 			reset_frame_statistics();
+			rsx::decay_write_fault_history();
 		}
 
 		template <bool check_unlocked = false>
@@ -1329,6 +1353,91 @@ namespace rsx
 			return tex;
 		}
 
+		/**
+		 * Content hash deduplication
+		 * Textures streamed out and back in are recognized by the hash of their source memory. The image decoded
+		 * by the previous upload is revived in place, or copied on the GPU when the data moved to another address.
+		 */
+		static u64 get_content_hash_key(u64 content_hash, const image_section_attributes_t& attr, u32 length, u16 mipmaps, texture_dimension_extended type)
+		{
+			usz key = rpcs3::hash64(content_hash, attr.gcm_format);
+			key = rpcs3::hash64(key, attr.pitch);
+			key = rpcs3::hash64(key, length);
+			key = rpcs3::hash64(key, u64{attr.width} | u64{attr.height} << 16 | u64{attr.depth} << 32 | u64{mipmaps} << 48);
+			return rpcs3::hash64(key, static_cast<u32>(type) | u32{attr.swizzled} << 8);
+		}
+
+		static bool content_hash_matches(const section_storage_type& section, u64 content_hash, const image_section_attributes_t& attr, u32 length, u16 mipmaps, texture_dimension_extended type)
+		{
+			return section.exists() &&
+				section.get_content_hash() == content_hash &&
+				section.get_context() == texture_upload_context::shader_read &&
+				section.get_image_type() == type &&
+				section.is_swizzled() == attr.swizzled &&
+				section.get_rsx_pitch() == attr.pitch &&
+				section.get_section_size() == length &&
+				section.matches(attr.gcm_format, attr.width, attr.height, attr.depth, mipmaps);
+		}
+
+		section_storage_type* find_content_hash_match(commandbuffer_type& cmd, const address_range& range, u64 content_hash, const image_section_attributes_t& attr, u16 mipmaps, texture_dimension_extended type)
+		{
+			const auto found = m_content_hash_index.find(get_content_hash_key(content_hash, attr, range.length(), mipmaps, type));
+
+			if (found == m_content_hash_index.end())
+			{
+				return nullptr;
+			}
+
+			section_storage_type* source = found->second;
+
+			if (!content_hash_matches(*source, content_hash, attr, range.length(), mipmaps, type))
+			{
+				// Reused or destroyed since it was indexed
+				m_content_hash_index.erase(found);
+				return nullptr;
+			}
+
+			if (source->matches(range))
+			{
+				if (!source->is_locked())
+				{
+					// Same data at the same address, the image only needs to be protected again
+					source->protect(utils::protection::ro);
+					read_only_range = source->get_min_max(read_only_range, rsx::section_bounds::locked_range);
+					update_cache_tag();
+				}
+
+				return source;
+			}
+
+			// Copying to another address is limited to what update_image_contents supports.
+			// Asynchronous uploads may still be in flight on another queue.
+			if (type != texture_dimension_extended::texture_dimension_2d || mipmaps != 1 || attr.depth != 1 ||
+				rsx::get_current_renderer()->get_backend_config().supports_asynchronous_compute)
+			{
+				return nullptr;
+			}
+
+			// Hold a reference so that the source is not recycled for the new section
+			source->add_ref();
+
+			auto section = create_new_texture(cmd, range, attr.width, attr.height, 1, 1, attr.pitch, attr.gcm_format,
+				texture_upload_context::shader_read, type, attr.swizzled, component_order::default_, 0);
+
+			source->release();
+
+			if (!content_hash_matches(*source, content_hash, attr, range.length(), mipmaps, type))
+			{
+				// Purged to make room for the new image, fall back to a regular upload into the new section
+				section->discard();
+				return nullptr;
+			}
+
+			update_image_contents(cmd, section->get_view(rsx::default_remap_vector), source->get_raw_texture(), attr.width, attr.height);
+			section->set_content_hash(content_hash);
+			return section;
+		}
+
 		section_storage_type* find_flushable_section(const address_range &memory_range)
 		{
 			auto &block = m_storage.block_for(memory_range);
@@ -1518,12 +1627,33 @@ namespace rsx
 			Args&&... extras)
 		{
 			// Test before trying to acquire the lock
+			// Only faults in blocks without locked sections return here, faults on cached textures still queue behind texture lookups
 			const auto range = page_for(address);
-			if (!region_intersects_cache(range, !cause.is_read()))
+			if (!region_may_intersect_cache(range, !cause.is_read()))
 				return{};
 
-			std::lock_guard lock(m_cache_mutex);
-			return invalidate_range_impl_base(cmd, range, cause, on_data_transfer_completed, std::forward<Args>(extras)...);
+			const u64 wait_start = get_system_time();
+			reader_lock lock(m_cache_mutex);
+
+			if (!region_intersects_locked_sections(range))
+			{
+				m_fault_lock_wait_time_this_frame += get_system_time() - wait_start;
+				return{};
+			}
+
+			lock.upgrade();
+			m_fault_lock_wait_time_this_frame += get_system_time() - wait_start;
+
+			auto result = invalidate_range_impl_base(cmd, range, cause, on_data_transfer_completed, std::forward<Args>(extras)...);
+
+			if (result.violation_handled && !cause.is_read())
+			{
+				// Remember who keeps writing to protected memory so the replacement sections can be hash-tracked instead
+				rsx::record_write_fault(range);
+				m_write_faults_this_frame++;
+			}
+
+			return result;
 		}
 
 		template <typename ...Args>
@@ -1535,10 +1665,15 @@ namespace rsx
 			Args&&... extras)
 		{
 			// Test before trying to acquire the lock
-			if (!region_intersects_cache(range, !cause.is_read()))
+			if (!region_may_intersect_cache(range, !cause.is_read()))
 				return {};
 
-			std::lock_guard lock(m_cache_mutex);
+			reader_lock lock(m_cache_mutex);
+
+			if (!region_intersects_locked_sections(range))
+				return {};
+
+			lock.upgrade();
 			return invalidate_range_impl_base(cmd, range, cause, on_data_transfer_completed, std::forward<Args>(extras)...);
 		}
 
@@ -2501,10 +2636,41 @@ namespace rsx
 			const address_range tex_range = address_range::start_length(attributes.address, tex_size);
 			invalidate_range_impl_base(cmd, tex_range, invalidation_cause::read, {}, std::forward<Args>(extras)...);
 
+			const u16 mipmaps = tex.get_exact_mipmap_count();
+			u64 content_hash = 0;
+
+			if (g_cfg.video.deduplicate_texture_uploads)
+			{
+				// Hashed after the invalidation above, overlapping framebuffer data may have been flushed to memory
+				content_hash = rsx::hash_texture_memory(tex_range);
+
+				if (auto found = find_content_hash_match(cmd, tex_range, content_hash, attributes, mipmaps, extended_dimension))
+				{
+					m_texture_upload_dedup_hits_this_frame++;
+
+					return{ found->get_view(tex.decoded_remap()),
+							texture_upload_context::shader_read, format_class, scale, extended_dimension };
+				}
+
+				m_texture_upload_dedup_misses_this_frame++;
+			}
+
 			// Upload from CPU. Note that sRGB conversion is handled in the FS
-			auto uploaded = upload_image_from_cpu(cmd, tex_range, attributes.width, attributes.height, attributes.depth, tex.get_exact_mipmap_count(), attributes.pitch, attributes.gcm_format,
+			auto uploaded = upload_image_from_cpu(cmd, tex_range, attributes.width, attributes.height, attributes.depth, mipmaps, attributes.pitch, attributes.gcm_format,
 				texture_upload_context::shader_read, subresources_layout, extended_dimension, attributes.swizzled);
 
+			uploaded->set_content_hash(content_hash);
+
+			if (content_hash)
+			{
+				if (m_content_hash_index.size() >= m_max_content_hash_entries)
+				{
+					m_content_hash_index.clear();
+				}
+
+				m_content_hash_index[get_content_hash_key(content_hash, attributes, tex_size, mipmaps, extended_dimension)] = uploaded;
+			}
+
 			return{ uploaded->get_view(tex.decoded_remap()),
 					texture_upload_context::shader_read, format_class, scale, extended_dimension };
 		}
@@ -3548,6 +3714,10 @@ namespace rsx
 			m_texture_upload_calls_this_frame.store(0u);
 			m_texture_upload_misses_this_frame.store(0u);
 			m_texture_copies_ellided_this_frame.store(0u);
+			m_texture_upload_dedup_hits_this_frame.store(0u);
+			m_texture_upload_dedup_misses_this_frame.store(0u);
+			m_write_faults_this_frame.store(0u);
+			m_fault_lock_wait_time_this_frame.store(0u);
 		}
 
 		void on_flush()
@@ -3635,5 +3805,30 @@ namespace rsx
 		{
 			return m_texture_copies_ellided_this_frame;
 		}
+
+		u32 get_texture_upload_dedup_hits_this_frame() const
+		{
+			return m_texture_upload_dedup_hits_this_frame;
+		}
+
+		u32 get_texture_upload_dedup_misses_this_frame() const
+		{
+			return m_texture_upload_dedup_misses_this_frame;
+		}
+
+		u32 get_num_write_faults_this_frame() const
+		{
+			return m_write_faults_this_frame;
+		}
+
+		u64 get_fault_lock_wait_time_this_frame() const
+		{
+			return m_fault_lock_wait_time_this_frame;
+		}
+
+		u32 get_num_sections_demoted_to_hash_this_frame() const
+		{
+			return rsx::get_write_fault_demotions();
+		}
 	};
 }
@@ -27,6 +27,20 @@ namespace rsx
 		hash
 	};
 
+	/**
+	 * Write fault history
+	 * Ranges that keep faulting on write are cheaper to verify by hashing than by protecting them.
+	 */
+	void record_write_fault(const address_range& range);
+	bool is_write_fault_hotspot(const address_range& range);
+	void decay_write_fault_history();
+	u32 get_write_fault_demotions();
+
+	/**
+	 * Content hash of guest memory, used to recognize texture data that is uploaded again after being invalidated
+	 */
+	u64 hash_texture_memory(const address_range& range);
+
 	static inline void memory_protect(const address_range& range, utils::protection prot)
 	{
 		ensure(range.is_page_range());
@@ -238,6 +252,7 @@ namespace rsx
 		atomic_t<u32> exists_count = 0;
 		atomic_t<u32> locked_count = 0;
 		atomic_t<u32> unreleased_count = 0;
+		atomic_t<u32> locked_overlap_count = 0; // locked sections overlapping this block, including the ones owned by previous blocks
 		ranged_storage_type *m_storage = nullptr;
 
 		inline void add_owned_section_overlaps(section_storage_type &section)
@@ -286,6 +301,7 @@ namespace rsx
 		inline u32 get_exists_count() const { return exists_count; }
 		inline u32 get_locked_count() const { return locked_count; }
 		inline u32 get_unreleased_count() const { return unreleased_count; }
+		inline u32 get_locked_overlap_count() const { return locked_overlap_count; }
 
 		/**
 		 * Utilities
@@ -423,6 +439,17 @@ namespace rsx
 			unreleased_count++;
 		}
 
+		inline void on_locked_section_overlap_added()
+		{
+			locked_overlap_count++;
+		}
+
+		inline void on_locked_section_overlap_removed()
+		{
+			u32 prev_locked = locked_overlap_count--;
+			ensure(prev_locked > 0);
+		}
+
 
 		/**
 		 * Overlapping sections
@@ -535,6 +562,44 @@ namespace rsx
 		}
 
 
+		/**
+		 * Lock-free queries
+		 */
+
+		// Per-block counters are raised before a section's pages are protected and dropped after they are unprotected,
+		// so an access violation on a protected page always sees a non-zero count without taking the cache lock
+		bool range_may_be_locked(const address_range& range) const
+		{
+			AUDIT(range.valid());
+
+			for (u32 i = range.start / block_size, last = range.end / block_size; i <= last; i++)
+			{
+				if (blocks[i].get_locked_overlap_count())
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void on_section_locking(const address_range& range)
+		{
+			for (u32 i = range.start / block_size, last = range.end / block_size; i <= last; i++)
+			{
+				blocks[i].on_locked_section_overlap_added();
+			}
+		}
+
+		void on_section_unlocked(const address_range& range)
+		{
+			for (u32 i = range.start / block_size, last = range.end / block_size; i <= last; i++)
+			{
+				blocks[i].on_locked_section_overlap_removed();
+			}
+		}
+
+
 		/**
 		 * Blocks
 		 */
@@ -1063,6 +1128,7 @@ namespace rsx
 		bool dirty = true;
 		bool triggered_exists_callbacks = false;
 		bool triggered_unreleased_callbacks = false;
+		address_range locked_overlap_range; // Blocks counting this section as locked
 
 	protected:
 
@@ -1078,6 +1144,8 @@ namespace rsx
 		bool pack_unpack_swap_bytes = false;
 		bool swizzled = false;
 
+		u64 content_hash = 0; // Hash of the memory the image was uploaded from, 0 if unknown
+
 		u64 sync_timestamp = 0;
 		bool synchronized = false;
 		bool flushed = false;
@@ -1148,6 +1216,8 @@ namespace rsx
 			pack_unpack_swap_bytes = false;
 			swizzled = false;
 
+			content_hash = 0ull;
+
 			sync_timestamp = 0ull;
 			synchronized = false;
 			flushed = false;
@@ -1211,6 +1281,7 @@ namespace rsx
 
 			// Set dirty
 			set_dirty(true);
+			content_hash = 0ull;
 
 			// Trigger callbacks
 			m_block->on_section_resources_destroyed(*derived());
@@ -1350,6 +1421,16 @@ namespace rsx
 		/**
 		 * Protection
 		 */
+		void pre_protect(utils::protection old_prot, utils::protection prot)
+		{
+			if (old_prot == utils::protection::rw && prot != utils::protection::rw)
+			{
+				// Must be visible to the fault handlers before the pages are protected
+				locked_overlap_range = get_section_range();
+				m_storage->on_section_locking(locked_overlap_range);
+			}
+		}
+
 		void post_protect(utils::protection old_prot, utils::protection prot)
 		{
 			if (old_prot != utils::protection::rw && prot == utils::protection::rw)
@@ -1357,6 +1438,7 @@ namespace rsx
 				AUDIT(!is_locked());
 
 				m_block->on_section_unprotected(*derived());
+				m_storage->on_section_unlocked(locked_overlap_range);
 
 				// Blit and framebuffers may be unprotected and clean
 				if (context == texture_upload_context::shader_read)
@@ -1397,6 +1479,7 @@ namespace rsx
 		inline void protect(utils::protection prot)
 		{
 			utils::protection old_prot = get_protection();
+			pre_protect(old_prot, prot);
 			rsx::buffered_section::protect(prot);
 			post_protect(old_prot, prot);
 		}
@@ -1404,6 +1487,7 @@ namespace rsx
 		inline void protect(utils::protection prot, const std::pair<u32, u32>& range_confirm)
 		{
 			utils::protection old_prot = get_protection();
+			pre_protect(old_prot, prot);
 			rsx::buffered_section::protect(prot, range_confirm);
 			post_protect(old_prot, prot);
 		}
@@ -1720,6 +1804,11 @@ namespace rsx
 			swizzled = is_swizzled;
 		}
 
+		void set_content_hash(u64 hash)
+		{
+			content_hash = hash;
+		}
+
 		void set_memory_read_flags(memory_read_flags flags, bool notify_texture_cache = true)
 		{
 			const bool changed = (flags != readback_behaviour);
@@ -1786,6 +1875,11 @@ namespace rsx
 			return swizzled;
 		}
 
+		u64 get_content_hash() const
+		{
+			return content_hash;
+		}
+
 		memory_read_flags get_memory_read_flags() const
 		{
 			return readback_behaviour;
@@ -62,6 +62,9 @@ namespace rsx
 		u32 program_cache_lookups_total;
 		u32 program_cache_lookups_ellided;
 
+		u32 fault_count;
+		s64 fault_handling_time;
+
 		framebuffer_statistics_t framebuffer_stats;
 	};
 
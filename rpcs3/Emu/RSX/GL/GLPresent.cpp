@@ -396,6 +396,11 @@ void GLGSRender::flip(const rsx::display_flip_info_t& info)
 		const auto num_texture_upload_miss = m_gl_texture_cache.get_texture_upload_misses_this_frame();
 		const auto texture_upload_miss_ratio = m_gl_texture_cache.get_texture_upload_miss_percentage();
 		const auto texture_copies_ellided = m_gl_texture_cache.get_texture_copies_ellided_this_frame();
+		const auto num_dedup_hits = m_gl_texture_cache.get_texture_upload_dedup_hits_this_frame();
+		const auto num_dedup_lookups = num_dedup_hits + m_gl_texture_cache.get_texture_upload_dedup_misses_this_frame();
+		const auto num_write_faults = m_gl_texture_cache.get_num_write_faults_this_frame();
+		const auto fault_lock_wait_time = m_gl_texture_cache.get_fault_lock_wait_time_this_frame();
+		const auto num_demoted = m_gl_texture_cache.get_num_sections_demoted_to_hash_this_frame();
 		const auto vertex_cache_hit_count = (info.stats.vertex_cache_request_count - info.stats.vertex_cache_miss_count);
 		const auto vertex_cache_hit_ratio = info.stats.vertex_cache_request_count
 			? (vertex_cache_hit_count * 100) / info.stats.vertex_cache_request_count
@@ -417,14 +422,16 @@ void GLGSRender::flip(const rsx::display_flip_info_t& info)
 			"Unreleased textures: %7d\n"
 			"Texture memory: %12dM\n"
 			"Flush requests: %12d  = %2d (%3d%%) hard faults, %2d unavoidable, %2d misprediction(s), %2d speculation(s)\n"
-			"Texture uploads: %11u (%u from CPU - %02u%%, %u copies avoided)\n"
+			"Texture uploads: %11u (%u from CPU - %02u%%, %u copies avoided, %u/%u deduplicated)\n"
+			"Memory faults: %13u (%uus, %uus waiting for the texture cache, %u write fault(s), %u section(s) demoted to hashing)\n"
 			"Vertex cache hits: %9u/%u (%u%%)\n"
 			"Program cache lookup ellision: %u/%u (%u%%)",
 			info.stats.framebuffer_stats.to_string(!backend_config.supports_hw_msaa),
 			get_load(), info.stats.draw_calls, info.stats.setup_time, info.stats.vertex_upload_time,
 			info.stats.textures_upload_time, info.stats.draw_exec_time, num_dirty_textures, texture_memory_size,
 			num_flushes, num_misses, cache_miss_ratio, num_unavoidable, num_mispredict, num_speculate,
-			num_texture_upload, num_texture_upload_miss, texture_upload_miss_ratio, texture_copies_ellided,
+			num_texture_upload, num_texture_upload_miss, texture_upload_miss_ratio, texture_copies_ellided, num_dedup_hits, num_dedup_lookups,
+			info.stats.fault_count, info.stats.fault_handling_time, fault_lock_wait_time, num_write_faults, num_demoted,
 			vertex_cache_hit_count, info.stats.vertex_cache_request_count, vertex_cache_hit_ratio,
 			program_cache_ellided, program_cache_lookups, program_cache_ellision_rate)
 		);
@@ -26,8 +26,22 @@ namespace rsx
 
 	void mm_defer_mprotect_internal(u64 start, u64 length, utils::protection prot)
 	{
-		// We could stack and merge requests here, but that is more trouble than it is truly worth.
-		// A fresh call to memory_protect only takes a few nanoseconds of setup overhead, it is not worth the risk of hanging because of conflicts.
+		// Coalesce with the most recent request if it is contiguous and has the same protection.
+		// Only the tail is considered so that the queue order (and therefore the final page state) is preserved.
+		if (!g_deferred_mprotect_queue.empty())
+		{
+			auto& last = g_deferred_mprotect_queue.back();
+			const u64 last_end = last.start + last.length;
+			const u64 end = start + length;
+
+			if (last.prot == prot && start <= last_end && last.start <= end)
+			{
+				last.start = std::min(last.start, start);
+				last.length = std::max(last_end, end) - last.start;
+				return;
+			}
+		}
+
 		g_deferred_mprotect_queue.push_back({ start, length, prot });
 	}
 
@@ -190,7 +190,9 @@ void FragmentProgramDecompiler::AddFlowOp(const std::string& code)
 
 void FragmentProgramDecompiler::AddCode(const std::string& code)
 {
-	main.append(m_code_level, '\t') += Format(code) + "\n";
+	main.append(m_code_level, '\t');
+	main += Format(code);
+	main += '\n';
 }
 
 std::string FragmentProgramDecompiler::GetMask() const
@@ -335,6 +337,12 @@ bool FragmentProgramDecompiler::DstExpectsSca() const
 
 std::string FragmentProgramDecompiler::Format(const std::string& code, bool ignore_redirects)
 {
+	if (code.find('$') == umax)
+	{
+		// Nothing to substitute, skip building the replacement table
+		return code;
+	}
+
 	const std::pair<std::string_view, std::function<std::string()>> repl_list[] =
 	{
 		{ "$$", []() -> std::string { return "$"; } },
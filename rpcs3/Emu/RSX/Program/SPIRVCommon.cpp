@@ -23,11 +23,249 @@
 
 #include "SPIRVCommon.h"
 #include "Emu/RSX/Program/GLSLTypes.h"
+#include "Emu/system_config.h"
+#include "Emu/cache_utils.hpp"
+#include "Crypto/sha1.h"
+#include "Utilities/File.h"
+#include "Utilities/mutex.h"
+#include "util/fnv_hash.hpp"
+
+#include <chrono>
+#include <unordered_map>
 
 namespace spirv
 {
 	static TBuiltInResource g_default_config;
 
+	// Content-addressed store of compiled SPIR-V blobs, kept in a single append-only file per title.
+	// Entries are keyed by the SHA-1 of the GLSL source mixed with everything else that affects codegen.
+	// Blobs are only indexed on load; payloads are read and checksummed on first use.
+	class spirv_disk_cache
+	{
+		// Bump when the entry layout or the glslang invocation in compile_glsl_to_spv changes
+		static constexpr u32 cache_version = 1;
+		static constexpr u64 cache_magic = "RPCS3SPV"_u64;
+
+		struct file_header
+		{
+			le_t<u64> magic;
+			le_t<u32> version;
+			le_t<u32> generator;
+		};
+
+		struct entry_header
+		{
+			u8 key[20];
+			le_t<u32> size; // In words
+			le_t<u64> checksum;
+		};
+
+		struct entry_location
+		{
+			u64 offset;
+			u32 size;
+			u64 checksum;
+		};
+
+		shared_mutex m_mutex;
+		fs::file m_file;
+		std::string m_path;
+		std::unordered_map<std::string, entry_location> m_entries;
+
+	public:
+		atomic_t<u32> hits = 0;
+		atomic_t<u32> misses = 0;
+		atomic_t<u32> rejected = 0;
+		atomic_t<u64> compile_time_us = 0;
+
+		static std::string make_key(const std::string& source, ::glsl::program_domain domain, ::glsl::glsl_rules rules)
+		{
+			const u32 params[4] = { cache_version, static_cast<u32>(glslang::GetSpirvGeneratorVersion()), domain, rules };
+
+			sha1_context ctx;
+			u8 output[20];
+
+			sha1_starts(&ctx);
+			sha1_update(&ctx, reinterpret_cast<const u8*>(params), sizeof(params));
+			sha1_update(&ctx, reinterpret_cast<const u8*>(source.data()), source.size());
+			sha1_finish(&ctx, output);
+
+			return std::string(reinterpret_cast<const char*>(output), sizeof(output));
+		}
+
+		static u64 compute_checksum(const u32* data, usz count)
+		{
+			usz result = rpcs3::fnv_seed;
+
+			for (usz i = 0; i < count; i++)
+			{
+				result = rpcs3::hash64(result, data[i]);
+			}
+
+			return result;
+		}
+
+		void open(const std::string& path)
+		{
+			std::lock_guard lock(m_mutex);
+
+			const auto start = std::chrono::steady_clock::now();
+
+			if (!m_file.open(path, fs::read + fs::write + fs::create))
+			{
+				rsx_log.error("SPIR-V cache: failed to open '%s' (%s)", path, fs::g_tls_error);
+				return;
+			}
+
+			m_path = path;
+
+			const u32 generator = static_cast<u32>(glslang::GetSpirvGeneratorVersion());
+			const u64 file_size = m_file.size();
+
+			file_header header{};
+
+			if (file_size < sizeof(header) || m_file.read_at(0, &header, sizeof(header)) != sizeof(header) ||
+				header.magic != cache_magic || header.version != cache_version || header.generator != generator)
+			{
+				if (file_size)
+				{
+					rsx_log.warning("SPIR-V cache: discarding stale or foreign cache file '%s'", path);
+				}
+
+				header.magic = cache_magic;
+				header.version = cache_version;
+				header.generator = generator;
+
+				m_file.trunc(0);
+				m_file.seek(0);
+				m_file.write(&header, sizeof(header));
+				return;
+			}
+
+			u64 offset = sizeof(header);
+
+			while (offset + sizeof(entry_header) <= file_size)
+			{
+				entry_header entry;
+
+				if (m_file.read_at(offset, &entry, sizeof(entry)) != sizeof(entry))
+				{
+					break;
+				}
+
+				const u64 payload = u64{entry.size} * sizeof(u32);
+
+				if (!entry.size || offset + sizeof(entry) + payload > file_size)
+				{
+					// Torn write from an interrupted session
+					break;
+				}
+
+				m_entries.insert_or_assign(std::string(reinterpret_cast<const char*>(entry.key), sizeof(entry.key)), entry_location{ offset + sizeof(entry), entry.size, entry.checksum });
+				offset += sizeof(entry) + payload;
+			}
+
+			if (offset != file_size)
+			{
+				rsx_log.warning("SPIR-V cache: truncating %llu trailing bytes of '%s'", file_size - offset, path);
+				m_file.trunc(offset);
+			}
+
+			rsx_log.notice("SPIR-V cache: indexed %u entries from '%s' in %uus", m_entries.size(),
+				path, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+		}
+
+		void close()
+		{
+			std::lock_guard lock(m_mutex);
+
+			if (m_file)
+			{
+				rsx_log.notice("SPIR-V cache: %u hits, %u misses, %u rejected, %uus spent compiling (%s)",
+					hits.load(), misses.load(), rejected.load(), compile_time_us.load(), m_path);
+			}
+
+			m_file.close();
+			m_path.clear();
+			m_entries.clear();
+
+			hits = 0;
+			misses = 0;
+			rejected = 0;
+			compile_time_us = 0;
+		}
+
+		bool find(const std::string& key, std::vector<u32>& spv)
+		{
+			entry_location location;
+			{
+				reader_lock lock(m_mutex);
+
+				if (!m_file)
+				{
+					return false;
+				}
+
+				const auto found = m_entries.find(key);
+
+				if (found == m_entries.end())
+				{
+					misses++;
+					return false;
+				}
+
+				location = found->second;
+				spv.resize(location.size);
+
+				if (m_file.read_at(location.offset, spv.data(), location.size * sizeof(u32)) == location.size * sizeof(u32) &&
+					compute_checksum(spv.data(), spv.size()) == location.checksum)
+				{
+					hits++;
+					return true;
+				}
+			}
+
+			// Corrupted entry, forget about it and let the caller recompile (the new blob will be appended)
+			std::lock_guard lock(m_mutex);
+
+			rsx_log.error("SPIR-V cache: checksum mismatch at offset 0x%llx of '%s'", location.offset, m_path);
+			m_entries.erase(key);
+			rejected++;
+			spv.clear();
+			return false;
+		}
+
+		void store(const std::string& key, const std::vector<u32>& spv)
+		{
+			std::lock_guard lock(m_mutex);
+
+			if (!m_file || spv.empty() || m_entries.contains(key))
+			{
+				return;
+			}
+
+			entry_header entry{};
+			std::memcpy(entry.key, key.data(), sizeof(entry.key));
+			entry.size = ::size32(spv);
+			entry.checksum = compute_checksum(spv.data(), spv.size());
+
+			const u64 offset = m_file.seek(0, fs::seek_end);
+
+			if (m_file.write(&entry, sizeof(entry)) != sizeof(entry) ||
+				m_file.write(spv.data(), spv.size() * sizeof(u32)) != spv.size() * sizeof(u32))
+			{
+				// Drop the partial record, a torn tail would also be discarded on the next load
+				rsx_log.error("SPIR-V cache: failed to write to '%s' (%s)", m_path, fs::g_tls_error);
+				m_file.trunc(offset);
+				return;
+			}
+
+			m_entries.emplace(key, entry_location{ offset + sizeof(entry), entry.size, entry.checksum });
+		}
+	};
+
+	static spirv_disk_cache g_spirv_cache;
+
 	void init_default_resources(TBuiltInResource& rsc)
 	{
 		rsc.maxLights = 32;
@@ -127,6 +365,15 @@ namespace spirv
 
 	bool compile_glsl_to_spv(std::vector<u32>& spv, std::string& shader, ::glsl::program_domain domain, ::glsl::glsl_rules rules)
 	{
+		const std::string cache_key = spirv_disk_cache::make_key(shader, domain, rules);
+
+		if (g_spirv_cache.find(cache_key, spv))
+		{
+			return true;
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+
 		EShLanguage lang = (domain == ::glsl::glsl_fragment_program)
 			? EShLangFragment
 			: (domain == ::glsl::glsl_vertex_program)
@@ -186,6 +433,13 @@ namespace spirv
 			rsx_log.error("%s", shader_object.getInfoDebugLog());
 		}
 
+		g_spirv_cache.compile_time_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+		if (success)
+		{
+			g_spirv_cache.store(cache_key, spv);
+		}
+
 		return success;
 	}
 
@@ -193,10 +447,35 @@ namespace spirv
 	{
 		glslang::InitializeProcess();
 		init_default_resources(g_default_config);
+
+		if (!g_cfg.video.disable_on_disk_shader_cache && !g_cfg.video.disable_spirv_cache)
+		{
+			if (std::string cache_path = rpcs3::cache::get_ppu_cache(); !cache_path.empty())
+			{
+				cache_path += "shaders_cache/";
+
+				if (fs::create_path(cache_path))
+				{
+					open_blob_cache(cache_path + "spirv.bin");
+				}
+			}
+		}
 	}
 
 	void finalize_compiler_context()
 	{
+		close_blob_cache();
 		glslang::FinalizeProcess();
 	}
+
+	void open_blob_cache(const std::string& path)
+	{
+		g_spirv_cache.close();
+		g_spirv_cache.open(path);
+	}
+
+	void close_blob_cache()
+	{
+		g_spirv_cache.close();
+	}
 }
@@ -12,4 +12,8 @@ namespace spirv
 
 	void initialize_compiler_context();
 	void finalize_compiler_context();
+
+	// Compiled blobs are looked up in and appended to this file (opened by initialize_compiler_context unless disabled)
+	void open_blob_cache(const std::string& path);
+	void close_blob_cache();
 }
@@ -226,6 +226,11 @@ std::string VertexProgramDecompiler::GetTex()
 
 std::string VertexProgramDecompiler::Format(const std::string& code)
 {
+	if (code.find('$') == umax)
+	{
+		return code;
+	}
+
 	const std::pair<std::string_view, std::function<std::string()>> repl_list[] =
 	{
 		{ "$$", []() -> std::string { return "$"; } },
@@ -338,8 +343,9 @@ u32 VertexProgramDecompiler::GetAddr() const
 
 void VertexProgramDecompiler::AddCode(const std::string& code)
 {
-	m_body.push_back(Format(code) + ";");
-	m_cur_instr->body.push_back(Format(code));
+	std::string formatted = Format(code);
+	m_body.push_back(formatted + ";");
+	m_cur_instr->body.push_back(std::move(formatted));
 }
 
 void VertexProgramDecompiler::SetDSTVec(const std::string& code)
@@ -675,7 +675,21 @@ namespace rsx
 	{
 		g_access_violation_handler = [this](u32 address, bool is_writing)
 		{
-			return on_access_violation(address, is_writing);
+			if (!m_profiler.enabled) [[likely]]
+			{
+				return on_access_violation(address, is_writing);
+			}
+
+			const u64 start = get_system_time();
+			const bool handled = on_access_violation(address, is_writing);
+
+			if (handled)
+			{
+				m_fault_count++;
+				m_fault_handling_time += get_system_time() - start;
+			}
+
+			return handled;
 		};
 
 		m_textures_dirty.fill(true);
@@ -3113,6 +3127,8 @@ namespace rsx
 		}
 
 		// Save current state
+		m_frame_stats.fault_count = m_fault_count.exchange(0);
+		m_frame_stats.fault_handling_time = m_fault_handling_time.exchange(0);
 		m_queued_flip.stats = m_frame_stats;
 		m_queued_flip.push(buffer);
 		m_queued_flip.skip_frame = skip_current_frame;
@@ -155,6 +155,10 @@ namespace rsx
 		rsx::profiling_timer m_profiler;
 		frame_statistics_t m_frame_stats{};
 
+		// Access violations serviced by the backend, gathered from the faulting threads
+		atomic_t<u32> m_fault_count = 0;
+		atomic_t<u64> m_fault_handling_time = 0;
+
 		// Savestates related
 		u32 m_pause_after_x_flips = 0;
 
@@ -916,6 +916,15 @@ namespace vk
 		} };
 
 		auto dst = dst_view->image();
+
+		if (dst->current_layout == VK_IMAGE_LAYOUT_UNDEFINED)
+		{
+			// Newly created image (deduplicated upload). Shader read resources are lazy-initialized before use.
+			dst->change_layout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+			copy_transfer_regions_impl(cmd, dst, region);
+			return;
+		}
+
 		dst->push_layout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 		copy_transfer_regions_impl(cmd, dst, region);
 		dst->pop_layout(cmd);
@@ -175,11 +175,13 @@ namespace rsx
 			}
 			else
 			{
-				named_thread_group workers("RSX Worker ", nb_workers, [&]()
+				const auto job = task_pool::submit(step ? "RSX Shader Compiler" : "RSX Shader Loader", nb_workers, task_priority::high, [&](task_job&, u32)
 				{
 					worker(entry_count);
 				});
 
+				job->add_total(entry_count);
+
 				u32 current_progress = 0;
 				u32 last_update_progress = 0;
 				while ((current_progress < entry_count) && !Emu.IsStopped())
@@ -192,11 +194,14 @@ namespace rsx
 
 					if (last_update_progress != current_progress)
 					{
+						job->add_done(current_progress - last_update_progress);
 						last_update_progress = current_progress;
 						dlg->update_msg(step, get_message(step, current_progress, entry_count));
 						dlg->set_value(step, current_progress);
 					}
 				}
+
+				job->join();
 			}
 
 			if (!Emu.IsStopped())
@@ -23,11 +23,355 @@ extern "C"
 #endif
 
 #include "util/sysinfo.hpp"
+#include "util/asm.hpp"
+#include "Utilities/Thread.h"
+
+#if defined(ARCH_X64)
+#include "emmintrin.h"
+#endif
+
+#ifdef ARCH_ARM64
+#ifndef _MSC_VER
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+#endif
+#include "Emu/CPU/sse2neon.h"
+#ifndef _MSC_VER
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+namespace
+{
+	// Swizzled surfaces are converted in slices of at least this size on the task pool (~250us of work per slice, waking a parked worker costs a few us)
+	constexpr u64 s_swizzle_slice_size = 2 * 1024 * 1024;
+	constexpr u32 s_swizzle_max_slices = 8;
+
+	// The Z-order index is the sum of independent per-axis offsets: index(x, y, z) = x[x] + y[y] + z[z]
+	struct z_order_offsets
+	{
+		std::vector<u32> data;
+		const u32* x;
+		const u32* y;
+		const u32* z;
+
+		z_order_offsets(u32 width, u32 height, u32 depth)
+			: data(usz{width} + height + depth)
+		{
+			const u32 log2_w = rsx::ceil_log2(width);
+			const u32 log2_h = rsx::ceil_log2(height);
+			const u32 log2_d = rsx::ceil_log2(depth);
+
+			x = data.data();
+			y = x + width;
+			z = y + height;
+
+			for (u32 i = 0; i < width; i++)
+			{
+				data[i] = rsx::calculate_z_index(i, 0, 0, log2_w, log2_h, log2_d);
+			}
+
+			for (u32 i = 0; i < height; i++)
+			{
+				data[width + i] = rsx::calculate_z_index(0, i, 0, log2_w, log2_h, log2_d);
+			}
+
+			for (u32 i = 0; i < depth; i++)
+			{
+				data[width + height + i] = rsx::calculate_z_index(0, 0, i, log2_w, log2_h, log2_d);
+			}
+		}
+	};
+
+	template <usz Size>
+	struct texel_t
+	{
+		u8 data[Size];
+	};
+
+	// Converts one 4x4 tile between 16 consecutive swizzled texels and 4 rows of the linear image.
+	// In Z-order the rows of a tile are made of the texel pairs 0-1 4-5, 2-3 6-7, 8-9 12-13 and 10-11 14-15.
+	template <typename T, bool input_is_swizzled> requires (sizeof(T) <= 4)
+	FORCE_INLINE void convert_swizzled_tile_4x4(const T* src, T* dst, u32 pitch)
+	{
+		// Both shuffles below are their own inverse, the same code handles both directions
+		if constexpr (sizeof(T) == 1)
+		{
+			// Swap the middle 16-bit pairs of each half, each 32-bit lane of the result is a row
+			if constexpr (input_is_swizzled)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+				v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xd8), 0xd8);
+
+				for (u32 row = 0; row < 4; row++, v = _mm_srli_si128(v, 4))
+				{
+					const u32 value = _mm_cvtsi128_si32(v);
+					std::memcpy(dst + row * pitch, &value, 4);
+				}
+			}
+			else
+			{
+				const auto load_row = [&](u32 row)
+				{
+					s32 value;
+					std::memcpy(&value, src + row * pitch, 4);
+					return value;
+				};
+
+				__m128i v = _mm_setr_epi32(load_row(0), load_row(1), load_row(2), load_row(3));
+				v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xd8), 0xd8);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+			}
+		}
+		else if constexpr (sizeof(T) == 2)
+		{
+			// Swap the middle 32-bit pairs, each half of the result is a row
+			for (u32 half = 0; half < 2; half++)
+			{
+				if constexpr (input_is_swizzled)
+				{
+					const __m128i v = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + half * 8)), 0xd8);
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + (half * 2) * pitch), v);
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + (half * 2 + 1) * pitch), _mm_unpackhi_epi64(v, v));
+				}
+				else
+				{
+					const __m128i lo = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + (half * 2) * pitch));
+					const __m128i hi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + (half * 2 + 1) * pitch));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + half * 8), _mm_shuffle_epi32(_mm_unpacklo_epi64(lo, hi), 0xd8));
+				}
+			}
+		}
+		else if constexpr (sizeof(T) == 4)
+		{
+			// Rows and swizzled quads are exchanged by interleaving 64-bit halves
+			for (u32 half = 0; half < 2; half++)
+			{
+				const T* a = input_is_swizzled ? src + half * 8 : src + (half * 2) * pitch;
+				const T* b = input_is_swizzled ? src + half * 8 + 4 : src + (half * 2 + 1) * pitch;
+				T* c = input_is_swizzled ? dst + (half * 2) * pitch : dst + half * 8;
+				T* d = input_is_swizzled ? dst + (half * 2 + 1) * pitch : dst + half * 8 + 4;
+
+				const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+				const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(c), _mm_unpacklo_epi64(va, vb));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm_unpackhi_epi64(va, vb));
+			}
+		}
+	}
+
+	// Converts texels [x_begin, width) of one row, 'base' is the Z-order offset of the row
+	template <typename T, bool input_is_swizzled>
+	FORCE_INLINE void convert_linear_swizzle_row(const T* input, T* output, const u32* x_offs, u32 base, u32 x_begin, u32 width)
+	{
+		u32 x = x_begin;
+
+		// Texel pairs are contiguous in Z-order if the index starts with x0
+		if (width >= 2)
+		{
+			for (; x + 1 < width; x += 2)
+			{
+				if constexpr (input_is_swizzled)
+				{
+					std::memcpy(output + x, input + base + x_offs[x], sizeof(T) * 2);
+				}
+				else
+				{
+					std::memcpy(output + base + x_offs[x], input + x, sizeof(T) * 2);
+				}
+			}
+		}
+
+		for (; x < width; x++)
+		{
+			if constexpr (input_is_swizzled)
+			{
+				output[x] = input[base + x_offs[x]];
+			}
+			else
+			{
+				output[base + x_offs[x]] = input[x];
+			}
+		}
+	}
+
+	// Converts rows [y_begin, y_end) of a 2D surface, y_begin must be a multiple of 4
+	template <typename T, bool input_is_swizzled>
+	void convert_linear_swizzle_rows(const T* input, T* output, const z_order_offsets& offs, u32 width, u32 height, u32 pitch, u32 y_begin, u32 y_end)
+	{
+		const auto convert_row = [&](u32 y, u32 x_begin)
+		{
+			if constexpr (input_is_swizzled)
+			{
+				convert_linear_swizzle_row<T, true>(input, output + usz{y} * pitch, offs.x, offs.y[y], x_begin, width);
+			}
+			else
+			{
+				convert_linear_swizzle_row<T, false>(input + usz{y} * pitch, output, offs.x, offs.y[y], x_begin, width);
+			}
+		};
+
+		u32 y = y_begin;
+
+		// 4x4 tiles are contiguous in Z-order when both dimensions are at least 4 (index bits x0 y0 x1 y1).
+		// Larger texels are moved in pairs along the rows instead, which keeps the linear side sequential.
+		if constexpr (sizeof(T) <= 4)
+		{
+			const bool tiled = width >= 4 && height >= 4;
+			const u32 tiled_width = tiled ? width & ~3u : 0;
+			const u32 tiled_end = tiled ? std::min(y_end, height & ~3u) : y_begin;
+
+			for (; y < tiled_end; y += 4)
+			{
+				const u32 base = offs.y[y];
+
+				for (u32 x = 0; x < tiled_width; x += 4)
+				{
+					if constexpr (input_is_swizzled)
+					{
+						convert_swizzled_tile_4x4<T, true>(input + base + offs.x[x], output + usz{y} * pitch + x, pitch);
+					}
+					else
+					{
+						convert_swizzled_tile_4x4<T, false>(input + usz{y} * pitch + x, output + base + offs.x[x], pitch);
+					}
+				}
+
+				// Columns which don't fill a tile
+				if (tiled_width != width)
+				{
+					for (u32 row = y; row < y + 4; row++)
+					{
+						convert_row(row, tiled_width);
+					}
+				}
+			}
+		}
+
+		for (; y < y_end; y++)
+		{
+			convert_row(y, 0);
+		}
+	}
+
+	// Converts linear rows [row_begin, row_end) of a volume (row = z * height + y) from its swizzled layout
+	template <typename T>
+	void convert_swizzled_volume_rows(const T* input, T* output, const z_order_offsets& offs, u32 width, u32 height, u32 row_begin, u32 row_end)
+	{
+		for (u32 row = row_begin; row < row_end; row++)
+		{
+			convert_linear_swizzle_row<T, true>(input, output + usz{row} * width, offs.x, offs.z[row / height] + offs.y[row % height], 0, width);
+		}
+	}
+
+	// Splits 'rows' into slices of 'align' rows run on the task pool when the surface is large enough
+	template <typename F>
+	void run_swizzle_slices(u64 size_in_bytes, u32 rows, u32 align, F&& func)
+	{
+		const u32 max_slices = std::min<u32>(task_pool::get_thread_limit(), s_swizzle_max_slices);
+		const u32 slice_count = static_cast<u32>(std::clamp<u64>(size_in_bytes / s_swizzle_slice_size, 1, std::max<u32>(max_slices, 1)));
+		const u32 slice_rows = utils::align<u32>(utils::aligned_div<u32>(rows, slice_count), align);
+		const u32 slices = utils::aligned_div<u32>(rows, slice_rows);
+
+		if (slices <= 1)
+		{
+			func(0, rows);
+			return;
+		}
+
+		const auto job = task_pool::submit("RSX Swizzle", slices, task_priority::high, [&](task_job&, u32 slot)
+		{
+			func(slot * slice_rows, std::min(rows, (slot + 1) * slice_rows));
+		});
+
+		// Don't wait for a pool thread if all of them are busy
+		job->help();
+		job->join();
+	}
+
+	template <typename T, bool input_is_swizzled>
+	void convert_linear_swizzle_impl(const void* input_pixels, void* output_pixels, u16 width, u16 height, u32 pitch)
+	{
+		const z_order_offsets offs(width, height, 1);
+		const u32 pitch_in_blocks = pitch / sizeof(T);
+
+		run_swizzle_slices(u64{width} * height * sizeof(T), height, 4, [&](u32 y_begin, u32 y_end)
+		{
+			convert_linear_swizzle_rows<T, input_is_swizzled>(static_cast<const T*>(input_pixels), static_cast<T*>(output_pixels), offs, width, height, pitch_in_blocks, y_begin, y_end);
+		});
+	}
+
+	template <typename T>
+	void convert_linear_swizzle_3d_impl(const void* input_pixels, void* output_pixels, u16 width, u16 height, u16 depth)
+	{
+		const z_order_offsets offs(width, height, depth);
+
+		run_swizzle_slices(u64{width} * height * depth * sizeof(T), u32{height} * depth, 1, [&](u32 row_begin, u32 row_end)
+		{
+			convert_swizzled_volume_rows<T>(static_cast<const T*>(input_pixels), static_cast<T*>(output_pixels), offs, width, height, row_begin, row_end);
+		});
+	}
+}
 
 namespace rsx
 {
 	atomic_t<u64> g_rsx_shared_tag{ 0 };
 
+	void convert_linear_swizzle(const void* input_pixels, void* output_pixels, u16 width, u16 height, u32 pitch, u32 texel_size, bool input_is_swizzled)
+	{
+		if (!width || !height)
+		{
+			return;
+		}
+
+		const auto convert = [&]<usz Size>()
+		{
+			if (input_is_swizzled)
+			{
+				convert_linear_swizzle_impl<texel_t<Size>, true>(input_pixels, output_pixels, width, height, pitch);
+			}
+			else
+			{
+				convert_linear_swizzle_impl<texel_t<Size>, false>(input_pixels, output_pixels, width, height, pitch);
+			}
+		};
+
+		switch (texel_size)
+		{
+		case 1: convert.template operator()<1>(); break;
+		case 2: convert.template operator()<2>(); break;
+		case 4: convert.template operator()<4>(); break;
+		case 8: convert.template operator()<8>(); break;
+		case 16: convert.template operator()<16>(); break;
+		default: fmt::throw_exception("Unsupported texel size %u", texel_size);
+		}
+	}
+
+	void convert_linear_swizzle_3d(const void* input_pixels, void* output_pixels, u16 width, u16 height, u16 depth, u32 texel_size)
+	{
+		if (depth == 1)
+		{
+			convert_linear_swizzle(input_pixels, output_pixels, width, height, width * texel_size, texel_size, true);
+			return;
+		}
+
+		if (!width || !height || !depth)
+		{
+			return;
+		}
+
+		switch (texel_size)
+		{
+		case 1: convert_linear_swizzle_3d_impl<texel_t<1>>(input_pixels, output_pixels, width, height, depth); break;
+		case 2: convert_linear_swizzle_3d_impl<texel_t<2>>(input_pixels, output_pixels, width, height, depth); break;
+		case 4: convert_linear_swizzle_3d_impl<texel_t<4>>(input_pixels, output_pixels, width, height, depth); break;
+		case 8: convert_linear_swizzle_3d_impl<texel_t<8>>(input_pixels, output_pixels, width, height, depth); break;
+		case 16: convert_linear_swizzle_3d_impl<texel_t<16>>(input_pixels, output_pixels, width, height, depth); break;
+		default: fmt::throw_exception("Unsupported texel size %u", texel_size);
+		}
+	}
+
 	void convert_scale_image(u8 *dst, AVPixelFormat dst_format, int dst_width, int dst_height, int dst_pitch,
 		const u8 *src, AVPixelFormat src_format, int src_width, int src_height, int src_pitch, int src_slice_h, bool bilinear)
 	{
@@ -2,6 +2,7 @@
 #include "VFS.h"
 #include "Utilities/bin_patch.h"
 #include "Emu/Memory/vm.h"
+#include "Emu/Memory/vm_reservation_stats.h"
 #include "Emu/System.h"
 #include "Emu/system_progress.hpp"
 #include "Emu/system_utils.hpp"
@@ -1567,6 +1568,8 @@ game_boot_result Emulator::Load(const std::string& title_id, bool is_disc_patch,
 			g_rtm_tx_limit2 = static_cast<u64>(g_cfg.core.tx_limit2_ns * _1ns);
 		}
 
+		vm::reservation_stats_reset(g_cfg.core.reservation_stats ? static_cast<u32>(g_cfg.core.reservation_stats_interval) : 0);
+
 		// Set bdvd_dir
 		std::string bdvd_dir = g_cfg_vfs.get(g_cfg_vfs.dev_bdvd, rpcs3::utils::get_emu_dir());
 		{
@@ -3250,6 +3253,9 @@ void Emulator::Kill(bool allow_autoexit, bool savestate, savestate_stage* save_s
 
 	// Signal threads
 
+	// Jobs which have not started yet (compilation, cache building) are not needed anymore
+	task_pool::cancel_all();
+
 	if (auto rsx = g_fxo->try_get<rsx::thread>())
 	{
 		*static_cast<cpu_thread*>(rsx) = thread_state::aborting;
@@ -3750,6 +3756,8 @@ void Emulator::Kill(bool allow_autoexit, bool savestate, savestate_stage* save_s
 			}
 		}
 
+		vm::reservation_stats_report();
+
 		set_progress_message("Resetting Objects");
 
 		// Final termination from main thread (move the last ownership of join thread in order to destroy it)
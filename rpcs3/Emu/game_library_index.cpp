@@ -0,0 +1,442 @@
+#include "stdafx.h"
+#include "game_library_index.h"
+#include "util/logs.hpp"
+#include "util/serialization.hpp"
+#include "util/fnv_hash.hpp"
+#include "Utilities/File.h"
+
+LOG_CHANNEL(sys_log, "SYS");
+
+// Bump when the layout of the serialized data changes
+static constexpr u32 c_index_version = 2;
+static const std::string c_index_magic = "RPCS3GLI";
+
+// File layout: data size, data checksum, data
+struct index_prefix
+{
+	u64 size;
+	u64 checksum;
+};
+
+// Deserialization can't fail gracefully (it asserts on truncated data), so the data is checked first
+static u64 get_index_checksum(const std::vector<u8>& data)
+{
+	usz hash = rpcs3::fnv_seed;
+	usz i = 0;
+
+	for (; i + sizeof(u64) <= data.size(); i += sizeof(u64))
+	{
+		hash = rpcs3::hash64(hash, read_from_ptr<u64>(data, i));
+	}
+
+	for (; i < data.size(); i++)
+	{
+		hash = rpcs3::hash64(hash, data[i]);
+	}
+
+	return hash;
+}
+
+// Check whether 'path' is 'dir' or inside of it (/games/BLUS10 is not inside of /games/BLUS1)
+static bool is_path_in_dir(std::string_view path, std::string_view dir)
+{
+	if (!path.starts_with(dir))
+	{
+		return false;
+	}
+
+	return path.size() == dir.size() || dir.ends_with('/') || dir.ends_with('\\') || path[dir.size()] == '/' || path[dir.size()] == '\\';
+}
+
+// Icons larger than this are not cached (ICON0.PNG is 320x176)
+static constexpr u64 c_max_icon_size = 4 * 1024 * 1024;
+
+game_library_index::game_library_index(std::string path)
+	: m_path(path.empty() ? get_default_path() : std::move(path))
+{
+}
+
+std::string game_library_index::get_default_path()
+{
+	return fs::get_cache_dir() + "game_library.dat";
+}
+
+bool game_library_index::load()
+{
+	fs::file file(m_path);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	index_prefix prefix{};
+
+	// Also rejects files of older versions, which had no prefix
+	if (!file.read(prefix) || prefix.size != file.size() - sizeof(prefix))
+	{
+		sys_log.notice("Game library index '%s' is outdated, rebuilding", m_path);
+		return false;
+	}
+
+	std::vector<u8> data(prefix.size);
+
+	if (file.read(data.data(), data.size()) != data.size() || get_index_checksum(data) != prefix.checksum)
+	{
+		sys_log.error("Game library index '%s' is corrupted, rebuilding", m_path);
+		return false;
+	}
+
+	utils::serial ar;
+	ar.set_reading_state(std::move(data));
+
+	std::string magic;
+	u32 version = 0;
+	ar(magic, version);
+
+	if (magic != c_index_magic || version != c_index_version)
+	{
+		sys_log.notice("Game library index '%s' is outdated, rebuilding", m_path);
+		return false;
+	}
+
+	std::map<std::string, std::shared_ptr<const entry>, std::less<>> entries;
+	std::map<std::string, std::shared_ptr<const size_entry>, std::less<>> sizes;
+
+	for (usz i = 0, count = ar.pop<usz>(); i < count; i++)
+	{
+		std::string dir;
+		std::vector<u8> sfo;
+		auto e = std::make_shared<entry>();
+
+		ar(dir, e->dir_mtime, e->sfo_mtime, e->sfo_size, sfo, e->language, e->icon_name, e->icon_mtime, e->icon, e->movie_name);
+
+		if (!sfo.empty())
+		{
+			e->sfo = psf::load_object(fs::make_stream(std::move(sfo)), dir + "/PARAM.SFO");
+		}
+
+		entries.insert_or_assign(std::move(dir), std::move(e));
+	}
+
+	for (usz i = 0, count = ar.pop<usz>(); i < count; i++)
+	{
+		std::string dir;
+		auto size = std::make_shared<size_entry>();
+
+		ar(dir, size->size);
+		size->dirs.resize(ar.pop<usz>());
+
+		for (auto& [name, mtime] : size->dirs)
+		{
+			ar(name, mtime);
+		}
+
+		sizes.insert_or_assign(std::move(dir), std::move(size));
+	}
+
+	std::lock_guard lock(m_mutex);
+	m_entries = std::move(entries);
+	m_sizes = std::move(sizes);
+	m_used.clear();
+	m_dirty = false;
+
+	sys_log.notice("Loaded game library index '%s' (%u entries)", m_path, m_entries.size());
+	return true;
+}
+
+void game_library_index::load_once()
+{
+	std::call_once(m_load_once, [this]()
+	{
+		load();
+	});
+}
+
+bool game_library_index::save()
+{
+	utils::serial ar;
+
+	{
+		reader_lock lock(m_mutex);
+
+		if (!m_dirty)
+		{
+			return true;
+		}
+
+		ar(c_index_magic, c_index_version, usz{m_entries.size()});
+
+		for (const auto& [dir, e] : m_entries)
+		{
+			ar(dir, e->dir_mtime, e->sfo_mtime, e->sfo_size, e->sfo.empty() ? std::vector<u8>{} : psf::save_object(e->sfo), e->language, e->icon_name, e->icon_mtime, e->icon, e->movie_name);
+		}
+
+		ar(usz{m_sizes.size()});
+
+		for (const auto& [dir, size] : m_sizes)
+		{
+			ar(dir, size->size, usz{size->dirs.size()});
+
+			for (const auto& [name, mtime] : size->dirs)
+			{
+				ar(name, mtime);
+			}
+		}
+	}
+
+	const index_prefix prefix{ar.data.size(), get_index_checksum(ar.data)};
+
+	fs::pending_file file(m_path);
+
+	if (!file.file || file.file.write(&prefix, sizeof(prefix)) != sizeof(prefix) || file.file.write(ar.data.data(), ar.data.size()) != ar.data.size() || !file.commit())
+	{
+		sys_log.error("Failed to save game library index '%s' (%s)", m_path, fs::g_tls_error);
+		return false;
+	}
+
+	std::lock_guard lock(m_mutex);
+	m_dirty = false;
+	return true;
+}
+
+std::shared_ptr<const game_library_index::entry> game_library_index::get(const std::string& sfo_dir, s32 language)
+{
+	load_once();
+
+	const std::string sfo_path = sfo_dir + "/PARAM.SFO";
+
+	fs::stat_t dir_stat{};
+	fs::stat_t sfo_stat{};
+
+	if (!fs::get_stat(sfo_dir, dir_stat))
+	{
+		dir_stat = {};
+	}
+
+	const bool has_sfo = fs::get_stat(sfo_path, sfo_stat) && !sfo_stat.is_directory;
+
+	if (!has_sfo)
+	{
+		sfo_stat = {};
+	}
+
+	std::shared_ptr<const entry> cached;
+	{
+		reader_lock lock(m_mutex);
+
+		if (const auto found = m_entries.find(sfo_dir); found != m_entries.cend())
+		{
+			cached = found->second;
+		}
+	}
+
+	if (cached && cached->language == language && cached->dir_mtime == dir_stat.mtime && cached->sfo_mtime == sfo_stat.mtime && cached->sfo_size == sfo_stat.size)
+	{
+		// Icons may be replaced in place without touching the directory
+		fs::stat_t icon_stat{};
+
+		if (cached->icon_name.empty() || (fs::get_stat(sfo_dir + "/" + cached->icon_name, icon_stat) && icon_stat.mtime == cached->icon_mtime))
+		{
+			std::lock_guard lock(m_mutex);
+			m_used.emplace(sfo_dir);
+			return cached;
+		}
+	}
+
+	auto result = std::make_shared<entry>();
+	result->dir_mtime = dir_stat.mtime;
+	result->sfo_mtime = sfo_stat.mtime;
+	result->sfo_size = sfo_stat.size;
+	result->language = language;
+
+	if (has_sfo)
+	{
+		result->sfo = psf::load_object(sfo_path);
+	}
+
+	for (std::string name : {fmt::format("ICON0_%02d.PNG", language), std::string("ICON0.PNG")})
+	{
+		fs::file icon;
+
+		if (fs::stat_t icon_stat{}; fs::get_stat(sfo_dir + "/" + name, icon_stat) && !icon_stat.is_directory)
+		{
+			if (icon_stat.size <= c_max_icon_size && icon.open(sfo_dir + "/" + name))
+			{
+				result->icon = icon.to_vector<u8>();
+			}
+
+			result->icon_name = std::move(name);
+			result->icon_mtime = icon_stat.mtime;
+			break;
+		}
+	}
+
+	for (std::string name : {fmt::format("ICON1_%02d.PAM", language), std::string("ICON1.PAM")})
+	{
+		if (fs::is_file(sfo_dir + "/" + name))
+		{
+			result->movie_name = std::move(name);
+			break;
+		}
+	}
+
+	std::lock_guard lock(m_mutex);
+
+	// Updates usually rewrite PARAM.SFO, recalculate the size of the game containing this directory
+	for (auto it = m_sizes.begin(); it != m_sizes.end();)
+	{
+		if (is_path_in_dir(sfo_dir, it->first))
+		{
+			it = m_sizes.erase(it);
+			continue;
+		}
+
+		it++;
+	}
+
+	m_entries.insert_or_assign(sfo_dir, result);
+	m_used.emplace(sfo_dir);
+	m_dirty = true;
+	return result;
+}
+
+u64 game_library_index::get_size_on_disk(const std::string& path)
+{
+	load_once();
+
+	std::shared_ptr<const size_entry> cached;
+	{
+		reader_lock lock(m_mutex);
+
+		if (const auto found = m_sizes.find(path); found != m_sizes.cend())
+		{
+			cached = found->second;
+		}
+	}
+
+	if (!cached)
+	{
+		return umax;
+	}
+
+	// Adding, removing or renaming a file anywhere in the game updates the modification time of its parent directory
+	for (const auto& [name, mtime] : cached->dirs)
+	{
+		fs::stat_t stat{};
+
+		if (!fs::get_stat(path + name, stat) || !stat.is_directory || stat.mtime != mtime)
+		{
+			return umax;
+		}
+	}
+
+	return cached->size;
+}
+
+u64 game_library_index::calc_size_on_disk(const std::string& path, atomic_t<bool>* cancel_flag)
+{
+	load_once();
+
+	auto result = std::make_shared<size_entry>();
+	result->size = 0;
+
+	// Same as fs::get_dir_size, directories are stat'ed before being listed so that a concurrent change invalidates the result
+	for (std::vector<std::string> queue{std::string{}}; !queue.empty();)
+	{
+		const std::string name = std::move(queue.back());
+		queue.pop_back();
+
+		fs::stat_t stat{};
+		fs::dir dir;
+
+		if (!fs::get_stat(path + name, stat) || !dir.open(path + name))
+		{
+			return umax;
+		}
+
+		result->dirs.emplace_back(name, stat.mtime);
+
+		for (const fs::dir_entry& entry : dir)
+		{
+			if (cancel_flag && *cancel_flag)
+			{
+				return umax;
+			}
+
+			if (entry.name == "." || entry.name == "..")
+			{
+				continue;
+			}
+
+			if (entry.is_directory)
+			{
+				queue.emplace_back(name + "/" + entry.name);
+				continue;
+			}
+
+			result->size += entry.size;
+		}
+	}
+
+	const u64 size = result->size;
+
+	std::lock_guard lock(m_mutex);
+	m_sizes.insert_or_assign(path, std::move(result));
+	m_dirty = true;
+	return size;
+}
+
+void game_library_index::prune()
+{
+	std::lock_guard lock(m_mutex);
+
+	const usz old_count = m_entries.size();
+
+	for (auto it = m_entries.begin(); it != m_entries.end();)
+	{
+		if (!m_used.contains(it->first))
+		{
+			it = m_entries.erase(it);
+			continue;
+		}
+
+		it++;
+	}
+
+	// Keep sizes of games with at least one directory in use (the game path contains its PARAM.SFO directory)
+	for (auto it = m_sizes.begin(); it != m_sizes.end();)
+	{
+		bool used = false;
+
+		for (auto dir = m_used.lower_bound(it->first); !used && dir != m_used.cend() && dir->starts_with(it->first); dir++)
+		{
+			used = is_path_in_dir(*dir, it->first);
+		}
+
+		if (!used)
+		{
+			it = m_sizes.erase(it);
+			m_dirty = true;
+			continue;
+		}
+
+		it++;
+	}
+
+	if (m_entries.size() != old_count)
+	{
+		sys_log.notice("Game library index: removed %u unused entries", old_count - m_entries.size());
+		m_dirty = true;
+	}
+
+	m_used.clear();
+}
+
+std::map<std::string, std::shared_ptr<const game_library_index::entry>> game_library_index::get_entries()
+{
+	load_once();
+
+	reader_lock lock(m_mutex);
+	return {m_entries.begin(), m_entries.end()};
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Utilities/mutex.h"
+#include "Loader/PSF.h"
+
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Persistent cache of game directory metadata (PARAM.SFO, icon, size on disk) keyed by path.
+// An entry is revalidated against the modification times of its directory, PARAM.SFO and icon,
+// so refreshing an unchanged library only needs a few stat calls per title instead of reading files.
+// Sizes on disk are revalidated against the modification times of every directory of the game.
+class game_library_index
+{
+public:
+	struct entry
+	{
+		s64 dir_mtime = 0;
+		s64 sfo_mtime = 0;
+		u64 sfo_size = 0;
+		psf::registry sfo; // Empty if the directory has no valid PARAM.SFO
+
+		s32 language = -1; // Language used to resolve localized file names
+		std::string icon_name; // ICON0_XX.PNG or ICON0.PNG, empty if none exists
+		s64 icon_mtime = 0;
+		std::vector<u8> icon; // Icon file contents (ICON0.PNG is already thumbnail sized)
+		std::string movie_name; // ICON1_XX.PAM or ICON1.PAM, empty if none exists
+	};
+
+	explicit game_library_index(std::string path = {});
+	game_library_index(const game_library_index&) = delete;
+	game_library_index& operator=(const game_library_index&) = delete;
+
+	// Default location in the cache directory
+	static std::string get_default_path();
+
+	bool save();
+
+	// Get up-to-date metadata of a directory containing PARAM.SFO, rereading only what changed since it was indexed
+	std::shared_ptr<const entry> get(const std::string& sfo_dir, s32 language);
+
+	// Size of a game directory as previously calculated with calc_size_on_disk, umax if unknown or outdated
+	u64 get_size_on_disk(const std::string& path);
+
+	// Calculate the size of a game directory and remember the modification times of all its directories to validate it
+	u64 calc_size_on_disk(const std::string& path, atomic_t<bool>* cancel_flag = nullptr);
+
+	// Drop entries not accessed with get() since the last prune or load (removed games)
+	void prune();
+
+	// Snapshot of all indexed directories without revalidation (for headless tooling)
+	std::map<std::string, std::shared_ptr<const entry>> get_entries();
+
+	bool is_dirty() const { return m_dirty; }
+
+private:
+	struct size_entry
+	{
+		u64 size = umax;
+		std::vector<std::pair<std::string, s64>> dirs; // Relative path (empty for the game directory) and modification time of every directory
+	};
+
+	// The index is loaded on first use instead of on construction (it contains every icon)
+	bool load();
+	void load_once();
+
+	std::string m_path;
+	std::once_flag m_load_once;
+	std::map<std::string, std::shared_ptr<const entry>, std::less<>> m_entries;
+	std::map<std::string, std::shared_ptr<const size_entry>, std::less<>> m_sizes;
+	std::set<std::string, std::less<>> m_used; // Directories accessed since load
+	mutable shared_mutex m_mutex;
+	bool m_dirty = false;
+};
@@ -153,7 +153,7 @@ std::vector<version_entry> get_savestate_versioning_data(fs::file&& file, std::s
 		return {};
 	}
 
-	ar.seek_pos(offs);
+	ar.seek_pos(offs, true);
 	ar.breathe(true);
 
 	std::vector<version_entry> ver_data = ar.pop<std::vector<version_entry>>();
@@ -28,6 +28,8 @@ struct cfg_root : cfg::node
 		cfg::_int<0, 1024> llvm_threads{ this, "Max LLVM Compile Threads", 0 };
 		cfg::_bool ppu_llvm_greedy_mode{ this, "PPU LLVM Greedy Mode", false, false };
 		cfg::_bool llvm_precompilation{ this, "LLVM Precompilation", true };
+		cfg::_bool ppu_llvm_tiered_compilation{ this, "PPU LLVM Tiered Compilation", false }; // Start the main executable on the interpreter while it is compiled in the background
+		cfg::_bool ppu_analysis_cache{ this, "PPU Analysis Cache", true }; // Reuse PPU module analysis results of previous boots with the same build (not for local builds)
 		cfg::_enum<thread_scheduler_mode> thread_scheduler{this, "Thread Scheduler Mode", thread_scheduler_mode::os};
 		cfg::_bool set_daz_and_ftz{ this, "Set DAZ and FTZ", false };
 		cfg::_enum<spu_decoder_type> spu_decoder{ this, "SPU Decoder", spu_decoder_type::llvm };
@@ -101,6 +103,8 @@ struct cfg_root : cfg::node
 
 		cfg::uint64 perf_report_threshold{this, "Performance Report Threshold", 500, true}; // In µs, 0.5ms = default, 0 = everything
 		cfg::_bool perf_report{this, "Enable Performance Report", false, true}; // Show certain perf-related logs
+		cfg::_bool reservation_stats{this, "Enable Reservation Contention Statistics", false}; // Sample per cache line reservation contention, reported on stop
+		cfg::uint<1, 65536> reservation_stats_interval{this, "Reservation Statistics Sampling Interval", 16}; // Record one of N reservation operations per thread
 		cfg::_bool external_debugger{this, "Assume External Debugger"};
 	} core{ this };
 
@@ -156,9 +160,11 @@ struct cfg_root : cfg::node
 		cfg::_bool frame_skip_enabled{ this, "Enable Frame Skip", false, true };
 		cfg::_bool force_cpu_blit_processing{ this, "Force CPU Blit", false, true }; // Debugging option
 		cfg::_bool disable_on_disk_shader_cache{ this, "Disable On-Disk Shader Cache", false };
+		cfg::_bool disable_spirv_cache{ this, "Disable SPIR-V Cache", false };
 		cfg::_bool disable_vulkan_mem_allocator{ this, "Disable Vulkan Memory Allocator", false };
 		cfg::_bool full_rgb_range_output{ this, "Use full RGB output range", true, true }; // Video out dynamic range
 		cfg::_bool strict_texture_flushing{ this, "Strict Texture Flushing", false };
+		cfg::_bool deduplicate_texture_uploads{ this, "Deduplicate Texture Uploads", false, true };
 		cfg::_bool multithreaded_rsx{ this, "Multithreaded RSX", false };
 		cfg::_bool relaxed_zcull_sync{ this, "Relaxed ZCULL Sync", false };
 		cfg::_bool force_hw_MSAA_resolve{ this, "Force Hardware MSAA Resolve", false, true };
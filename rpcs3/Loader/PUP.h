@@ -64,5 +64,6 @@ public:
 	explicit operator pup_error() const { return m_error; }
 	const std::string& get_formatted_error() const { return m_formatted_error; }
 
+	// Returns a view of the entry data, only valid while this object is alive
 	fs::file get_file(u64 entry_id) const;
 };
@@ -48,6 +48,11 @@ void game_list_base::IconLoadFunction(game_info game, qreal device_pixel_ratio,
 	static std::unordered_set<std::string> warn_once_list;
 	static shared_mutex s_mtx;
 
+	if (game->icon.isNull() && game->icon_data && !game->icon_data->empty())
+	{
+		game->icon.loadFromData(game->icon_data->data(), ::narrow<uint>(game->icon_data->size()));
+	}
+
 	if (game->icon.isNull() && (game->info.icon_path.empty() || !game->icon.load(QString::fromStdString(game->info.icon_path))))
 	{
 		if (game_list_log.warning)
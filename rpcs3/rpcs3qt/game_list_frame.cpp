@@ -17,6 +17,7 @@
 #include "Emu/System.h"
 #include "Emu/vfs_config.h"
 #include "Emu/system_utils.hpp"
+#include "Emu/game_library_index.h"
 #include "Loader/PSF.h"
 #include "util/types.hpp"
 #include "Utilities/File.h"
@@ -65,6 +66,9 @@ game_list_frame::game_list_frame(std::shared_ptr<gui_settings> gui_settings, std
 
 	m_old_layout_is_list = m_is_list_layout;
 
+	// Loaded by the first refresh on a worker thread
+	m_library_index = std::make_unique<game_library_index>();
+
 	// Save factors for first setup
 	m_gui_settings->SetValue(gui::gl_iconColor, m_icon_color, false);
 	m_gui_settings->SetValue(gui::gl_marginFactor, m_margin_factor, false);
@@ -236,6 +240,7 @@ game_list_frame::~game_list_frame()
 	WaitAndAbortRepaintThreads();
 	gui::utils::stop_future_watcher(m_parsing_watcher, true);
 	gui::utils::stop_future_watcher(m_refresh_watcher, true);
+	m_library_index->save();
 }
 
 void game_list_frame::OnColClicked(int col)
@@ -565,10 +570,8 @@ void game_list_frame::OnParsingFinished()
 	const s32 language_index = gui_application::get_language_id();
 	const std::string game_icon_path = fs::get_config_dir() + "/Icons/game_icons/";
 	const std::string localized_title = fmt::format("TITLE_%02d", language_index);
-	const std::string localized_icon = fmt::format("ICON0_%02d.PNG", language_index);
-	const std::string localized_movie = fmt::format("ICON1_%02d.PAM", language_index);
 
-	const auto add_game = [this, localized_title, localized_icon, localized_movie, dev_flash, cat_unknown_localized = localized.category.unknown.toStdString(), cat_unknown = cat::cat_unknown.toStdString(), game_icon_path, _hdd, play_hover_movies = m_play_hover_movies, show_custom_icons = m_show_custom_icons](const std::string& dir_or_elf)
+	const auto add_game = [this, language_index, localized_title, dev_flash, cat_unknown_localized = localized.category.unknown.toStdString(), cat_unknown = cat::cat_unknown.toStdString(), game_icon_path, _hdd, play_hover_movies = m_play_hover_movies, show_custom_icons = m_show_custom_icons](const std::string& dir_or_elf)
 	{
 		gui_game_info game{};
 		game.info.path = dir_or_elf;
@@ -576,7 +579,8 @@ void game_list_frame::OnParsingFinished()
 		const Localized thread_localized;
 
 		const std::string sfo_dir = rpcs3::utils::get_sfo_dir_from_game_path(dir_or_elf);
-		const psf::registry psf = psf::load_object(sfo_dir + "/PARAM.SFO");
+		const auto library_entry = m_library_index->get(sfo_dir, language_index);
+		const psf::registry& psf = library_entry->sfo;
 		const std::string_view title_id = psf::get_string(psf, "TITLE_ID", "");
 
 		if (title_id.empty())
@@ -644,14 +648,8 @@ void game_list_frame::OnParsingFinished()
 
 		if (game.info.icon_path.empty())
 		{
-			if (std::string icon_path = sfo_dir + "/" + localized_icon; fs::is_file(icon_path))
-			{
-				game.info.icon_path = std::move(icon_path);
-			}
-			else
-			{
-				game.info.icon_path = sfo_dir + "/ICON0.PNG";
-			}
+			game.info.icon_path = sfo_dir + "/" + (library_entry->icon_name.empty() ? "ICON0.PNG" : library_entry->icon_name);
+			game.icon_data = std::shared_ptr<const std::vector<u8>>(library_entry, &library_entry->icon);
 		}
 
 		if (std::string movie_path = game_icon_path + game.info.serial + "/hover.gif"; fs::is_file(movie_path))
@@ -659,14 +657,9 @@ void game_list_frame::OnParsingFinished()
 			game.info.movie_path = std::move(movie_path);
 			game.has_hover_gif = true;
 		}
-		else if (std::string movie_path = sfo_dir + "/" + localized_movie; fs::is_file(movie_path))
-		{
-			game.info.movie_path = std::move(movie_path);
-			game.has_hover_pam = true;
-		}
-		else if (std::string movie_path = sfo_dir + "/ICON1.PAM"; fs::is_file(movie_path))
+		else if (!library_entry->movie_name.empty())
 		{
-			game.info.movie_path = std::move(movie_path);
+			game.info.movie_path = sfo_dir + "/" + library_entry->movie_name;
 			game.has_hover_pam = true;
 		}
 
@@ -836,8 +829,6 @@ void game_list_frame::OnRefreshFinished()
 	const Localized localized;
 	const std::string cat_unknown_localized = localized.category.unknown.toStdString();
 	const s32 language_index = gui_application::get_language_id();
-	const std::string localized_icon = fmt::format("ICON0_%02d.PNG", language_index);
-	const std::string localized_movie = fmt::format("ICON1_%02d.PAM", language_index);
 
 	// Try to update the app version for disc games if there is a patch
 	// Also try to find updated game icons and movies
@@ -870,30 +861,19 @@ void game_list_frame::OnRefreshFinished()
 				}
 			}
 
+			const auto other_entry = m_library_index->get(other->info.path, language_index);
+
 			// Let's fetch the game data icon if preferred or if the path was empty for some reason
-			if ((m_prefer_game_data_icons && !entry->has_custom_icon) || entry->info.icon_path.empty())
+			if (((m_prefer_game_data_icons && !entry->has_custom_icon) || entry->info.icon_path.empty()) && !other_entry->icon_name.empty())
 			{
-				if (std::string icon_path = other->info.path + "/" + localized_icon; fs::is_file(icon_path))
-				{
-					entry->info.icon_path = std::move(icon_path);
-				}
-				else if (std::string icon_path = other->info.path + "/ICON0.PNG"; fs::is_file(icon_path))
-				{
-					entry->info.icon_path = std::move(icon_path);
-				}
+				entry->info.icon_path = other->info.path + "/" + other_entry->icon_name;
+				entry->icon_data = std::shared_ptr<const std::vector<u8>>(other_entry, &other_entry->icon);
 			}
 
 			// Let's fetch the game data movie if preferred or if the path was empty
-			if (m_prefer_game_data_icons || entry->info.movie_path.empty())
+			if ((m_prefer_game_data_icons || entry->info.movie_path.empty()) && !other_entry->movie_name.empty())
 			{
-				if (std::string movie_path = other->info.path + "/" + localized_movie; fs::is_file(movie_path))
-				{
-					entry->info.movie_path = std::move(movie_path);
-				}
-				else if (std::string movie_path = other->info.path + "/ICON1.PAM"; fs::is_file(movie_path))
-				{
-					entry->info.movie_path = std::move(movie_path);
-				}
+				entry->info.movie_path = other->info.path + "/" + other_entry->movie_name;
 			}
 		}
 	}
@@ -915,6 +895,10 @@ void game_list_frame::OnRefreshFinished()
 	m_path_list.clear();
 	m_path_entries.clear();
 
+	// Forget games which were not found anymore and persist the metadata for the next start
+	m_library_index->prune();
+	m_library_index->save();
+
 	Refresh();
 
 	if (!std::exchange(m_initial_refresh_done, true))
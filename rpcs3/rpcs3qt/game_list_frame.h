@@ -26,6 +26,7 @@ class gui_settings;
 class emu_settings;
 class persistent_settings;
 class progress_dialog;
+class game_library_index;
 
 class game_list_frame : public custom_dock_widget
 {
@@ -57,6 +58,8 @@ public:
 
 	game_compatibility* GetGameCompatibility() const { return m_game_compat; }
 
+	game_library_index& GetLibraryIndex() const { return *m_library_index; }
+
 	const std::vector<game_info>& GetGameInfo() const;
 
 	void CreateShortcuts(const std::vector<game_info>& games, const std::set<gui::utils::shortcut_location>& locations);
@@ -198,6 +201,7 @@ private:
 	const std::array<int, 1> m_parsing_threads{0};
 	QFutureWatcher<void> m_parsing_watcher;
 	QFutureWatcher<void> m_refresh_watcher;
+	std::unique_ptr<game_library_index> m_library_index;
 	QSet<QString> m_hidden_list;
 	bool m_show_hidden{false};
 
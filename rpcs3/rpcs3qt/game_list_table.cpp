@@ -9,6 +9,7 @@
 #include "qt_utils.h"
 
 #include "Emu/vfs_config.h"
+#include "Emu/game_library_index.h"
 #include "Utilities/StrUtil.h"
 
 #include <QHeaderView>
@@ -277,9 +278,13 @@ void game_list_table::populate(
 					// Do not report size of apps inside /dev_flash (it does not make sense to do so)
 					game->info.size_on_disk = 0;
 				}
+				else if (const u64 size = m_game_list_frame->GetLibraryIndex().get_size_on_disk(game->info.path); size != umax)
+				{
+					game->info.size_on_disk = size;
+				}
 				else
 				{
-					game->info.size_on_disk = fs::get_dir_size(game->info.path, 1, cancel.get());
+					game->info.size_on_disk = m_game_list_frame->GetLibraryIndex().calc_size_on_disk(game->info.path, cancel.get());
 				}
 
 				if (!cancel || !cancel->load())
@@ -14,6 +14,7 @@ struct gui_game_info
 	QString localized_category;
 	compat::status compat;
 	QPixmap icon;
+	std::shared_ptr<const std::vector<u8>> icon_data; // Cached contents of info.icon_path
 	QPixmap pxmap;
 	bool has_custom_config = false;
 	bool has_custom_pad_config = false;
@@ -23,6 +23,8 @@ ipc_settings_dialog::ipc_settings_dialog(QWidget* parent)
 	QVBoxLayout* vbox_global = new QVBoxLayout();
 
 	QCheckBox* checkbox_server_enabled = new QCheckBox(tr("Enable IPC Server"));
+	QCheckBox* checkbox_memory_sharing = new QCheckBox(tr("Share main memory with local tools (read-only)"));
+	checkbox_memory_sharing->setToolTip(tr("Allows tools connected to the IPC server to map the guest main memory instead of requesting every read.\nOnly supported on Linux."));
 
 	QGroupBox* group_server_port = new QGroupBox(tr("IPC Server Port"));
 	QHBoxLayout* hbox_group_port = new QHBoxLayout();
@@ -36,12 +38,13 @@ ipc_settings_dialog::ipc_settings_dialog(QWidget* parent)
 	group_server_port->setLayout(hbox_group_port);
 
 	vbox_global->addWidget(checkbox_server_enabled);
+	vbox_global->addWidget(checkbox_memory_sharing);
 	vbox_global->addWidget(group_server_port);
 	vbox_global->addWidget(buttons);
 
 	setLayout(vbox_global);
 
-	connect(buttons, &QDialogButtonBox::accepted, this, [this, checkbox_server_enabled, line_edit_server_port]()
+	connect(buttons, &QDialogButtonBox::accepted, this, [this, checkbox_server_enabled, checkbox_memory_sharing, line_edit_server_port]()
 		{
 			bool ok = true;
 			const bool server_enabled = checkbox_server_enabled->isChecked();
@@ -55,6 +58,7 @@ ipc_settings_dialog::ipc_settings_dialog(QWidget* parent)
 
 			g_cfg_ipc.set_server_enabled(server_enabled);
 			g_cfg_ipc.set_port(server_port);
+			g_cfg_ipc.set_memory_sharing_enabled(checkbox_memory_sharing->isChecked());
 			g_cfg_ipc.save();
 
 			if (auto manager = g_fxo->try_get<IPC_socket::IPC_server_manager>())
@@ -74,5 +78,6 @@ ipc_settings_dialog::ipc_settings_dialog(QWidget* parent)
 	g_cfg_ipc.load();
 
 	checkbox_server_enabled->setChecked(g_cfg_ipc.get_server_enabled());
+	checkbox_memory_sharing->setChecked(g_cfg_ipc.get_memory_sharing_enabled());
 	line_edit_server_port->setText(QString::number(g_cfg_ipc.get_port()));
 }
@@ -1446,8 +1446,12 @@ void main_window::HandlePupInstallation(const QString& file_path, const QString&
 		return;
 	}
 
+	const auto validation_start = std::chrono::steady_clock::now();
+
 	pup_object pup(std::move(pup_f));
 
+	const auto validation_end = std::chrono::steady_clock::now();
+
 	switch (pup.operator pup_error())
 	{
 	case pup_error::header_read:
@@ -1608,54 +1612,108 @@ void main_window::HandlePupInstallation(const QString& file_path, const QString&
 
 	// Synchronization variable
 	atomic_t<uint> progress(0);
+
+	// Time spent in each stage in microseconds, summed over all threads
+	atomic_t<u64> read_time = 0;
+	atomic_t<u64> decrypt_time = 0;
+	atomic_t<u64> extract_time = 0;
+
+	const u32 thread_count = std::max<u32>(std::min<u32>(task_pool::get_thread_limit(), ::size32(update_filenames)), 1);
+	const auto install_start = std::chrono::steady_clock::now();
 	{
 		// Run asynchronously
 		named_thread worker("Firmware Installer", [&]
 		{
-			for (const auto& update_filename : update_filenames)
+			atomic_t<usz> next_package = 0;
+
+			const auto elapsed_us = [](std::chrono::steady_clock::time_point& since)
 			{
-				auto update_file_stream = update_files.get_file(update_filename);
+				const auto now = std::chrono::steady_clock::now();
+				return static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(now - std::exchange(since, now)).count());
+			};
 
-				if (update_file_stream->m_file_handler)
+			// Packages are independent, each thread decrypts and extracts whole packages
+			// The main TAR has been fully scanned already so concurrent get_file calls only look up entries
+			const auto install_worker = [&]()
+			{
+				for (usz i = next_package++; i < update_filenames.size(); i = next_package++)
 				{
-					// Forcefully read all the data
-					update_file_stream->m_file_handler->handle_file_op(*update_file_stream, 0, update_file_stream->get_size(umax), nullptr);
-				}
+					if (progress >= update_filenames.size())
+					{
+						// Installation was cancelled or failed
+						return;
+					}
 
-				fs::file update_file = fs::make_stream(std::move(update_file_stream->data));
+					const std::string& update_filename = update_filenames[i];
 
-				SCEDecrypter self_dec(update_file);
-				self_dec.LoadHeaders();
-				self_dec.LoadMetadata(SCEPKG_ERK, SCEPKG_RIV);
-				self_dec.DecryptData();
+					auto stage_start = std::chrono::steady_clock::now();
 
-				auto dev_flash_tar_f = self_dec.MakeFile();
-				if (dev_flash_tar_f.size() < 3)
-				{
-					gui_log.error("Error while installing firmware: PUP contents are invalid.");
-					critical(tr("Firmware installation failed: Firmware could not be decompressed"));
-					progress = -1;
-					return;
-				}
+					auto update_file_stream = update_files.get_file(update_filename);
 
-				tar_object dev_flash_tar(dev_flash_tar_f[2]);
-				if (!dev_flash_tar.extract())
-				{
-					gui_log.error("Error while installing firmware: TAR contents are invalid. (package=%s)", update_filename);
-					critical(tr("The firmware contents could not be extracted."
-						"\nThis is very likely caused by external interference from a faulty anti-virus software."
-						"\nPlease add RPCS3 to your anti-virus\' whitelist or use better anti-virus software."));
+					if (update_file_stream->m_file_handler)
+					{
+						// Forcefully read all the data
+						update_file_stream->m_file_handler->handle_file_op(*update_file_stream, 0, update_file_stream->get_size(umax), nullptr);
+					}
 
-					progress = -1;
-					return;
-				}
+					fs::file update_file = fs::make_stream(std::move(update_file_stream->data));
 
-				if (!progress.try_inc(::narrow<uint>(update_filenames.size())))
-				{
-					// Installation was cancelled
-					return;
+					read_time += elapsed_us(stage_start);
+
+					SCEDecrypter self_dec(update_file);
+					self_dec.LoadHeaders();
+					self_dec.LoadMetadata(SCEPKG_ERK, SCEPKG_RIV);
+					self_dec.DecryptData();
+
+					auto dev_flash_tar_f = self_dec.MakeFile();
+
+					decrypt_time += elapsed_us(stage_start);
+
+					if (dev_flash_tar_f.size() < 3)
+					{
+						gui_log.error("Error while installing firmware: PUP contents are invalid. (package=%s)", update_filename);
+
+						if (progress.exchange(-1) != umax)
+						{
+							critical(tr("Firmware installation failed: Firmware could not be decompressed"));
+						}
+
+						return;
+					}
+
+					tar_object dev_flash_tar(dev_flash_tar_f[2]);
+					if (!dev_flash_tar.extract())
+					{
+						gui_log.error("Error while installing firmware: TAR contents are invalid. (package=%s)", update_filename);
+
+						if (progress.exchange(-1) != umax)
+						{
+							critical(tr("The firmware contents could not be extracted."
+								"\nThis is very likely caused by external interference from a faulty anti-virus software."
+								"\nPlease add RPCS3 to your anti-virus\' whitelist or use better anti-virus software."));
+						}
+
+						return;
+					}
+
+					extract_time += elapsed_us(stage_start);
+
+					if (!progress.try_inc(::narrow<uint>(update_filenames.size())))
+					{
+						// Installation was cancelled
+						return;
+					}
 				}
-			}
+			};
+
+			// The installer thread participates as well
+			const auto job = task_pool::submit("Firmware Installer", thread_count - 1, task_priority::high, [&](task_job&, u32)
+			{
+				install_worker();
+			});
+
+			install_worker();
+			job->join();
 		});
 
 		// Wait for the completion
@@ -1687,6 +1745,13 @@ void main_window::HandlePupInstallation(const QString& file_path, const QString&
 
 	if (progress == update_filenames.size())
 	{
+		const auto install_end = std::chrono::steady_clock::now();
+		const auto to_sec = [](auto duration) { return std::chrono::duration<f64>(duration).count(); };
+
+		gui_log.notice("Firmware installation timings: PUP validation %.3fs, installation %.3fs on %u threads (read %.3fs, decryption %.3fs, extraction %.3fs summed over threads)",
+			to_sec(validation_end - validation_start), to_sec(install_end - install_start), thread_count,
+			read_time.load() / 1e6, decrypt_time.load() / 1e6, extract_time.load() / 1e6);
+
 		pdlg.SetValue(pdlg.maximum());
 		std::this_thread::sleep_for(100ms);
 	}
@@ -0,0 +1,307 @@
+#include "bench.h"
+
+#include "Utilities/File.h"
+#include "Utilities/StrFmt.h"
+#include "util/sysinfo.hpp"
+#include "rpcs3_version.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <map>
+
+namespace bench
+{
+	struct entry
+	{
+		std::string_view name;
+		bench_func func;
+	};
+
+	static std::vector<entry>& get_registry()
+	{
+		static std::vector<entry> s_registry;
+		return s_registry;
+	}
+
+	registrar::registrar(std::string_view name, bench_func func)
+	{
+		get_registry().emplace_back(entry{name, func});
+	}
+
+	static std::map<std::string, std::string, std::less<>> s_params;
+
+	std::string_view get_param(std::string_view name)
+	{
+		const auto found = s_params.find(name);
+		return found != s_params.end() ? std::string_view(found->second) : std::string_view{};
+	}
+
+	struct options
+	{
+		std::string filter;
+		std::string out_path;
+		u32 repetitions = 5;
+		u64 min_time_ns = 100'000'000;
+		bool list = false;
+	};
+
+	struct result
+	{
+		std::string_view name;
+		u64 iterations = 0;
+		u32 threads = 1;
+		std::vector<f64> samples; // ns per iteration, one per repetition
+		f64 items_per_iter = 0;
+		f64 bytes_per_iter = 0;
+		std::map<std::string, f64, std::less<>> counters; // From the last repetition
+		std::string skipped;
+	};
+
+	static f64 run_once(bench_func func, u64 iterations, result& res)
+	{
+		state st(iterations);
+
+		const auto start = std::chrono::steady_clock::now();
+		func(st);
+		const auto end = std::chrono::steady_clock::now();
+
+		res.threads = st.threads();
+		res.skipped = st.skip_reason();
+		res.items_per_iter = static_cast<f64>(st.items_processed()) / iterations;
+		res.bytes_per_iter = static_cast<f64>(st.bytes_processed()) / iterations;
+		res.counters = st.counters();
+
+		return static_cast<f64>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	}
+
+	static result run(const entry& e, const options& opts)
+	{
+		result res{};
+		res.name = e.name;
+
+		// Warm up and find an iteration count filling the requested time per repetition
+		u64 iterations = 1;
+
+		while (true)
+		{
+			const f64 elapsed = run_once(e.func, iterations, res);
+
+			if (!res.skipped.empty())
+			{
+				return res;
+			}
+
+			if (elapsed >= opts.min_time_ns / 10.0 || iterations >= (u64{1} << 40))
+			{
+				iterations = std::max<u64>(1, static_cast<u64>(iterations * (opts.min_time_ns / std::max(elapsed, 1.0))));
+				break;
+			}
+
+			iterations *= elapsed > 0 ? std::clamp<u64>(static_cast<u64>(opts.min_time_ns / 10.0 / elapsed), 2, 10) : 10;
+		}
+
+		res.iterations = iterations;
+
+		for (u32 i = 0; i < opts.repetitions; i++)
+		{
+			res.samples.push_back(run_once(e.func, iterations, res) / iterations);
+		}
+
+		return res;
+	}
+
+	static std::string escape(std::string_view str)
+	{
+		std::string out;
+
+		for (char c : str)
+		{
+			if (c == '"' || c == '\\')
+			{
+				out += '\\';
+			}
+
+			out += c;
+		}
+
+		return out;
+	}
+
+	static std::string to_json(const std::vector<result>& results, const options& opts)
+	{
+		const std::time_t now = std::time(nullptr);
+		char date[32]{};
+		std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+		std::string out = "{\n\t\"context\": {\n";
+		fmt::append(out, "\t\t\"date\": \"%s\",\n", date);
+		fmt::append(out, "\t\t\"version\": \"%s\",\n", escape(rpcs3::get_version_and_branch()));
+		fmt::append(out, "\t\t\"cpu\": \"%s\",\n", escape(utils::get_cpu_brand()));
+		fmt::append(out, "\t\t\"threads\": %u,\n", utils::get_thread_count());
+		fmt::append(out, "\t\t\"os\": \"%s\",\n", escape(utils::get_OS_version_string()));
+		fmt::append(out, "\t\t\"repetitions\": %u,\n", opts.repetitions);
+		fmt::append(out, "\t\t\"min_time_ns\": %u\n", opts.min_time_ns);
+		out += "\t},\n\t\"benchmarks\": [";
+
+		for (usz i = 0; i < results.size(); i++)
+		{
+			const result& res = results[i];
+
+			out += i ? ",\n" : "\n";
+
+			if (!res.skipped.empty())
+			{
+				fmt::append(out, "\t\t{\n\t\t\t\"name\": \"%s\",\n\t\t\t\"skipped\": \"%s\"\n\t\t}", escape(res.name), escape(res.skipped));
+				continue;
+			}
+
+			std::vector<f64> sorted = res.samples;
+			std::sort(sorted.begin(), sorted.end());
+
+			f64 mean = 0;
+			for (f64 v : sorted) mean += v;
+			mean /= sorted.size();
+
+			f64 var = 0;
+			for (f64 v : sorted) var += (v - mean) * (v - mean);
+			const f64 stddev = sorted.size() > 1 ? std::sqrt(var / (sorted.size() - 1)) : 0.;
+
+			const usz mid = sorted.size() / 2;
+			const f64 median = sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+
+			out += "\t\t{\n";
+			fmt::append(out, "\t\t\t\"name\": \"%s\",\n", escape(res.name));
+			fmt::append(out, "\t\t\t\"iterations\": %u,\n", res.iterations);
+			fmt::append(out, "\t\t\t\"threads\": %u,\n", res.threads);
+			fmt::append(out, "\t\t\t\"ns_per_iter_median\": %.3f,\n", median);
+			fmt::append(out, "\t\t\t\"ns_per_iter_min\": %.3f,\n", sorted.front());
+			fmt::append(out, "\t\t\t\"ns_per_iter_mean\": %.3f,\n", mean);
+			fmt::append(out, "\t\t\t\"ns_per_iter_stddev\": %.3f,\n", stddev);
+			fmt::append(out, "\t\t\t\"items_per_second\": %.1f,\n", median > 0 ? res.items_per_iter * 1e9 / median : 0.);
+			fmt::append(out, "\t\t\t\"bytes_per_second\": %.1f%s\n", median > 0 ? res.bytes_per_iter * 1e9 / median : 0., res.counters.empty() ? "" : ",");
+
+			if (!res.counters.empty())
+			{
+				out += "\t\t\t\"counters\": {";
+
+				for (auto it = res.counters.begin(); it != res.counters.end(); it++)
+				{
+					fmt::append(out, "%s\"%s\": %.6g", it == res.counters.begin() ? "" : ", ", escape(it->first), it->second);
+				}
+
+				out += "}\n";
+			}
+
+			out += "\t\t}";
+		}
+
+		out += "\n\t]\n}\n";
+		return out;
+	}
+}
+
+static void print_usage()
+{
+	std::fprintf(stderr,
+		"Usage: rpcs3_bench [options]\n"
+		"  --filter=<substr>  Only run benchmarks whose name contains <substr>\n"
+		"  --out=<path>       Write JSON results to <path> instead of stdout\n"
+		"  --reps=<n>         Repetitions per benchmark (default 5)\n"
+		"  --min-time=<ms>    Target duration of one repetition (default 100)\n"
+		"  --param=<k>=<v>    Benchmark specific input (e.g. shader_cache=<dir>)\n"
+		"  --list             List benchmark names and exit\n");
+}
+
+int main(int argc, char** argv)
+{
+	bench::options opts{};
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string_view arg = argv[i];
+
+		if (arg.starts_with("--filter="))
+		{
+			opts.filter = arg.substr(9);
+		}
+		else if (arg.starts_with("--out="))
+		{
+			opts.out_path = arg.substr(6);
+		}
+		else if (arg.starts_with("--reps="))
+		{
+			opts.repetitions = std::max(1, std::atoi(argv[i] + 7));
+		}
+		else if (arg.starts_with("--min-time="))
+		{
+			opts.min_time_ns = std::max<u64>(1, std::strtoull(argv[i] + 11, nullptr, 10)) * 1'000'000;
+		}
+		else if (arg.starts_with("--param=") && arg.find('=', 8) != umax)
+		{
+			const usz eq = arg.find('=', 8);
+			bench::s_params.insert_or_assign(std::string(arg.substr(8, eq - 8)), std::string(arg.substr(eq + 1)));
+		}
+		else if (arg == "--list")
+		{
+			opts.list = true;
+		}
+		else
+		{
+			print_usage();
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+	auto& registry = bench::get_registry();
+
+	// Stable order regardless of static initialization order across translation units
+	std::sort(registry.begin(), registry.end(), [](const bench::entry& a, const bench::entry& b) { return a.name < b.name; });
+
+	std::vector<bench::result> results;
+
+	for (const auto& e : registry)
+	{
+		if (!opts.filter.empty() && e.name.find(opts.filter) == umax)
+		{
+			continue;
+		}
+
+		if (opts.list)
+		{
+			std::printf("%.*s\n", static_cast<int>(e.name.size()), e.name.data());
+			continue;
+		}
+
+		std::fprintf(stderr, "Running %.*s...\n", static_cast<int>(e.name.size()), e.name.data());
+		results.emplace_back(bench::run(e, opts));
+
+		if (!results.back().skipped.empty())
+		{
+			std::fprintf(stderr, "Skipped: %s\n", results.back().skipped.c_str());
+		}
+	}
+
+	if (opts.list)
+	{
+		return 0;
+	}
+
+	const std::string json = bench::to_json(results, opts);
+
+	if (opts.out_path.empty())
+	{
+		std::fwrite(json.data(), 1, json.size(), stdout);
+		return 0;
+	}
+
+	if (!fs::write_file(opts.out_path, fs::rewrite, json))
+	{
+		std::fprintf(stderr, "Failed to write %s\n", opts.out_path.c_str());
+		return 1;
+	}
+
+	return 0;
+}
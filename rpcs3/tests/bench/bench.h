@@ -0,0 +1,132 @@
+#pragma once
+
+#include "util/types.hpp"
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Minimal microbenchmark harness for rpcs3_bench
+namespace bench
+{
+	class state
+	{
+		const u64 m_iterations;
+		u64 m_remaining;
+		u64 m_items = 0;
+		u64 m_bytes = 0;
+		u32 m_threads = 1;
+		std::map<std::string, f64, std::less<>> m_counters;
+		std::string m_skip_reason;
+
+	public:
+		explicit state(u64 iterations) noexcept
+			: m_iterations(iterations)
+			, m_remaining(iterations)
+		{
+		}
+
+		// Benchmark body loop: while (state.keep_running()) { ... }
+		bool keep_running() noexcept
+		{
+			return m_remaining-- != 0;
+		}
+
+		u64 iterations() const noexcept
+		{
+			return m_iterations;
+		}
+
+		// Work done over all iterations, used for throughput reporting
+		void set_items_processed(u64 items) noexcept
+		{
+			m_items = items;
+		}
+
+		void set_bytes_processed(u64 bytes) noexcept
+		{
+			m_bytes = bytes;
+		}
+
+		void set_threads(u32 threads) noexcept
+		{
+			m_threads = threads;
+		}
+
+		// Additional benchmark specific result (e.g. a failure rate), reported as is
+		void set_counter(std::string_view name, f64 value)
+		{
+			m_counters.insert_or_assign(std::string(name), value);
+		}
+
+		u64 items_processed() const noexcept
+		{
+			return m_items;
+		}
+
+		u64 bytes_processed() const noexcept
+		{
+			return m_bytes;
+		}
+
+		u32 threads() const noexcept
+		{
+			return m_threads;
+		}
+
+		const std::map<std::string, f64, std::less<>>& counters() const noexcept
+		{
+			return m_counters;
+		}
+
+		// Call before the loop if required input is unavailable; the body must then return without looping
+		void skip(std::string reason)
+		{
+			m_skip_reason = std::move(reason);
+		}
+
+		const std::string& skip_reason() const noexcept
+		{
+			return m_skip_reason;
+		}
+	};
+
+	using bench_func = void(*)(state&);
+
+	struct registrar
+	{
+		registrar(std::string_view name, bench_func func);
+	};
+
+	// Value passed on the command line as --param=<name>=<value>, empty if not set
+	std::string_view get_param(std::string_view name);
+
+	// Prevent the compiler from discarding a computed value
+	template <typename T>
+	inline void do_not_optimize(T&& value) noexcept
+	{
+#ifdef _MSC_VER
+		const volatile auto* ptr = &value;
+		static_cast<void>(*reinterpret_cast<const volatile char*>(ptr));
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	// Prevent the compiler from assuming memory is unchanged
+	inline void clobber_memory() noexcept
+	{
+#ifdef _MSC_VER
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : : "memory");
+#endif
+	}
+}
+
+#define RPCS3_BENCH(name) \
+	static void bench_##name(bench::state&); \
+	static const bench::registrar s_bench_registrar_##name(#name, bench_##name); \
+	static void bench_##name(bench::state& state)
@@ -0,0 +1,316 @@
+#include "bench.h"
+
+#include "util/endian.hpp"
+
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+#endif
+extern "C"
+{
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+}
+#ifdef _MSC_VER
+#pragma warning(pop)
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+
+extern void atracXdecConvertPcm(const AVFrame& frame, u32 bw_pcm, u32 ch_config_idx, u32 nch_in, u32 samples_num, void* output);
+
+// ATRAC3plus decoding as done by cellAtracXdec: one decoder per stream, FFmpeg output converted to big endian PCM.
+// Pass --param=atrac3p=<file.oma|file.at3> to decode a real stream and --param=streams=<n> for the stream count (default 4).
+namespace bench
+{
+	// cellAtracXdec.h needs the whole guest memory headers
+	static constexpr u32 s_samples_per_frame = 0x800;
+	static constexpr u32 s_word_sz_16bit = 0x02;
+
+	struct atrac3p_corpus
+	{
+		std::vector<std::vector<u8>> packets;
+		std::vector<u8> extradata;
+		int channels = 0;
+		int sample_rate = 0;
+		int block_align = 0;
+	};
+
+	static const atrac3p_corpus& get_atrac3p_corpus()
+	{
+		static const atrac3p_corpus s_corpus = []()
+		{
+			atrac3p_corpus result;
+
+			const std::string path{get_param("atrac3p")};
+
+			AVFormatContext* format = nullptr;
+
+			if (path.empty() || avformat_open_input(&format, path.c_str(), nullptr, nullptr) < 0)
+			{
+				return result;
+			}
+
+			const int stream_index = avformat_find_stream_info(format, nullptr) >= 0 ? av_find_best_stream(format, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0) : -1;
+
+			if (stream_index >= 0 && format->streams[stream_index]->codecpar->codec_id == AV_CODEC_ID_ATRAC3P)
+			{
+				const AVCodecParameters& par = *format->streams[stream_index]->codecpar;
+				result.channels = par.ch_layout.nb_channels;
+				result.sample_rate = par.sample_rate;
+				result.block_align = par.block_align;
+				result.extradata.assign(par.extradata, par.extradata + par.extradata_size);
+
+				AVPacket* packet = av_packet_alloc();
+
+				while (packet && result.packets.size() < 2000 && av_read_frame(format, packet) >= 0)
+				{
+					if (packet->stream_index == stream_index)
+					{
+						result.packets.emplace_back(packet->data, packet->data + packet->size);
+					}
+
+					av_packet_unref(packet);
+				}
+
+				av_packet_free(&packet);
+			}
+
+			avformat_close_input(&format);
+			return result;
+		}();
+
+		return s_corpus;
+	}
+
+	// Decodes and converts the corpus once, returns the number of decoded frames
+	static usz decode_corpus(const atrac3p_corpus& corpus)
+	{
+		const AVCodec* codec = avcodec_find_decoder(AV_CODEC_ID_ATRAC3P);
+		AVCodecContext* ctx = codec ? avcodec_alloc_context3(codec) : nullptr;
+		AVPacket* packet = av_packet_alloc();
+		AVFrame* frame = av_frame_alloc();
+
+		usz frames = 0;
+
+		if (ctx && packet && frame)
+		{
+			av_channel_layout_default(&ctx->ch_layout, corpus.channels);
+			ctx->sample_rate = corpus.sample_rate;
+			ctx->block_align = corpus.block_align;
+
+			std::vector<u8> extradata(corpus.extradata);
+			extradata.resize(extradata.size() + AV_INPUT_BUFFER_PADDING_SIZE);
+			ctx->extradata = extradata.data();
+			ctx->extradata_size = ::narrow<int>(corpus.extradata.size());
+
+			const u32 nch_in = corpus.channels;
+			const u32 ch_config_idx = nch_in <= 4 ? nch_in : nch_in - 1;
+			std::vector<u8> output(s_samples_per_frame * sizeof(s16) * nch_in);
+
+			if (avcodec_open2(ctx, codec, nullptr) == 0)
+			{
+				std::vector<u8> data;
+
+				for (const auto& au : corpus.packets)
+				{
+					data.assign(au.begin(), au.end());
+					data.resize(data.size() + AV_INPUT_BUFFER_PADDING_SIZE);
+
+					packet->data = data.data();
+					packet->size = ::narrow<int>(au.size());
+
+					if (avcodec_send_packet(ctx, packet) == 0 && avcodec_receive_frame(ctx, frame) == 0)
+					{
+						atracXdecConvertPcm(*frame, s_word_sz_16bit, ch_config_idx, nch_in, frame->nb_samples, output.data());
+						clobber_memory();
+						frames++;
+					}
+
+					av_frame_unref(frame);
+				}
+			}
+
+			ctx->extradata = nullptr;
+			ctx->extradata_size = 0;
+		}
+
+		av_frame_free(&frame);
+		av_packet_free(&packet);
+		avcodec_free_context(&ctx);
+		return frames;
+	}
+
+	// A single cellAdec instance
+	RPCS3_BENCH(adec_atrac3p_decode)
+	{
+		const auto& corpus = get_atrac3p_corpus();
+
+		if (corpus.packets.empty())
+		{
+			state.skip("no ATRAC3plus stream, pass --param=atrac3p=<file.oma|file.at3>");
+			return;
+		}
+
+		usz frames = 0;
+
+		while (state.keep_running())
+		{
+			frames += decode_corpus(corpus);
+		}
+
+		state.set_items_processed(frames);
+	}
+
+	// Several cellAdec instances decoding at the same time (games mixing BGM, voice and effects streams)
+	RPCS3_BENCH(adec_atrac3p_decode_streams)
+	{
+		const auto& corpus = get_atrac3p_corpus();
+
+		if (corpus.packets.empty())
+		{
+			state.skip("no ATRAC3plus stream, pass --param=atrac3p=<file.oma|file.at3>");
+			return;
+		}
+
+		const std::string_view streams_param = get_param("streams");
+		const u32 streams = streams_param.empty() ? 4 : std::max<u32>(1, std::stoul(std::string(streams_param)));
+
+		std::vector<usz> frames(streams);
+
+		while (state.keep_running())
+		{
+			std::vector<std::thread> threads;
+
+			for (u32 i = 0; i < streams; i++)
+			{
+				threads.emplace_back([&, i]()
+				{
+					frames[i] += decode_corpus(corpus);
+				});
+			}
+
+			for (auto& thread : threads)
+			{
+				thread.join();
+			}
+		}
+
+		usz total = 0;
+
+		for (usz count : frames)
+		{
+			total += count;
+		}
+
+		state.set_threads(streams);
+		state.set_items_processed(total);
+	}
+
+	struct pcm_frames
+	{
+		static constexpr u32 channels = 2;
+		static constexpr u32 count = 64;
+
+		std::vector<f32> samples; // Planar, slightly out of range like real decoder output
+		std::vector<AVFrame> frames;
+
+		pcm_frames()
+			: samples(usz{s_samples_per_frame} * channels * count)
+			, frames(count)
+		{
+			std::mt19937 rng(0);
+			std::uniform_real_distribution<f32> dist(-1.05f, 1.05f);
+
+			for (f32& sample : samples)
+			{
+				sample = dist(rng);
+			}
+
+			for (u32 i = 0; i < count; i++)
+			{
+				for (u32 ch = 0; ch < channels; ch++)
+				{
+					frames[i].data[ch] = reinterpret_cast<u8*>(samples.data() + (usz{i} * channels + ch) * s_samples_per_frame);
+				}
+
+				frames[i].nb_samples = s_samples_per_frame;
+			}
+		}
+	};
+
+	static const pcm_frames& get_pcm_frames()
+	{
+		static const pcm_frames s_frames;
+		return s_frames;
+	}
+
+	// Previous 16-bit conversion: branch and std::floor() per sample
+	RPCS3_BENCH(adec_atrac3p_convert_pcm_s16_branchy)
+	{
+		const auto& pcm = get_pcm_frames();
+		std::vector<be_t<s16>> output(s_samples_per_frame * pcm.channels);
+
+		while (state.keep_running())
+		{
+			for (const AVFrame& frame : pcm.frames)
+			{
+				for (u32 channel_idx = 0; channel_idx < pcm.channels; channel_idx++)
+				{
+					const f32* samples = reinterpret_cast<const f32*>(frame.data[channel_idx]);
+
+					for (u32 in_sample_idx = 0, out_sample_idx = channel_idx; in_sample_idx < s_samples_per_frame; in_sample_idx++, out_sample_idx += pcm.channels)
+					{
+						const f32 sample = samples[in_sample_idx];
+
+						if (sample >= 1.f)
+						{
+							output[out_sample_idx] = INT16_MAX;
+						}
+						else if (sample <= -1.f)
+						{
+							output[out_sample_idx] = INT16_MIN;
+						}
+						else
+						{
+							output[out_sample_idx] = static_cast<s16>(std::floor(sample * 0x8000u));
+						}
+					}
+				}
+
+				clobber_memory();
+			}
+		}
+
+		state.set_items_processed(state.iterations() * pcm.count);
+		state.set_bytes_processed(state.iterations() * pcm.count * output.size() * sizeof(s16));
+	}
+
+	RPCS3_BENCH(adec_atrac3p_convert_pcm_s16)
+	{
+		const auto& pcm = get_pcm_frames();
+		std::vector<be_t<s16>> output(s_samples_per_frame * pcm.channels);
+
+		while (state.keep_running())
+		{
+			for (const AVFrame& frame : pcm.frames)
+			{
+				atracXdecConvertPcm(frame, s_word_sz_16bit, pcm.channels, pcm.channels, s_samples_per_frame, output.data());
+				clobber_memory();
+			}
+		}
+
+		state.set_items_processed(state.iterations() * pcm.count);
+		state.set_bytes_processed(state.iterations() * pcm.count * output.size() * sizeof(s16));
+	}
+}
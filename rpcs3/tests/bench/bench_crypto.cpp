@@ -0,0 +1,162 @@
+#include "bench.h"
+
+#include "Crypto/aes.h"
+#include "Crypto/sha1.h"
+
+#include <cstring>
+#include <vector>
+
+// SELF/EDAT/PKG decryption primitives: one block at a time as the loaders used to do, against the bulk paths
+// (SHA extensions, pipelined AES-NI CBC decryption and CTR keystream when available).
+namespace bench
+{
+	static constexpr usz s_buffer_size = 0x100000;
+
+	static std::vector<u8> make_buffer()
+	{
+		std::vector<u8> data(s_buffer_size);
+
+		for (usz i = 0; i < data.size(); i++)
+		{
+			data[i] = static_cast<u8>(i * 0x9d + (i >> 8));
+		}
+
+		return data;
+	}
+
+	static const u8 s_key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+
+	RPCS3_BENCH(crypto_sha1_blockwise)
+	{
+		const auto data = make_buffer();
+		sha1_context ctx;
+
+		while (state.keep_running())
+		{
+			sha1_starts(&ctx);
+
+			for (usz i = 0; i < data.size(); i += 64)
+			{
+				sha1_process(&ctx, data.data() + i);
+			}
+
+			do_not_optimize(ctx.state[0]);
+		}
+
+		state.set_bytes_processed(state.iterations() * data.size());
+	}
+
+	RPCS3_BENCH(crypto_sha1)
+	{
+		const auto data = make_buffer();
+		u8 digest[20];
+
+		while (state.keep_running())
+		{
+			sha1(data.data(), data.size(), digest);
+			do_not_optimize(digest[0]);
+		}
+
+		state.set_bytes_processed(state.iterations() * data.size());
+	}
+
+	RPCS3_BENCH(crypto_aes_cbc_decrypt_blockwise)
+	{
+		auto data = make_buffer();
+
+		aes_context ctx;
+		aes_setkey_dec(&ctx, s_key, 128);
+
+		while (state.keep_running())
+		{
+			u8 iv[16]{};
+
+			for (usz i = 0; i < data.size(); i += 16)
+			{
+				u8 cipher[16];
+				std::memcpy(cipher, data.data() + i, 16);
+				aes_crypt_ecb(&ctx, AES_DECRYPT, cipher, data.data() + i);
+
+				for (usz j = 0; j < 16; j++)
+				{
+					data[i + j] ^= iv[j];
+				}
+
+				std::memcpy(iv, cipher, 16);
+			}
+
+			do_not_optimize(data[0]);
+		}
+
+		state.set_bytes_processed(state.iterations() * data.size());
+	}
+
+	RPCS3_BENCH(crypto_aes_cbc_decrypt)
+	{
+		auto data = make_buffer();
+
+		aes_context ctx;
+		aes_setkey_dec(&ctx, s_key, 128);
+
+		while (state.keep_running())
+		{
+			u8 iv[16]{};
+			aes_crypt_cbc(&ctx, AES_DECRYPT, data.size(), iv, data.data(), data.data());
+			do_not_optimize(data[0]);
+		}
+
+		state.set_bytes_processed(state.iterations() * data.size());
+	}
+
+	RPCS3_BENCH(crypto_aes_ctr_blockwise)
+	{
+		auto data = make_buffer();
+
+		aes_context ctx;
+		aes_setkey_enc(&ctx, s_key, 128);
+
+		u8 counter[16]{};
+
+		while (state.keep_running())
+		{
+			for (usz i = 0; i < data.size(); i += 16)
+			{
+				u8 stream[16];
+				aes_crypt_ecb(&ctx, AES_ENCRYPT, counter, stream);
+
+				for (usz j = 0; j < 16; j++)
+				{
+					data[i + j] ^= stream[j];
+				}
+
+				for (usz j = 16; j > 0 && ++counter[j - 1] == 0; j--)
+				{
+				}
+			}
+
+			do_not_optimize(data[0]);
+		}
+
+		state.set_bytes_processed(state.iterations() * data.size());
+	}
+
+	RPCS3_BENCH(crypto_aes_ctr)
+	{
+		auto data = make_buffer();
+
+		aes_context ctx;
+		aes_setkey_enc(&ctx, s_key, 128);
+
+		u8 counter[16]{};
+		u8 stream_block[16]{};
+		usz offset = 0;
+
+		while (state.keep_running())
+		{
+			aes_crypt_ctr(&ctx, data.size(), &offset, counter, stream_block, data.data(), data.data());
+			do_not_optimize(data[0]);
+		}
+
+		state.set_bytes_processed(state.iterations() * data.size());
+	}
+}
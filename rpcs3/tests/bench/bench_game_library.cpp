@@ -0,0 +1,140 @@
+#include "bench.h"
+
+#include "Emu/game_library_index.h"
+#include "Utilities/File.h"
+#include "Utilities/StrFmt.h"
+
+#include <memory>
+
+// Game list refresh of a synthetic library (PARAM.SFO and ICON0.PNG per title) in the temporary directory.
+// Pass --param=games=<n> to change the number of titles (default 500).
+namespace bench
+{
+	struct game_library
+	{
+		std::string root;
+		std::string index_path;
+		std::vector<std::string> dirs;
+		std::unique_ptr<game_library_index> index; // Populated with every title
+
+		game_library()
+		{
+			const std::string_view count_param = get_param("games");
+			const usz count = count_param.empty() ? 500 : std::max<usz>(1, std::stoull(std::string(count_param)));
+
+			root = fs::get_temp_dir() + "rpcs3_bench_games/";
+			fs::remove_all(root, false, true);
+			fs::create_path(root);
+
+			const std::vector<u8> icon(40 * 1024, 0x55);
+
+			for (usz i = 0; i < count; i++)
+			{
+				const std::string title_id = fmt::format("BLUS%05u", i);
+
+				psf::registry sfo;
+				sfo.emplace("TITLE_ID", psf::string(10, title_id));
+				sfo.emplace("TITLE", psf::string(128, fmt::format("Benchmark Game %u", i)));
+				sfo.emplace("CATEGORY", psf::string(4, "HG"));
+				sfo.emplace("APP_VER", psf::string(8, "01.00"));
+				sfo.emplace("PARENTAL_LEVEL", 3);
+
+				const std::string dir = root + title_id;
+				fs::create_dir(dir);
+				fs::write_file(dir + "/PARAM.SFO", fs::rewrite, psf::save_object(sfo));
+				fs::write_file(dir + "/ICON0.PNG", fs::rewrite, icon);
+				dirs.push_back(dir);
+			}
+
+			index_path = root + "index.dat";
+			index = std::make_unique<game_library_index>(index_path);
+
+			for (const std::string& dir : dirs)
+			{
+				index->get(dir, 1);
+			}
+
+			if (!index->save())
+			{
+				index_path.clear();
+			}
+		}
+
+		~game_library()
+		{
+			fs::remove_all(root);
+		}
+	};
+
+	static const game_library& get_game_library()
+	{
+		static const game_library s_library;
+		return s_library;
+	}
+
+	// Previous refresh: parse PARAM.SFO and read the icon of every title
+	RPCS3_BENCH(game_library_refresh_uncached)
+	{
+		const auto& library = get_game_library();
+
+		while (state.keep_running())
+		{
+			for (const std::string& dir : library.dirs)
+			{
+				const psf::registry sfo = psf::load_object(dir + "/PARAM.SFO");
+				do_not_optimize(psf::get_string(sfo, "TITLE_ID").size());
+
+				fs::file icon(dir + "/ICON0.PNG");
+				do_not_optimize(icon.to_vector<u8>().size());
+			}
+		}
+
+		state.set_items_processed(state.iterations() * library.dirs.size());
+	}
+
+	// Refresh of an unchanged library in the same session (stat calls only)
+	RPCS3_BENCH(game_library_refresh_indexed)
+	{
+		const auto& library = get_game_library();
+
+		while (state.keep_running())
+		{
+			for (const std::string& dir : library.dirs)
+			{
+				do_not_optimize(library.index->get(dir, 1)->icon.size());
+			}
+		}
+
+		state.set_items_processed(state.iterations() * library.dirs.size());
+	}
+
+	// First refresh after startup: load the persisted index, then revalidate every title
+	RPCS3_BENCH(game_library_startup_indexed)
+	{
+		const auto& library = get_game_library();
+
+		if (library.index_path.empty())
+		{
+			state.skip("failed to save the game library index");
+			return;
+		}
+
+		while (state.keep_running())
+		{
+			// Loaded by the first get()
+			game_library_index index(library.index_path);
+
+			for (const std::string& dir : library.dirs)
+			{
+				do_not_optimize(index.get(dir, 1)->icon.size());
+			}
+
+			if (index.is_dirty())
+			{
+				std::abort();
+			}
+		}
+
+		state.set_items_processed(state.iterations() * library.dirs.size());
+	}
+}
@@ -0,0 +1,413 @@
+#include "bench.h"
+
+#include "Emu/IPC_socket.h"
+#include "util/vm.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <random>
+
+// Local IPC client sampling guest memory through the PINE server, in addresses per second.
+// The server runs the real protocol code over a host buffer instead of vm memory.
+namespace bench
+{
+#ifndef _WIN32
+	static constexpr u32 s_memory_size = 0x1000000;
+	static constexpr int s_port = 28099;
+	static constexpr u32 s_addresses = 1000;
+
+	struct bench_memory
+	{
+		utils::shm shm{s_memory_size};
+		u8* const ptr = shm.map_self();
+	};
+
+	static bench_memory& get_bench_memory()
+	{
+		static bench_memory s_memory;
+		return s_memory;
+	}
+
+	struct bench_ipc_impl : IPC_socket::IPC_impl
+	{
+	protected:
+		template <u32 Size = 1>
+		static bool check_addr(u32 addr, u8 = 0)
+		{
+			return addr <= s_memory_size - Size && addr % Size == 0;
+		}
+
+		template <typename T>
+		static T& ref(u32 addr)
+		{
+			return *reinterpret_cast<T*>(get_bench_memory().ptr + addr);
+		}
+
+		static const u8& read8(u32 addr) { return ref<u8>(addr); }
+		static void write8(u32 addr, u8 value) { ref<u8>(addr) = value; }
+		static const be_t<u16>& read16(u32 addr) { return ref<be_t<u16>>(addr); }
+		static void write16(u32 addr, be_t<u16> value) { ref<be_t<u16>>(addr) = value; }
+		static const be_t<u32>& read32(u32 addr) { return ref<be_t<u32>>(addr); }
+		static void write32(u32 addr, be_t<u32> value) { ref<be_t<u32>>(addr) = value; }
+		static const be_t<u64>& read64(u32 addr) { return ref<be_t<u64>>(addr); }
+		static void write64(u32 addr, be_t<u64> value) { ref<be_t<u64>>(addr) = value; }
+
+		static bool read_block(u32 addr, void* dst, u32 size)
+		{
+			if (addr > s_memory_size || size > s_memory_size - addr)
+			{
+				return false;
+			}
+
+			std::memcpy(dst, get_bench_memory().ptr + addr, size);
+			return true;
+		}
+
+		static bool write_block(u32 addr, const void* src, u32 size)
+		{
+			if (addr > s_memory_size || size > s_memory_size - addr)
+			{
+				return false;
+			}
+
+			std::memcpy(get_bench_memory().ptr + addr, src, size);
+			return true;
+		}
+
+		static int get_shared_memory(u32& addr, u64& size)
+		{
+#ifdef __linux__
+			addr = 0;
+			size = s_memory_size;
+			return ::open(fmt::format("/proc/self/fd/%d", get_bench_memory().shm.get_handle()).c_str(), O_RDONLY | O_CLOEXEC);
+#else
+			static_cast<void>(addr);
+			static_cast<void>(size);
+			return -1;
+#endif
+		}
+
+		static int get_port()
+		{
+			return s_port;
+		}
+	};
+
+	using bench_ipc_server = named_thread<pine::pine_server<bench_ipc_impl>>;
+
+	struct ipc_client
+	{
+		int sock = -1;
+		std::vector<char> reply;
+		int received_fd = -1;
+
+		ipc_client()
+		{
+			// Same location as the server
+			const char* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+#ifdef __APPLE__
+			runtime_dir = std::getenv("TMPDIR");
+#endif
+			const std::string path = fmt::format("%s/rpcs3.sock.%d", runtime_dir ? runtime_dir : "/tmp", s_port);
+
+			sockaddr_un addr{};
+			addr.sun_family = AF_UNIX;
+			strcpy(addr.sun_path, path.c_str());
+
+			sock = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+			if (sock >= 0 && ::connect(sock, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0)
+			{
+				::close(std::exchange(sock, -1));
+			}
+		}
+
+		~ipc_client()
+		{
+			if (sock >= 0)
+			{
+				::close(sock);
+			}
+		}
+
+		// Sends a message (the size is filled in) and waits for the reply, returns false on failure or IPC_FAIL
+		bool request(std::vector<char>& message)
+		{
+			const u32 size = ::size32(message);
+			std::memcpy(message.data(), &size, sizeof(size));
+
+			for (usz sent = 0; sent < message.size();)
+			{
+				const auto res = ::write(sock, message.data() + sent, message.size() - sent);
+
+				if (res <= 0)
+				{
+					return false;
+				}
+
+				sent += res;
+			}
+
+			reply.resize(4);
+
+			for (usz received = 0; received < reply.size();)
+			{
+				alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))]{};
+				iovec iov{reply.data() + received, reply.size() - received};
+				msghdr msg{};
+				msg.msg_iov = &iov;
+				msg.msg_iovlen = 1;
+				msg.msg_control = control;
+				msg.msg_controllen = sizeof(control);
+
+				const auto res = ::recvmsg(sock, &msg, 0);
+
+				if (res <= 0)
+				{
+					return false;
+				}
+
+				if (const cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg && cmsg->cmsg_type == SCM_RIGHTS)
+				{
+					std::memcpy(&received_fd, CMSG_DATA(cmsg), sizeof(int));
+				}
+
+				received += res;
+
+				if (received == 4)
+				{
+					u32 reply_size = 0;
+					std::memcpy(&reply_size, reply.data(), sizeof(reply_size));
+					reply.resize(std::max<u32>(reply_size, 5));
+				}
+			}
+
+			return reply[4] == 0;
+		}
+	};
+
+	template <typename T>
+	static void append(std::vector<char>& message, T value)
+	{
+		const usz pos = message.size();
+		message.resize(pos + sizeof(T));
+		std::memcpy(message.data() + pos, &value, sizeof(T));
+	}
+
+	struct ipc_session
+	{
+		std::unique_ptr<bench_ipc_server> server;
+		std::unique_ptr<ipc_client> client;
+		std::vector<u32> addresses;
+
+		ipc_session()
+		{
+			std::mt19937 rng(0);
+
+			for (u32 i = 0; i < s_addresses; i++)
+			{
+				addresses.push_back((rng() % s_memory_size) & ~3u);
+			}
+
+			u8* memory = get_bench_memory().ptr;
+
+			for (u32 i = 0; i < s_memory_size; i++)
+			{
+				memory[i] = static_cast<u8>(rng());
+			}
+
+			server = std::make_unique<bench_ipc_server>();
+			client = std::make_unique<ipc_client>();
+		}
+	};
+
+	static ipc_session& get_ipc_session()
+	{
+		static ipc_session s_session;
+		return s_session;
+	}
+
+	// One request per address (typical client)
+	RPCS3_BENCH(ipc_read32_single)
+	{
+		auto& session = get_ipc_session();
+
+		if (session.client->sock < 0)
+		{
+			state.skip("failed to connect to the IPC server");
+			return;
+		}
+
+		std::vector<char> message;
+
+		while (state.keep_running())
+		{
+			for (u32 addr : session.addresses)
+			{
+				message.assign(4, 0);
+				append<u8>(message, 2); // MsgRead32
+				append<u32>(message, addr);
+
+				if (!session.client->request(message))
+				{
+					std::abort();
+				}
+
+				do_not_optimize(session.client->reply[5]);
+			}
+		}
+
+		state.set_items_processed(state.iterations() * session.addresses.size());
+	}
+
+	// All MsgRead32 commands concatenated in one message
+	RPCS3_BENCH(ipc_read32_pipelined)
+	{
+		auto& session = get_ipc_session();
+
+		if (session.client->sock < 0)
+		{
+			state.skip("failed to connect to the IPC server");
+			return;
+		}
+
+		std::vector<char> message;
+
+		while (state.keep_running())
+		{
+			message.assign(4, 0);
+
+			for (u32 addr : session.addresses)
+			{
+				append<u8>(message, 2); // MsgRead32
+				append<u32>(message, addr);
+			}
+
+			if (!session.client->request(message))
+			{
+				std::abort();
+			}
+
+			do_not_optimize(session.client->reply[5]);
+		}
+
+		state.set_items_processed(state.iterations() * session.addresses.size());
+	}
+
+	RPCS3_BENCH(ipc_read32_batch)
+	{
+		auto& session = get_ipc_session();
+
+		if (session.client->sock < 0)
+		{
+			state.skip("failed to connect to the IPC server");
+			return;
+		}
+
+		std::vector<char> message;
+
+		while (state.keep_running())
+		{
+			message.assign(4, 0);
+			append<u8>(message, 0x12); // MsgReadBatch
+			append<u8>(message, 4);
+			append<u32>(message, ::size32(session.addresses));
+
+			for (u32 addr : session.addresses)
+			{
+				append<u32>(message, addr);
+			}
+
+			if (!session.client->request(message))
+			{
+				std::abort();
+			}
+
+			do_not_optimize(session.client->reply[5]);
+		}
+
+		state.set_items_processed(state.iterations() * session.addresses.size());
+	}
+
+	// 64 KiB scanned per request (addresses are 32-bit words)
+	RPCS3_BENCH(ipc_read_block)
+	{
+		auto& session = get_ipc_session();
+
+		if (session.client->sock < 0)
+		{
+			state.skip("failed to connect to the IPC server");
+			return;
+		}
+
+		constexpr u32 block_size = 0x10000;
+		std::vector<char> message;
+		u32 addr = 0;
+
+		while (state.keep_running())
+		{
+			message.assign(4, 0);
+			append<u8>(message, 0x10); // MsgReadBlock
+			append<u32>(message, addr);
+			append<u32>(message, block_size);
+
+			if (!session.client->request(message))
+			{
+				std::abort();
+			}
+
+			do_not_optimize(session.client->reply[5]);
+			addr = (addr + block_size) % s_memory_size;
+		}
+
+		state.set_items_processed(state.iterations() * (block_size / 4));
+		state.set_bytes_processed(state.iterations() * block_size);
+	}
+
+	// Reading the mapping obtained with MsgShareMemory
+	RPCS3_BENCH(ipc_read32_shared)
+	{
+		auto& session = get_ipc_session();
+
+		std::vector<char> message(4);
+		append<u8>(message, 0x14); // MsgShareMemory
+
+		if (session.client->sock < 0 || !session.client->request(message) || session.client->received_fd < 0)
+		{
+			state.skip("shared memory unavailable");
+			return;
+		}
+
+		const int fd = std::exchange(session.client->received_fd, -1);
+		const auto memory = static_cast<const u8*>(::mmap(nullptr, s_memory_size, PROT_READ, MAP_SHARED, fd, 0));
+		::close(fd);
+
+		if (memory == MAP_FAILED)
+		{
+			state.skip("failed to map shared memory");
+			return;
+		}
+
+		while (state.keep_running())
+		{
+			u32 sum = 0;
+
+			for (u32 addr : session.addresses)
+			{
+				sum += *reinterpret_cast<const be_t<u32>*>(memory + addr);
+			}
+
+			do_not_optimize(sum);
+		}
+
+		::munmap(const_cast<u8*>(memory), s_memory_size);
+		state.set_items_processed(state.iterations() * session.addresses.size());
+	}
+#endif
+}
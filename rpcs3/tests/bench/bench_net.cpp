@@ -0,0 +1,174 @@
+#include "bench.h"
+
+#include "Emu/IdManager.h"
+#include "Emu/Cell/lv2/sys_net/lv2_socket_native.h"
+#include "Emu/Cell/lv2/sys_net/network_context.h"
+
+// Blocking sys_net_bnet_recvfrom on a loopback UDP socket through the network thread (network_context.cpp):
+// the caller queues a read poll on an lv2 socket, a datagram arrives, the network thread runs the poll callback.
+// The HLE function needs a PPU thread, so the callback wakes the benchmark thread instead of a PPU.
+namespace bench
+{
+#ifndef _WIN32
+	struct net_environment
+	{
+		net_environment()
+		{
+			if (!g_fxo->is_init())
+			{
+				g_fxo->reset();
+			}
+
+			if (!g_fxo->is_init<id_manager::id_map<lv2_socket>>())
+			{
+				g_fxo->init<id_manager::id_map<lv2_socket>>();
+			}
+
+			if (!g_fxo->is_init<network_context>())
+			{
+				g_fxo->init<network_context>();
+			}
+		}
+
+		static void init()
+		{
+			static net_environment s_env;
+		}
+	};
+
+	// lv2 UDP socket bound to loopback (natively, lv2 bind needs the NP handler) and a native sender
+	struct lv2_udp_pair
+	{
+		shared_ptr<lv2_socket_native> sock = make_shared<lv2_socket_native>(SYS_NET_AF_INET, SYS_NET_SOCK_DGRAM, SYS_NET_IPPROTO_UDP);
+		u32 id = 0;
+		int tx = -1;
+		sockaddr_in addr{};
+
+		lv2_udp_pair()
+		{
+			net_environment::init();
+
+			if (sock->create_socket() != CELL_OK)
+			{
+				return;
+			}
+
+			id = idm::import_existing<lv2_socket>(sock);
+			sock->set_lv2_id(id);
+
+			addr.sin_family = AF_INET;
+			addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+			socklen_t len = sizeof(addr);
+			::bind(sock->get_socket(), reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+			::getsockname(sock->get_socket(), reinterpret_cast<sockaddr*>(&addr), &len);
+
+			tx = ::socket(AF_INET, SOCK_DGRAM, 0);
+		}
+
+		~lv2_udp_pair()
+		{
+			if (tx >= 0)
+			{
+				::close(tx);
+			}
+
+			// Same as sys_net_bnet_close
+			if (idm::withdraw<lv2_socket>(id))
+			{
+				sock->close();
+			}
+
+			std::lock_guard nw_lock(g_fxo->get<network_context>().mutex_thread_loop);
+			sock.reset();
+		}
+
+		bool valid() const
+		{
+			return id != id_manager::id_traits<lv2_socket>::invalid && tx >= 0 && addr.sin_port != 0;
+		}
+
+		void send() const
+		{
+			const u8 data[64]{};
+			::sendto(tx, data, sizeof(data), 0, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+		}
+
+		bool recv() const
+		{
+			u8 data[64];
+			return ::recv(sock->get_socket(), data, sizeof(data), MSG_DONTWAIT) > 0;
+		}
+	};
+
+	// Caller side of a blocking recvfrom: queue the poll, the peer sends, wait for the network thread
+	static void blocking_recv_loop(state& state, lv2_udp_pair& pair)
+	{
+		atomic_t<u32> woken = 0;
+
+		while (state.keep_running())
+		{
+			woken = 0;
+
+			{
+				auto lock = pair.sock->lock();
+
+				pair.sock->poll_queue({}, lv2_socket::poll_t::read, [&](bs_t<lv2_socket::poll_t> events) -> bool
+				{
+					if (events & lv2_socket::poll_t::read)
+					{
+						woken = 1;
+						woken.notify_one();
+						return true;
+					}
+
+					return false;
+				});
+			}
+
+			pair.send();
+
+			while (!woken)
+			{
+				woken.wait(0);
+			}
+
+			if (!pair.recv())
+			{
+				std::abort();
+			}
+		}
+
+		state.set_threads(2);
+		state.set_items_processed(state.iterations());
+	}
+
+	RPCS3_BENCH(net_recvfrom_loopback)
+	{
+		lv2_udp_pair pair;
+
+		if (!pair.valid())
+		{
+			state.skip("loopback UDP sockets unavailable");
+			return;
+		}
+
+		blocking_recv_loop(state, pair);
+	}
+
+	// With SO_RCVTIMEO the network thread keeps waking up every 1ms to let the waiter check its timeout
+	RPCS3_BENCH(net_recvfrom_loopback_timeout)
+	{
+		lv2_udp_pair pair;
+
+		if (!pair.valid())
+		{
+			state.skip("loopback UDP sockets unavailable");
+			return;
+		}
+
+		pair.sock->so_rcvtimeo = 10'000'000;
+		blocking_recv_loop(state, pair);
+	}
+#endif
+}
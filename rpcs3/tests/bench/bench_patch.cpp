@@ -0,0 +1,130 @@
+#include "bench.h"
+
+#include "Utilities/bin_patch.h"
+#include "Utilities/File.h"
+#include "Utilities/StrFmt.h"
+
+// Boot time patch loading of a synthetic patch.yml in the temporary directory.
+// Pass --param=patches=<n> to change the number of hashes (default 4000, the size of the community patch file).
+namespace bench
+{
+	static constexpr std::string_view s_booted_serial = "BLUS00042";
+
+	struct patch_file
+	{
+		std::string root;
+		std::string path;
+		std::string cache_path;
+		usz size = 0;
+
+		patch_file()
+		{
+			const std::string_view count_param = get_param("patches");
+			const usz count = count_param.empty() ? 4000 : std::max<usz>(1, std::stoull(std::string(count_param)));
+
+			root = fs::get_temp_dir() + "rpcs3_bench_patches/";
+			fs::remove_all(root, false, true);
+			fs::create_path(root);
+
+			std::string content = fmt::format("Version: %s\n", patch_engine_version);
+
+			for (usz i = 0; i < count; i++)
+			{
+				// Some games have a patch for each of their executables
+				const usz serial = i / 2;
+
+				fmt::append(content, "\nPPU-%040x:\n", i * 0x9e3779b97f4a7c15ull);
+
+				for (std::string_view description : {"60 FPS", "Disable Motion Blur"})
+				{
+					fmt::append(content,
+						"  \"%s\":\n"
+						"    Games:\n"
+						"      \"Benchmark Game %u\":\n"
+						"        BLUS%05u: [ 01.00, 01.01 ]\n"
+						"        BLES%05u: [ 01.00 ]\n"
+						"    Author: \"Benchmark\"\n"
+						"    Notes: \"Synthetic patch\"\n"
+						"    Patch Version: 1.0\n"
+						"    Patch:\n", description, serial, serial, serial);
+
+					for (u32 j = 0; j < 12; j++)
+					{
+						fmt::append(content, "      - [ be32, 0x%08x, 0x60000000 ]\n", 0x10000 + j * 4);
+					}
+				}
+			}
+
+			path = root + "patch.yml";
+			cache_path = root + "patch.yml.bin";
+			size = content.size();
+			fs::write_file(path, fs::rewrite, content);
+
+			// Prime the compiled cache
+			patch_engine::patch_map patches;
+			patch_engine::load_compiled(patches, path, cache_path, s_booted_serial, {});
+		}
+
+		~patch_file()
+		{
+			fs::remove_all(root);
+		}
+	};
+
+	static const patch_file& get_patch_file()
+	{
+		static const patch_file s_file;
+		return s_file;
+	}
+
+	// Previous boot: parse the whole patch file
+	RPCS3_BENCH(patch_boot_load_yaml)
+	{
+		const auto& file = get_patch_file();
+
+		while (state.keep_running())
+		{
+			patch_engine::patch_map patches;
+			patch_engine::load(patches, file.path);
+			do_not_optimize(patches.size());
+		}
+
+		state.set_items_processed(state.iterations());
+		state.set_bytes_processed(state.iterations() * file.size);
+	}
+
+	// Boot with an up-to-date compiled patch file: only the entries of the booted title are read
+	RPCS3_BENCH(patch_boot_load_compiled)
+	{
+		const auto& file = get_patch_file();
+
+		while (state.keep_running())
+		{
+			patch_engine::patch_map patches;
+			patch_engine::load_compiled(patches, file.path, file.cache_path, s_booted_serial, patch_engine::load_config());
+			do_not_optimize(patches.size());
+		}
+
+		state.set_items_processed(state.iterations());
+		state.set_bytes_processed(state.iterations() * file.size);
+	}
+
+	// First boot after the patch file was updated
+	RPCS3_BENCH(patch_boot_compile)
+	{
+		const auto& file = get_patch_file();
+		const std::string cache_path = file.cache_path + ".tmp";
+
+		while (state.keep_running())
+		{
+			fs::remove_file(cache_path);
+
+			patch_engine::patch_map patches;
+			patch_engine::load_compiled(patches, file.path, cache_path, s_booted_serial, patch_engine::load_config());
+			do_not_optimize(patches.size());
+		}
+
+		state.set_items_processed(state.iterations());
+		state.set_bytes_processed(state.iterations() * file.size);
+	}
+}
@@ -0,0 +1,389 @@
+#include "bench.h"
+
+#include "Emu/Cell/PPUThread.h"
+#include "Emu/Cell/SPUThread.h"
+#include "Emu/Memory/vm_locking.h"
+#include "Emu/Memory/vm_ptr.h"
+#include "Emu/Memory/vm_reservation.h"
+#include "Emu/Memory/vm_reservation_stats.h"
+#include "util/asm.hpp"
+
+#include <thread>
+
+using spu_rdata_t = decltype(spu_thread::rdata);
+
+extern void mov_rdata(spu_rdata_t& _dst, const spu_rdata_t& _src);
+extern bool cmp_rdata(const spu_rdata_t& _lhs, const spu_rdata_t& _rhs);
+extern u64 ppu_ldarx(ppu_thread& ppu, u32 addr);
+extern bool ppu_stdcx(ppu_thread& ppu, u32 addr, u64 reg_value, u32 pc);
+
+// Atomic stress test without a game: host threads take the role of SPU and PPU threads and increment counters
+// in a few 128-byte lines of guest memory with spu_thread::do_putllc and ppu_ldarx/ppu_stdcx on thread objects
+// which are never started, HLE reservation ops and mailbox channels. Final counter values are verified.
+// Pass --param=threads=<n> for the thread count (default 4) and --param=lines=<n> for the number of lines (default 1).
+// Pass --param=stats=<n> to sample one of n operations per thread into the reservation statistics (disabled by default).
+namespace bench
+{
+	static u32 get_u32_param(std::string_view name, u32 def, u32 max)
+	{
+		const std::string_view param = get_param(name);
+		return param.empty() ? def : std::clamp<u32>(static_cast<u32>(std::stoul(std::string(param))), 1, max);
+	}
+
+	// Offsets of the counters in each line (different words of the same line)
+	static constexpr u32 s_spu_counter = 0;
+	static constexpr u32 s_ppu_counter = 8;
+	static constexpr u32 s_hle_counter = 16;
+
+	struct stress_memory
+	{
+		u32 addr = 0;
+
+		stress_memory()
+		{
+			if (!vm::get(vm::main))
+			{
+				vm::init();
+			}
+
+			addr = vm::alloc(0x10000, vm::main);
+		}
+	};
+
+	struct alignas(64) stress_thread
+	{
+		const std::unique_ptr<spu_thread> spu = std::make_unique<spu_thread>(nullptr, 0, "Bench SPU", 0);
+		const std::unique_ptr<ppu_thread> ppu = std::make_unique<ppu_thread>(ppu_thread_params{}, "Bench PPU", 0);
+		u64 failures = 0;
+		u64 retries = 0;
+
+		stress_thread()
+		{
+			spu_thread::map_ls(*spu->shm, spu->ls);
+
+			// Not running, must not react to emulation state
+			spu->state.release({});
+			ppu->state.release({});
+		}
+
+		stress_thread(const stress_thread&) = delete;
+
+		~stress_thread()
+		{
+			// Normally freed by spu_thread::cleanup()
+			vm::free_range_lock(spu->range_lock);
+		}
+	};
+
+	struct stress_config
+	{
+		u32 threads = 0;
+		u32 lines = 0;
+		u32 addr = 0;
+	};
+
+	static stress_config get_stress_config()
+	{
+		static const stress_memory s_memory;
+
+		stress_config config{};
+		config.threads = get_u32_param("threads", 4, 32);
+		config.lines = get_u32_param("lines", 1, 0x10000 / 128);
+		config.addr = s_memory.addr;
+
+		std::memset(vm::base(config.addr), 0, config.lines * 128);
+
+		// Same sampling as "Enable Reservation Contention Statistics"
+		vm::reservation_stats_reset(get_u32_param("stats", 0, 65536));
+		return config;
+	}
+
+	// Host endian access (except for reservation_op counters)
+	template <typename T>
+	static T& line_ref(const stress_config& config, u32 index, u32 offset)
+	{
+		return *static_cast<T*>(vm::base(config.addr + (index % config.lines) * 128 + offset));
+	}
+
+	// Runs func(thread, index) state.iterations() times on every thread
+	template <typename F>
+	static void run_stress(state& state, const stress_config& config, F&& func)
+	{
+		std::vector<stress_thread> threads(config.threads);
+		std::vector<std::thread> peers;
+
+		const u64 count = state.iterations();
+
+		for (u32 i = 1; i < config.threads; i++)
+		{
+			peers.emplace_back([&, i]()
+			{
+				for (u64 j = 0; j < count; j++)
+				{
+					func(threads[i], i);
+				}
+			});
+		}
+
+		while (state.keep_running())
+		{
+			func(threads[0], 0);
+		}
+
+		for (auto& peer : peers)
+		{
+			peer.join();
+		}
+
+		u64 failures = 0;
+		u64 retries = 0;
+
+		for (const auto& thread : threads)
+		{
+			failures += thread.failures;
+			retries += thread.retries;
+		}
+
+		state.set_threads(config.threads);
+		state.set_items_processed(count * config.threads);
+		state.set_counter("failure_rate", static_cast<f64>(failures) / (failures + count * config.threads));
+		state.set_counter("retries_per_op", static_cast<f64>(retries) / (count * config.threads));
+	}
+
+	// Sum of a counter over all lines must match the number of increments
+	template <typename T>
+	static void verify_counters(const stress_config& config, u32 offset, u64 expected)
+	{
+		u64 sum = 0;
+
+		for (u32 i = 0; i < config.lines; i++)
+		{
+			sum += line_ref<T>(config, i, offset);
+		}
+
+		if (sum != expected)
+		{
+			std::fprintf(stderr, "Counter mismatch: 0x%llx != 0x%llx\n", static_cast<unsigned long long>(sum), static_cast<unsigned long long>(expected));
+			std::abort();
+		}
+	}
+
+	// GETLLAR: wait for an unlocked line and copy it to the SPU reservation and to LS (see MFC_GETLLAR_CMD in spu_thread::process_mfc_cmd)
+	static void getllar(stress_thread& thread, u32 addr)
+	{
+		spu_thread& spu = *thread.spu;
+
+		const auto& data = *static_cast<const spu_rdata_t*>(vm::base(addr));
+		auto& res = vm::reservation_acquire(addr);
+
+		for (u64 i = 0;; i++)
+		{
+			const u64 ntime = res;
+
+			if (!(ntime & 127))
+			{
+				mov_rdata(spu.rdata, data);
+
+				if (ntime == res && cmp_rdata(spu.rdata, data))
+				{
+					spu.rtime = ntime;
+					spu.raddr = addr;
+					mov_rdata(spu._ref<spu_rdata_t>(0), spu.rdata);
+					return;
+				}
+			}
+
+			thread.retries++;
+
+			if (i < 24)
+			{
+				busy_wait(300);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	static void spu_atomic_increment(stress_thread& thread, const stress_config& config, u32 index)
+	{
+		const u32 addr = config.addr + (index % config.lines) * 128;
+
+		spu_thread& spu = *thread.spu;
+
+		while (true)
+		{
+			getllar(thread, addr);
+
+			// Modify the line in LS and store it back with PUTLLC
+			++*reinterpret_cast<u32*>(spu.ls + s_spu_counter);
+
+			if (spu.do_putllc(spu_mfc_cmd{MFC_PUTLLC_CMD, 0, 128, 0, addr, 0}))
+			{
+				return;
+			}
+
+			thread.failures++;
+		}
+	}
+
+	// LDARX/STDCX on an 8-byte word, as called by the interpreter and the LLVM recompiler
+	static void ppu_atomic_increment(stress_thread& thread, const stress_config& config, u32 index)
+	{
+		const u32 addr = config.addr + (index % config.lines) * 128 + s_ppu_counter;
+
+		ppu_thread& ppu = *thread.ppu;
+
+		while (true)
+		{
+			const u64 value = ppu_ldarx(ppu, addr);
+
+			if (ppu_stdcx(ppu, addr, value + 1, 0))
+			{
+				return;
+			}
+
+			thread.failures++;
+		}
+	}
+
+	struct host_cpu
+	{
+		bool has_pause_flag() const
+		{
+			return false;
+		}
+	};
+
+	RPCS3_BENCH(reservation_spu_getllar_putllc)
+	{
+		const stress_config config = get_stress_config();
+
+		run_stress(state, config, [&](stress_thread& thread, u32 index)
+		{
+			spu_atomic_increment(thread, config, index);
+		});
+
+		verify_counters<u32>(config, s_spu_counter, state.iterations() * config.threads);
+	}
+
+	RPCS3_BENCH(reservation_ppu_ldarx_stdcx)
+	{
+		const stress_config config = get_stress_config();
+
+		run_stress(state, config, [&](stress_thread& thread, u32 index)
+		{
+			ppu_atomic_increment(thread, config, index);
+		});
+
+		verify_counters<be_t<u64>>(config, s_ppu_counter, state.iterations() * config.threads);
+	}
+
+	// Even threads behave like SPUs, odd threads like PPUs, on the same lines
+	RPCS3_BENCH(reservation_mixed_spu_ppu)
+	{
+		const stress_config config = get_stress_config();
+
+		run_stress(state, config, [&](stress_thread& thread, u32 index)
+		{
+			if (index % 2)
+			{
+				ppu_atomic_increment(thread, config, index / 2);
+			}
+			else
+			{
+				spu_atomic_increment(thread, config, index / 2);
+			}
+		});
+
+		const u64 ppu_threads = config.threads / 2;
+		verify_counters<u32>(config, s_spu_counter, state.iterations() * (config.threads - ppu_threads));
+		verify_counters<be_t<u64>>(config, s_ppu_counter, state.iterations() * ppu_threads);
+	}
+
+	// vm::reservation_op as used by HLE functions (lwmutex, SPURS)
+	RPCS3_BENCH(reservation_hle_op)
+	{
+		const stress_config config = get_stress_config();
+
+		run_stress(state, config, [&](stress_thread&, u32 index)
+		{
+			host_cpu cpu;
+
+			vm::reservation_op(cpu, vm::ptr<u32>(vm::cast(config.addr + (index % config.lines) * 128 + s_hle_counter)), [](be_t<u32>& value)
+			{
+				value += 1;
+			});
+		});
+
+		verify_counters<be_t<u32>>(config, s_hle_counter, state.iterations() * config.threads);
+	}
+
+	RPCS3_BENCH(reservation_light_op)
+	{
+		const stress_config config = get_stress_config();
+
+		run_stress(state, config, [&](stress_thread&, u32 index)
+		{
+			vm::light_op(line_ref<atomic_t<u32>>(config, index, s_hle_counter), [](atomic_t<u32>& value)
+			{
+				value++;
+			});
+		});
+
+		verify_counters<u32>(config, s_hle_counter, state.iterations() * config.threads);
+	}
+
+	// SPU mailbox round trip between two spinning threads (outbound then inbound channel)
+	RPCS3_BENCH(spu_mailbox_ping_pong)
+	{
+		spu_channel out_mbox;
+		spu_channel in_mbox;
+
+		const u64 count = state.iterations();
+
+		std::thread peer([&]()
+		{
+			u32 value = 0;
+
+			for (u64 i = 0; i < count; i++)
+			{
+				while (!out_mbox.try_pop(value))
+				{
+					busy_wait(10);
+				}
+
+				while (!in_mbox.try_push(value + 1))
+				{
+					busy_wait(10);
+				}
+			}
+		});
+
+		u32 value = 0;
+
+		while (state.keep_running())
+		{
+			while (!out_mbox.try_push(value))
+			{
+				busy_wait(10);
+			}
+
+			while (!in_mbox.try_pop(value))
+			{
+				busy_wait(10);
+			}
+		}
+
+		peer.join();
+
+		if (value != count)
+		{
+			std::abort();
+		}
+
+		state.set_threads(2);
+		state.set_items_processed(count);
+	}
+}
@@ -0,0 +1,246 @@
+#include "bench.h"
+
+#include "Emu/RSX/gcm_enums.h"
+#include "Emu/RSX/Common/BufferUtils.h"
+#include "Emu/RSX/Common/TextureUtils.h"
+#include "Emu/RSX/rsx_utils.h"
+
+#include <array>
+#include <random>
+
+namespace bench
+{
+	template <typename T>
+	static std::vector<T> make_random_data(usz count)
+	{
+		std::mt19937_64 rng(0x5eed);
+		std::vector<T> data(count);
+
+		for (T& v : data)
+		{
+			v = static_cast<T>(rng());
+		}
+
+		return data;
+	}
+
+	// Typical vertex/constant upload size
+	RPCS3_BENCH(copy_data_swap_u32_64k)
+	{
+		static constexpr u32 count = 0x4000;
+
+		const auto src = make_random_data<u32>(count);
+		std::vector<u32> dst(count);
+
+		while (state.keep_running())
+		{
+			copy_data_swap_u32(dst.data(), src.data(), count);
+			clobber_memory();
+		}
+
+		state.set_bytes_processed(state.iterations() * count * sizeof(u32));
+	}
+
+	RPCS3_BENCH(copy_data_swap_u32_cmp_64k)
+	{
+		static constexpr u32 count = 0x4000;
+
+		const auto src = make_random_data<u32>(count);
+		std::vector<u32> dst(count);
+
+		while (state.keep_running())
+		{
+			do_not_optimize(copy_data_swap_u32_cmp(dst.data(), src.data(), count));
+		}
+
+		state.set_bytes_processed(state.iterations() * count * sizeof(u32));
+	}
+
+	// Quad list to triangle list expansion for non-indexed draws
+	RPCS3_BENCH(index_expand_quads_non_indexed)
+	{
+		static constexpr u32 vertex_count = 0x10000;
+
+		std::vector<u16> dst(get_index_count(rsx::primitive_type::quads, vertex_count));
+
+		while (state.keep_running())
+		{
+			write_index_array_for_non_indexed_non_native_primitive_to_buffer(reinterpret_cast<char*>(dst.data()), rsx::primitive_type::quads, vertex_count);
+			clobber_memory();
+		}
+
+		state.set_items_processed(state.iterations() * vertex_count);
+	}
+
+	// Big-endian u16 indices with primitive restart, no expansion
+	RPCS3_BENCH(index_copy_u16_restart)
+	{
+		static constexpr u32 index_count = 0x10000;
+
+		auto src = make_random_data<u16>(index_count);
+
+		for (usz i = 0; i < src.size(); i += 97)
+		{
+			src[i] = 0xffff;
+		}
+
+		std::vector<u16> dst(index_count);
+		const auto expands = [](rsx::primitive_type) { return false; };
+
+		while (state.keep_running())
+		{
+			do_not_optimize(write_index_array_data_to_buffer(std::as_writable_bytes(std::span(dst)), std::as_bytes(std::span(src)),
+				rsx::index_array_type::u16, rsx::primitive_type::triangles, true, 0xffff, expands));
+		}
+
+		state.set_items_processed(state.iterations() * index_count);
+	}
+
+	static void run_texture_upload(state& state, u32 format, u16 width, u16 height, u32 block_size, u32 block_edge, bool swizzled)
+	{
+		const u16 width_in_block = width / block_edge;
+		const u16 height_in_block = height / block_edge;
+		const usz src_size = usz{width_in_block} * height_in_block * block_size;
+
+		const auto src = make_random_data<u8>(src_size);
+		std::vector<u8> dst(usz{width} * height * 4);
+
+		rsx::subresource_layout layout{};
+		layout.data = rsx::io_buffer(src.data(), src.size());
+		layout.width_in_texel = width;
+		layout.height_in_texel = height;
+		layout.width_in_block = width_in_block;
+		layout.height_in_block = height_in_block;
+		layout.depth = 1;
+		layout.pitch_in_block = width_in_block;
+
+		rsx::texture_uploader_capabilities caps{};
+		caps.alignment = 256;
+
+		while (state.keep_running())
+		{
+			rsx::io_buffer dst_buffer(dst.data(), dst.size());
+			do_not_optimize(rsx::upload_texture_subresource(dst_buffer, layout, format, swizzled, caps).element_size);
+			clobber_memory();
+		}
+
+		state.set_bytes_processed(state.iterations() * src_size);
+	}
+
+	// Software byteswap and deswizzle, used when the backend can't do either on the GPU
+	RPCS3_BENCH(texture_upload_a8r8g8b8_swizzled_256)
+	{
+		run_texture_upload(state, CELL_GCM_TEXTURE_A8R8G8B8, 256, 256, 4, 1, true);
+	}
+
+	RPCS3_BENCH(texture_upload_a8r8g8b8_linear_256)
+	{
+		run_texture_upload(state, CELL_GCM_TEXTURE_A8R8G8B8, 256, 256, 4, 1, false);
+	}
+
+	// BC1 decode to RGBA8 for hosts without DXT support
+	RPCS3_BENCH(texture_upload_dxt1_decode_256)
+	{
+		run_texture_upload(state, CELL_GCM_TEXTURE_COMPRESSED_DXT1, 256, 256, 8, 4, false);
+	}
+
+	template <usz Size>
+	static void run_swizzle_2d(state& state, u16 width, u16 height, bool input_is_swizzled)
+	{
+		using texel = std::array<u8, Size>;
+
+		const usz size = usz{width} * height * Size;
+		const auto src = make_random_data<u8>(size);
+		std::vector<u8> dst(size);
+
+		while (state.keep_running())
+		{
+			if (input_is_swizzled)
+			{
+				rsx::convert_linear_swizzle<texel, true>(src.data(), dst.data(), width, height, width * Size);
+			}
+			else
+			{
+				rsx::convert_linear_swizzle<texel, false>(src.data(), dst.data(), width, height, width * Size);
+			}
+
+			clobber_memory();
+		}
+
+		state.set_items_processed(state.iterations() * width * height);
+		state.set_bytes_processed(state.iterations() * size);
+	}
+
+	// Swizzled texture reads (deswizzle), per texel size
+	RPCS3_BENCH(texture_deswizzle_2d_u8_512)
+	{
+		run_swizzle_2d<1>(state, 512, 512, true);
+	}
+
+	RPCS3_BENCH(texture_deswizzle_2d_u16_512)
+	{
+		run_swizzle_2d<2>(state, 512, 512, true);
+	}
+
+	RPCS3_BENCH(texture_deswizzle_2d_u32_512)
+	{
+		run_swizzle_2d<4>(state, 512, 512, true);
+	}
+
+	RPCS3_BENCH(texture_deswizzle_2d_u64_512)
+	{
+		run_swizzle_2d<8>(state, 512, 512, true);
+	}
+
+	RPCS3_BENCH(texture_deswizzle_2d_u128_512)
+	{
+		run_swizzle_2d<16>(state, 512, 512, true);
+	}
+
+	// Smallest common size split into slices on the task pool (2 slices)
+	RPCS3_BENCH(texture_deswizzle_2d_u32_1024)
+	{
+		run_swizzle_2d<4>(state, 1024, 1024, true);
+	}
+
+	// Large enough to be split into slices on the task pool
+	RPCS3_BENCH(texture_deswizzle_2d_u32_2048)
+	{
+		run_swizzle_2d<4>(state, 2048, 2048, true);
+	}
+
+	// Swizzled render-to-texture and NV3089 blits (swizzle)
+	RPCS3_BENCH(texture_swizzle_2d_u8_512)
+	{
+		run_swizzle_2d<1>(state, 512, 512, false);
+	}
+
+	RPCS3_BENCH(texture_swizzle_2d_u16_512)
+	{
+		run_swizzle_2d<2>(state, 512, 512, false);
+	}
+
+	RPCS3_BENCH(texture_swizzle_2d_u32_512)
+	{
+		run_swizzle_2d<4>(state, 512, 512, false);
+	}
+
+	RPCS3_BENCH(texture_deswizzle_3d_u32_64)
+	{
+		using texel = std::array<u8, 4>;
+
+		static constexpr u16 edge = 64;
+		const usz size = usz{edge} * edge * edge * sizeof(texel);
+		const auto src = make_random_data<u8>(size);
+		std::vector<u8> dst(size);
+
+		while (state.keep_running())
+		{
+			rsx::convert_linear_swizzle_3d<texel>(src.data(), dst.data(), edge, edge, edge);
+			clobber_memory();
+		}
+
+		state.set_items_processed(state.iterations() * edge * edge * edge);
+		state.set_bytes_processed(state.iterations() * size);
+	}
+}
@@ -0,0 +1,302 @@
+#include "bench.h"
+
+#include "Emu/RSX/Program/FragmentProgramDecompiler.h"
+#include "Emu/RSX/Program/VertexProgramDecompiler.h"
+#include "Emu/RSX/Program/GLSLCommon.h"
+#include "Utilities/File.h"
+
+#include <sstream>
+
+// Decompiles raw shader ucode dumped by the on-disk shader cache (shaders_cache/raw/*.fp, *.vp)
+// through the shared decompiler frontends with a minimal GLSL backend that needs no GPU context.
+// Pass the directory with --param=shader_cache=<dir>.
+namespace bench
+{
+	struct null_fragment_decompiler final : public FragmentProgramDecompiler
+	{
+		using FragmentProgramDecompiler::FragmentProgramDecompiler;
+
+	protected:
+		std::string getFloatTypeName(usz elementCount) override
+		{
+			return glsl::getFloatTypeNameImpl(elementCount);
+		}
+
+		std::string getHalfTypeName(usz elementCount) override
+		{
+			return glsl::getHalfTypeNameImpl(elementCount);
+		}
+
+		std::string getFunction(FUNCTION f) override
+		{
+			return glsl::getFunctionImpl(f);
+		}
+
+		std::string compareFunction(COMPARE f, const std::string& Op0, const std::string& Op1) override
+		{
+			return glsl::compareFunctionImpl(f, Op0, Op1);
+		}
+
+		void insertHeader(std::stringstream& OS) override
+		{
+			OS << "#version 450\n";
+		}
+
+		void insertInputs(std::stringstream& OS) override
+		{
+			for (const ParamType& PT : m_parr.params[PF_PARAM_IN])
+			{
+				for (const ParamItem& PI : PT.items)
+				{
+					OS << "in " << PT.type << " " << PI.name << ";\n";
+				}
+			}
+		}
+
+		void insertOutputs(std::stringstream& OS) override
+		{
+			for (const ParamType& PT : m_parr.params[PF_PARAM_OUT])
+			{
+				for (const ParamItem& PI : PT.items)
+				{
+					OS << "out " << PT.type << " " << PI.name << ";\n";
+				}
+			}
+		}
+
+		void insertConstants(std::stringstream& OS) override
+		{
+			for (const ParamType& PT : m_parr.params[PF_PARAM_UNIFORM])
+			{
+				for (const ParamItem& PI : PT.items)
+				{
+					OS << "uniform " << PT.type << " " << PI.name << ";\n";
+				}
+			}
+		}
+
+		void insertGlobalFunctions(std::stringstream& OS) override
+		{
+			OS << "\n";
+		}
+
+		void insertMainStart(std::stringstream& OS) override
+		{
+			OS << "void fs_main()\n{\n";
+
+			for (const ParamType& PT : m_parr.params[PF_PARAM_NONE])
+			{
+				for (const ParamItem& PI : PT.items)
+				{
+					OS << "\t" << PT.type << " " << PI.name;
+					if (!PI.value.empty()) OS << " = " << PI.value;
+					OS << ";\n";
+				}
+			}
+		}
+
+		void insertMainEnd(std::stringstream& OS) override
+		{
+			OS << "}\n";
+		}
+	};
+
+	struct null_vertex_decompiler final : public VertexProgramDecompiler
+	{
+		using VertexProgramDecompiler::VertexProgramDecompiler;
+
+	protected:
+		std::string getFloatTypeName(usz elementCount) override
+		{
+			return glsl::getFloatTypeNameImpl(elementCount);
+		}
+
+		std::string getIntTypeName(usz /*elementCount*/) override
+		{
+			return "ivec4";
+		}
+
+		std::string getFunction(FUNCTION f) override
+		{
+			return glsl::getFunctionImpl(f);
+		}
+
+		std::string compareFunction(COMPARE f, const std::string& Op0, const std::string& Op1, bool scalar) override
+		{
+			return glsl::compareFunctionImpl(f, Op0, Op1, scalar);
+		}
+
+		void insertHeader(std::stringstream& OS) override
+		{
+			OS << "#version 450\n";
+		}
+
+		void insertInputs(std::stringstream& OS, const std::vector<ParamType>& inputs) override
+		{
+			for (const ParamType& PT : inputs)
+			{
+				for (const ParamItem& PI : PT.items)
+				{
+					OS << "in " << PT.type << " " << PI.name << ";\n";
+				}
+			}
+		}
+
+		void insertConstants(std::stringstream& OS, const std::vector<ParamType>& constants) override
+		{
+			for (const ParamType& PT : constants)
+			{
+				for (const ParamItem& PI : PT.items)
+				{
+					OS << "uniform " << PT.type << " " << PI.name << ";\n";
+				}
+			}
+		}
+
+		void insertOutputs(std::stringstream& OS, const std::vector<ParamType>& outputs) override
+		{
+			for (const ParamType& PT : outputs)
+			{
+				for (const ParamItem& PI : PT.items)
+				{
+					OS << "out " << PT.type << " " << PI.name << ";\n";
+				}
+			}
+		}
+
+		void insertMainStart(std::stringstream& OS) override
+		{
+			OS << "void vs_main()\n{\n";
+		}
+
+		void insertMainEnd(std::stringstream& OS) override
+		{
+			OS << "}\n";
+		}
+	};
+
+	struct shader_corpus
+	{
+		std::vector<std::vector<u8>> fp;
+		std::vector<std::vector<u32>> vp;
+		u64 fp_bytes = 0;
+		u64 vp_bytes = 0;
+	};
+
+	static const shader_corpus& get_shader_corpus()
+	{
+		static const shader_corpus s_corpus = []()
+		{
+			shader_corpus result;
+
+			std::string path{get_param("shader_cache")};
+
+			if (path.empty())
+			{
+				return result;
+			}
+
+			// Accept both the shaders_cache root and its raw/ subdirectory
+			if (fs::is_dir(path + "/raw"))
+			{
+				path += "/raw";
+			}
+
+			for (auto&& entry : fs::dir(path))
+			{
+				if (entry.is_directory)
+				{
+					continue;
+				}
+
+				fs::file f(path + "/" + entry.name);
+
+				if (!f || !f.size() || f.size() % 16)
+				{
+					continue;
+				}
+
+				if (entry.name.ends_with(".fp"))
+				{
+					std::vector<u8> data = f.to_vector<u8>();
+
+					// Two NOPs with the end bit set guard against truncated dumps (the first may be read as an inline constant)
+					static constexpr u8 sentinel[32]{0x00, 0x01, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x00, 0x01};
+					data.insert(data.end(), std::begin(sentinel), std::end(sentinel));
+
+					result.fp_bytes += f.size();
+					result.fp.emplace_back(std::move(data));
+				}
+				else if (entry.name.ends_with(".vp"))
+				{
+					result.vp_bytes += f.size();
+					result.vp.emplace_back(f.to_vector<u32>());
+				}
+			}
+
+			return result;
+		}();
+
+		return s_corpus;
+	}
+
+	RPCS3_BENCH(rsx_decompile_fragment_corpus)
+	{
+		const auto& corpus = get_shader_corpus();
+
+		if (corpus.fp.empty())
+		{
+			state.skip("no .fp files, pass --param=shader_cache=<dir>");
+			return;
+		}
+
+		while (state.keep_running())
+		{
+			for (const auto& ucode : corpus.fp)
+			{
+				RSXFragmentProgram prog{};
+				prog.data = const_cast<u8*>(ucode.data());
+				prog.ucode_length = ::size32(ucode);
+
+				u32 size = 0;
+				null_fragment_decompiler decompiler(prog, size);
+				do_not_optimize(decompiler.Decompile());
+			}
+		}
+
+		state.set_items_processed(state.iterations() * corpus.fp.size());
+		state.set_bytes_processed(state.iterations() * corpus.fp_bytes);
+	}
+
+	RPCS3_BENCH(rsx_decompile_vertex_corpus)
+	{
+		const auto& corpus = get_shader_corpus();
+
+		if (corpus.vp.empty())
+		{
+			state.skip("no .vp files, pass --param=shader_cache=<dir>");
+			return;
+		}
+
+		while (state.keep_running())
+		{
+			for (const auto& ucode : corpus.vp)
+			{
+				RSXVertexProgram prog{};
+				prog.data = ucode;
+
+				// The raw dump only holds live instructions, the pipeline state normally supplies the mask
+				for (usz i = 0; i < ucode.size() / 4 && i < prog.instruction_mask.size(); i++)
+				{
+					prog.instruction_mask.set(i);
+				}
+
+				null_vertex_decompiler decompiler(prog);
+				do_not_optimize(decompiler.Decompile());
+			}
+		}
+
+		state.set_items_processed(state.iterations() * corpus.vp.size());
+		state.set_bytes_processed(state.iterations() * corpus.vp_bytes);
+	}
+}
@@ -0,0 +1,146 @@
+#include "bench.h"
+
+#include "Emu/RSX/Program/GLSLTypes.h"
+#include "Emu/RSX/Program/SPIRVCommon.h"
+#include "Utilities/File.h"
+#include "Utilities/StrFmt.h"
+
+// Pipeline cache replay at boot: GLSL to SPIR-V for a set of synthetic fragment programs with an empty (cold)
+// and a fully populated (warm) blob cache in the temporary directory, and with the cache disabled.
+// Pass --param=spirv_shaders=<n> to change the number of programs (default 64).
+namespace bench
+{
+	struct spirv_corpus
+	{
+		std::string root;
+		std::string cache_path;
+		std::vector<std::string> shaders;
+		u64 bytes = 0;
+
+		spirv_corpus()
+		{
+			const std::string_view count_param = get_param("spirv_shaders");
+			const usz count = count_param.empty() ? 64 : std::max<usz>(1, std::stoull(std::string(count_param)));
+
+			spirv::initialize_compiler_context();
+
+			root = fs::get_temp_dir() + "rpcs3_bench_spirv/";
+			fs::remove_all(root, false, true);
+			fs::create_path(root);
+			cache_path = root + "spirv.bin";
+
+			// Roughly the size of a decompiled fragment program, each one distinct
+			for (usz i = 0; i < count; i++)
+			{
+				std::string& glsl = shaders.emplace_back(
+					"#version 450\n"
+					"layout(location=0) in vec4 tc0;\n"
+					"layout(location=0) out vec4 ocol0;\n"
+					"layout(set=0, binding=0) uniform sampler2D tex0;\n"
+					"layout(set=0, binding=1) uniform sampler2D tex1;\n"
+					"layout(set=0, binding=2) uniform sampler2D tex2;\n"
+					"layout(set=0, binding=3) uniform sampler2D tex3;\n"
+					"layout(std140, set=0, binding=4) uniform FragmentConstantsBuffer { vec4 fc[64]; };\n"
+					"\n"
+					"void main()\n"
+					"{\n"
+					"vec4 r0 = tc0;\n"
+					"vec4 r1 = vec4(0.);\n");
+
+				for (usz j = 0; j < 120; j++)
+				{
+					const usz c = (i + j) % 64;
+
+					switch ((i * 7 + j * 3 + j / 5) % 5)
+					{
+					case 0: fmt::append(glsl, "r0 = fma(r0, fc[%u], r1);\n", c); break;
+					case 1: fmt::append(glsl, "r1 = texture(tex%u, r0.xy) * r1;\n", j % 4); break;
+					case 2: fmt::append(glsl, "r0.xyz = mix(r0.xyz, r1.zyx, fc[%u].w);\n", c); break;
+					case 3: fmt::append(glsl, "r1 = clamp(r1 + fc[%u], 0., 1.);\n", c); break;
+					default: fmt::append(glsl, "if (r0.w > fc[%u].x) r0 = r1.wzyx;\n", c); break;
+					}
+				}
+
+				glsl += "ocol0 = r0;\n}\n";
+				bytes += glsl.size();
+			}
+		}
+
+		~spirv_corpus()
+		{
+			spirv::finalize_compiler_context();
+			fs::remove_all(root);
+		}
+
+		void compile_all() const
+		{
+			for (const std::string& source : shaders)
+			{
+				std::vector<u32> spv;
+				std::string shader = source;
+				ensure(spirv::compile_glsl_to_spv(spv, shader, glsl::glsl_fragment_program, glsl::glsl_rules_vulkan));
+				do_not_optimize(spv.data());
+			}
+		}
+	};
+
+	static const spirv_corpus& get_spirv_corpus()
+	{
+		static const spirv_corpus s_corpus;
+		return s_corpus;
+	}
+
+	// Without the blob cache: every pipeline is compiled by glslang
+	RPCS3_BENCH(spirv_compile_uncached)
+	{
+		const auto& corpus = get_spirv_corpus();
+
+		spirv::close_blob_cache();
+
+		while (state.keep_running())
+		{
+			corpus.compile_all();
+		}
+
+		state.set_items_processed(state.iterations() * corpus.shaders.size());
+		state.set_bytes_processed(state.iterations() * corpus.bytes);
+	}
+
+	// First boot: nothing cached yet, each blob is compiled and appended to the cache file
+	RPCS3_BENCH(spirv_compile_cold_cache)
+	{
+		const auto& corpus = get_spirv_corpus();
+
+		while (state.keep_running())
+		{
+			spirv::close_blob_cache();
+			fs::remove_file(corpus.cache_path);
+			spirv::open_blob_cache(corpus.cache_path);
+			corpus.compile_all();
+		}
+
+		spirv::close_blob_cache();
+		state.set_items_processed(state.iterations() * corpus.shaders.size());
+		state.set_bytes_processed(state.iterations() * corpus.bytes);
+	}
+
+	// Following boots: the cache file is indexed again and every blob is read back instead of compiled
+	RPCS3_BENCH(spirv_compile_warm_cache)
+	{
+		const auto& corpus = get_spirv_corpus();
+
+		fs::remove_file(corpus.cache_path);
+		spirv::open_blob_cache(corpus.cache_path);
+		corpus.compile_all();
+
+		while (state.keep_running())
+		{
+			spirv::open_blob_cache(corpus.cache_path);
+			corpus.compile_all();
+		}
+
+		spirv::close_blob_cache();
+		state.set_items_processed(state.iterations() * corpus.shaders.size());
+		state.set_bytes_processed(state.iterations() * corpus.bytes);
+	}
+}
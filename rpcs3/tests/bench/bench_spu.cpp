@@ -0,0 +1,143 @@
+#include "bench.h"
+
+#include "Emu/Cell/SPURecompiler.h"
+
+#include <cstring>
+#include <random>
+
+using spu_rdata_t = std::byte[128];
+
+extern void mov_rdata(spu_rdata_t& _dst, const spu_rdata_t& _src);
+extern bool cmp_rdata(const spu_rdata_t& _lhs, const spu_rdata_t& _rhs);
+
+namespace bench
+{
+	struct alignas(64) rdata_pair
+	{
+		std::byte a[128];
+		std::byte b[128];
+	};
+
+	static rdata_pair make_rdata_pair()
+	{
+		std::mt19937 rng(0x5eed);
+		rdata_pair result{};
+
+		for (auto& v : result.a)
+		{
+			v = static_cast<std::byte>(rng());
+		}
+
+		std::memcpy(result.b, result.a, sizeof(result.a));
+		return result;
+	}
+
+	// Reservation data comparison, equal lines (the expensive, common case)
+	RPCS3_BENCH(cmp_rdata_equal)
+	{
+		rdata_pair data = make_rdata_pair();
+
+		while (state.keep_running())
+		{
+			do_not_optimize(cmp_rdata(data.a, data.b));
+			clobber_memory();
+		}
+
+		state.set_bytes_processed(state.iterations() * 128);
+	}
+
+	// Difference in the last 16 bytes
+	RPCS3_BENCH(cmp_rdata_differ_tail)
+	{
+		rdata_pair data = make_rdata_pair();
+		data.b[127] ^= std::byte{1};
+
+		while (state.keep_running())
+		{
+			do_not_optimize(cmp_rdata(data.a, data.b));
+			clobber_memory();
+		}
+
+		state.set_bytes_processed(state.iterations() * 128);
+	}
+
+	RPCS3_BENCH(mov_rdata)
+	{
+		rdata_pair data = make_rdata_pair();
+
+		while (state.keep_running())
+		{
+			mov_rdata(data.b, data.a);
+			clobber_memory();
+		}
+
+		state.set_bytes_processed(state.iterations() * 128);
+	}
+
+	// Only the analyser is used
+	struct spu_analyser final : spu_recompiler_base
+	{
+		void init() override
+		{
+		}
+
+		spu_function_t compile(spu_program&&) override
+		{
+			return nullptr;
+		}
+	};
+
+	// Analysis of all programs in an existing SPU cache (pass --param=spu_cache=<path to spu-*.dat>)
+	RPCS3_BENCH(spu_analyse_cache)
+	{
+		static const std::deque<spu_program> s_programs = []()
+		{
+			const std::string path{get_param("spu_cache")};
+
+			if (path.empty() || !fs::is_file(path))
+			{
+				return std::deque<spu_program>{};
+			}
+
+			return spu_cache(path).get();
+		}();
+
+		if (s_programs.empty())
+		{
+			state.skip("no programs, pass --param=spu_cache=<path to spu-*.dat>");
+			return;
+		}
+
+		spu_analyser analyser;
+		std::vector<be_t<u32>> ls(SPU_LS_SIZE / 4);
+		u64 instructions = 0;
+
+		while (state.keep_running())
+		{
+			for (const spu_program& func : s_programs)
+			{
+				// Initialize LS with function data only (as when building the cache)
+				for (u32 i = 0, pos = func.lower_bound; i < func.data.size(); i++, pos += 4)
+				{
+					ls[pos / 4] = std::bit_cast<be_t<u32>>(func.data[i]);
+				}
+
+				const spu_program result = analyser.analyse(ls.data(), func.entry_point);
+				do_not_optimize(result.data.size());
+
+				for (u32 i = 0, pos = func.lower_bound; i < func.data.size(); i++, pos += 4)
+				{
+					ls[pos / 4] = 0;
+				}
+			}
+		}
+
+		for (const spu_program& func : s_programs)
+		{
+			instructions += func.data.size();
+		}
+
+		state.set_items_processed(state.iterations() * s_programs.size());
+		state.set_bytes_processed(state.iterations() * instructions * 4);
+	}
+}
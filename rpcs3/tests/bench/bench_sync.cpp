@@ -0,0 +1,224 @@
+#include "bench.h"
+
+#include "util/atomic.hpp"
+#include "Utilities/mutex.h"
+#include "Utilities/lockless.h"
+
+#include <thread>
+
+namespace bench
+{
+	// Round trip between two threads blocking on the same atomic
+	RPCS3_BENCH(atomic_wait_notify_ping_pong)
+	{
+		atomic_t<u32> value = 0;
+		const u64 count = state.iterations();
+
+		std::thread peer([&]()
+		{
+			for (u64 i = 0; i < count; i++)
+			{
+				value.wait(0);
+				value.release(0);
+				value.notify_one();
+			}
+		});
+
+		while (state.keep_running())
+		{
+			value.release(1);
+			value.notify_one();
+			value.wait(1);
+		}
+
+		peer.join();
+		state.set_items_processed(count);
+	}
+
+	// Cost of notifying when nobody waits (common fast path)
+	RPCS3_BENCH(atomic_notify_no_waiters)
+	{
+		atomic_t<u32> value = 0;
+
+		while (state.keep_running())
+		{
+			value++;
+			value.notify_all();
+		}
+
+		do_not_optimize(value.load());
+		state.set_items_processed(state.iterations());
+	}
+
+	RPCS3_BENCH(shared_mutex_uncontended_writer)
+	{
+		shared_mutex mutex;
+		u64 counter = 0;
+
+		while (state.keep_running())
+		{
+			std::lock_guard lock(mutex);
+			counter++;
+		}
+
+		do_not_optimize(counter);
+		state.set_items_processed(state.iterations());
+	}
+
+	RPCS3_BENCH(shared_mutex_uncontended_reader)
+	{
+		shared_mutex mutex;
+
+		while (state.keep_running())
+		{
+			reader_lock lock(mutex);
+			clobber_memory();
+		}
+
+		state.set_items_processed(state.iterations());
+	}
+
+	// Four readers and one writer share one lock, the main thread acts as the writer
+	RPCS3_BENCH(shared_mutex_contended_4r1w)
+	{
+		static constexpr u32 readers = 4;
+
+		shared_mutex mutex;
+		atomic_t<bool> stop = false;
+		atomic_t<u32> started = 0;
+		u64 counter = 0;
+
+		std::vector<std::thread> threads;
+
+		for (u32 i = 0; i < readers; i++)
+		{
+			threads.emplace_back([&]()
+			{
+				started++;
+
+				while (!stop)
+				{
+					reader_lock lock(mutex);
+					do_not_optimize(counter);
+				}
+			});
+		}
+
+		// Don't measure thread startup
+		while (started != readers)
+		{
+			std::this_thread::yield();
+		}
+
+		while (state.keep_running())
+		{
+			std::lock_guard lock(mutex);
+			counter++;
+		}
+
+		stop = true;
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		state.set_threads(readers + 1);
+		state.set_items_processed(state.iterations());
+	}
+
+	// Batch of 64 pushes followed by draining the queue
+	RPCS3_BENCH(lf_queue_push_pop_all)
+	{
+		lf_queue<u64> queue;
+		u64 sum = 0;
+
+		while (state.keep_running())
+		{
+			for (u64 i = 0; i < 64; i++)
+			{
+				queue.push(i);
+			}
+
+			for (u64 v : queue.pop_all())
+			{
+				sum += v;
+			}
+		}
+
+		do_not_optimize(sum);
+		state.set_items_processed(state.iterations() * 64);
+	}
+
+	// Producers on two threads, consumer on the main thread
+	RPCS3_BENCH(lf_queue_mpsc)
+	{
+		static constexpr u32 producers = 2;
+
+		lf_queue<u64> queue;
+		const u64 count = state.iterations();
+
+		std::vector<std::thread> threads;
+
+		for (u32 t = 0; t < producers; t++)
+		{
+			threads.emplace_back([&, t]()
+			{
+				for (u64 i = t; i < count; i += producers)
+				{
+					queue.push(i);
+				}
+			});
+		}
+
+		u64 received = 0;
+
+		while (received < count)
+		{
+			queue.wait();
+
+			for (u64 v : queue.pop_all())
+			{
+				do_not_optimize(v);
+				received++;
+			}
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		// Keep the loop counter consistent with the amount of work done
+		while (state.keep_running())
+		{
+		}
+
+		state.set_threads(producers + 1);
+		state.set_items_processed(count);
+	}
+
+	// lf_bunch is append-only, measure pushes and iteration over a fresh instance
+	RPCS3_BENCH(lf_bunch_push_iterate)
+	{
+		u64 sum = 0;
+
+		while (state.keep_running())
+		{
+			lf_bunch<u64> bunch;
+
+			for (u64 i = 0; i < 64; i++)
+			{
+				bunch.push(i);
+			}
+
+			for (u64 v : bunch)
+			{
+				sum += v;
+			}
+		}
+
+		do_not_optimize(sum);
+		state.set_items_processed(state.iterations() * 64);
+	}
+}
@@ -0,0 +1,111 @@
+#include "bench.h"
+
+#include "Utilities/Thread.h"
+#include "util/sysinfo.hpp"
+
+// Shared task pool (Utilities/Thread.h) against a named_thread_group per workload, as the compile workloads used before.
+namespace bench
+{
+	// Stand-in for compiling one function: CPU bound work on private data
+	static u64 compile_unit(u64 seed)
+	{
+		u64 hash = seed;
+
+		for (u32 i = 0; i < 20000; i++)
+		{
+			hash = (hash ^ (hash >> 29)) * 0xbf58476d1ce4e5b9 + i;
+		}
+
+		return hash;
+	}
+
+	static constexpr u32 s_units = 2048;
+
+	// Workers pull units from a shared cursor like the PPU and SPU compilers do
+	static void run_compile(std::string_view name, bool use_pool)
+	{
+		const u32 threads = std::max<u32>(utils::get_thread_count(), 1);
+
+		atomic_t<u32> cursor = 0;
+		atomic_t<u64> result = 0;
+
+		auto work = [&]()
+		{
+			for (u32 i = cursor++; i < s_units; i = cursor++)
+			{
+				result += compile_unit(i);
+			}
+		};
+
+		if (use_pool)
+		{
+			task_pool::submit(name, threads, task_priority::normal, [&](task_job&, u32) { work(); })->join();
+		}
+		else
+		{
+			named_thread_group workers(name, threads, [&]() { work(); });
+			workers.join();
+		}
+
+		do_not_optimize(result.load());
+	}
+
+	RPCS3_BENCH(task_pool_compile_throughput)
+	{
+		while (state.keep_running())
+		{
+			run_compile("Bench Compiler ", true);
+		}
+
+		state.set_items_processed(state.iterations() * s_units);
+		state.set_threads(task_pool::get_thread_limit());
+	}
+
+	RPCS3_BENCH(thread_group_compile_throughput)
+	{
+		while (state.keep_running())
+		{
+			run_compile("Bench Compiler ", false);
+		}
+
+		state.set_items_processed(state.iterations() * s_units);
+		state.set_threads(std::max<u32>(utils::get_thread_count(), 1));
+	}
+
+	// Short per-frame job (picture conversion, swizzle): overhead of dispatching 4 slices and waiting for them
+	RPCS3_BENCH(task_pool_small_job_latency)
+	{
+		atomic_t<u64> result = 0;
+
+		while (state.keep_running())
+		{
+			task_pool::submit("Bench Slices", 4, task_priority::high, [&](task_job&, u32 slot)
+			{
+				result += slot;
+			})->join();
+		}
+
+		do_not_optimize(result.load());
+		state.set_items_processed(state.iterations());
+	}
+
+	RPCS3_BENCH(thread_group_small_job_latency)
+	{
+		atomic_t<u64> result = 0;
+
+		while (state.keep_running())
+		{
+			atomic_t<u32> slot = 0;
+
+			named_thread_group workers("Bench Slices "sv, 4, [&]()
+			{
+				result += slot++;
+			});
+
+			workers.join();
+		}
+
+		do_not_optimize(result.load());
+		state.set_items_processed(state.iterations());
+	}
+}
@@ -0,0 +1,194 @@
+#include "bench.h"
+
+#include "tests/rsx_texture_cache_mock.h"
+
+#include "Utilities/File.h"
+
+#include <thread>
+
+// Texture cache lookup, invalidation and eviction on the CPU mock backend (see rsx_texture_cache_mock.h).
+// Pass --param=trace=<file> to replay a recorded texture cache trace.
+namespace bench
+{
+	using namespace rsx::mock;
+
+	static constexpr u32 s_argb8 = CELL_GCM_TEXTURE_A8R8G8B8;
+
+	// Sampling a working set of textures already in the cache
+	RPCS3_BENCH(texture_cache_lookup_hit)
+	{
+		harness h;
+
+		for (u32 i = 0; i < 256; i++)
+		{
+			h.upload(i * 0x10000, 128, 128, 512, s_argb8);
+		}
+
+		u32 index = 0;
+
+		while (state.keep_running())
+		{
+			do_not_optimize(h.upload((index++ % 256) * 0x10000, 128, 128, 512, s_argb8));
+		}
+
+		state.set_items_processed(state.iterations());
+		state.set_counter("misses", static_cast<f64>(h.stats.upload_misses - 256));
+	}
+
+	// CPU write to a sampled texture followed by a reupload (streaming textures)
+	RPCS3_BENCH(texture_cache_write_invalidate)
+	{
+		harness h;
+
+		u32 index = 0;
+
+		while (state.keep_running())
+		{
+			const u32 offset = (index++ % 64) * 0x10000;
+			h.write(offset, 0x100, static_cast<u8>(index));
+			do_not_optimize(h.upload(offset, 128, 128, 512, s_argb8));
+		}
+
+		state.set_items_processed(state.iterations());
+		state.set_bytes_processed(state.iterations() * 128 * 512);
+	}
+
+	// Same as texture_cache_write_invalidate when the data written does not change, with upload deduplication
+	RPCS3_BENCH(texture_cache_write_dedup)
+	{
+		g_cfg.video.deduplicate_texture_uploads.set(true);
+
+		harness h;
+		u32 index = 0;
+
+		while (state.keep_running())
+		{
+			const u32 offset = (index++ % 64) * 0x10000;
+			h.write(offset, 0x100, 0);
+			do_not_optimize(h.upload(offset, 128, 128, 512, s_argb8));
+		}
+
+		g_cfg.video.deduplicate_texture_uploads.set(false);
+
+		state.set_items_processed(state.iterations());
+		state.set_bytes_processed(state.iterations() * 128 * 512);
+		state.set_counter("dedup_rate", static_cast<f64>(h.stats.dedup_hits) / state.iterations());
+	}
+
+	// Framebuffer memory locked, read back by the CPU and flushed every iteration
+	RPCS3_BENCH(texture_cache_lock_flush)
+	{
+		harness h;
+
+		while (state.keep_running())
+		{
+			h.lock(0x1000000, 256, 256, 1024, s_argb8);
+			h.invalidate(0x1000000, 4, rsx::invalidation_cause::deferred_read);
+			h.flush();
+		}
+
+		state.set_items_processed(state.iterations());
+		state.set_bytes_processed(state.iterations() * 256 * 1024);
+	}
+
+	// Eviction of unreleased sections at frame end after the whole working set is invalidated
+	RPCS3_BENCH(texture_cache_frame_purge)
+	{
+		harness h;
+
+		while (state.keep_running())
+		{
+			for (u32 i = 0; i < 128; i++)
+			{
+				h.upload(i * 0x4000, 64, 64, 256, s_argb8);
+			}
+
+			h.invalidate(0, 128 * 0x4000, rsx::invalidation_cause::write);
+			h.end_frame();
+		}
+
+		state.set_items_processed(state.iterations() * 128);
+	}
+
+	// Access violation handling (invalidate_address) while another thread keeps sampling cached textures like the RSX thread does
+	static void run_fault_latency(state& state, u32 fault_offset)
+	{
+		harness h;
+
+		// Textures on both sides of the faulting memory block
+		for (u32 i = 0; i < 64; i++)
+		{
+			h.upload(i * 0x10000, 128, 128, 512, s_argb8);
+		}
+
+		h.upload(0x8000000, 128, 128, 512, s_argb8);
+
+		atomic_t<bool> stop = false;
+
+		std::thread rsx_thread([&]()
+		{
+			for (u32 index = 0; !stop; index++)
+			{
+				do_not_optimize(h.upload((index % 64) * 0x10000, 128, 128, 512, s_argb8));
+			}
+		});
+
+		command_list cmd;
+		u64 handled = 0;
+
+		while (state.keep_running())
+		{
+			handled += h.cache.invalidate_address(cmd, rsx::constants::local_mem_base + fault_offset, rsx::invalidation_cause::deferred_write).violation_handled;
+		}
+
+		stop = true;
+		rsx_thread.join();
+
+		state.set_threads(2);
+		state.set_items_processed(state.iterations());
+		state.set_counter("handled_rate", static_cast<f64>(handled) / state.iterations());
+		state.set_counter("lock_wait_us_per_fault", static_cast<f64>(h.cache.get_fault_lock_wait_time_this_frame()) / state.iterations());
+	}
+
+	// Page outside of any cached texture (e.g. ZCULL report memory)
+	RPCS3_BENCH(texture_cache_fault_uncached_page)
+	{
+		run_fault_latency(state, 0x4000000);
+	}
+
+	// Page of a texture being sampled, invalidated and uploaded again
+	RPCS3_BENCH(texture_cache_fault_sampled_texture)
+	{
+		run_fault_latency(state, 0x100000);
+	}
+
+	RPCS3_BENCH(texture_cache_trace_replay)
+	{
+		const std::string path{get_param("trace")};
+		std::string text;
+
+		if (fs::file trace{path}; !path.empty() && trace)
+		{
+			text = trace.to_string();
+		}
+
+		if (text.empty())
+		{
+			state.skip("no texture cache trace, pass --param=trace=<file>");
+			return;
+		}
+
+		const auto ops = parse_trace(text);
+		harness h;
+
+		while (state.keep_running())
+		{
+			h.replay(ops);
+			h.end_frame();
+		}
+
+		state.set_items_processed(state.iterations() * ops.size());
+		state.set_counter("miss_rate", static_cast<f64>(h.stats.upload_misses) / std::max<u64>(h.stats.uploads, 1));
+		state.set_counter("flushes_per_replay", static_cast<f64>(h.stats.flushed_sections) / state.iterations());
+	}
+}
@@ -0,0 +1,183 @@
+#include "bench.h"
+
+#include "Utilities/File.h"
+#include "Utilities/StrFmt.h"
+#include "util/serialization.hpp"
+#include "util/serialization_ext.hpp"
+
+#include <random>
+
+namespace bench
+{
+	RPCS3_BENCH(fmt_format_mixed)
+	{
+		const std::string name = "SPU Worker";
+		u64 total = 0;
+		u32 i = 0;
+
+		while (state.keep_running())
+		{
+			const std::string str = fmt::format("%s #%u: addr=0x%08x size=%u ratio=%.2f", name, i, i * 0x100u, i & 0xffff, i / 7.0);
+			total += str.size();
+			i++;
+		}
+
+		do_not_optimize(total);
+		state.set_items_processed(state.iterations());
+	}
+
+	RPCS3_BENCH(fmt_append_hex_dump)
+	{
+		u8 data[256];
+		std::mt19937 rng(0x5eed);
+
+		for (u8& b : data)
+		{
+			b = static_cast<u8>(rng());
+		}
+
+		std::string out;
+
+		while (state.keep_running())
+		{
+			out.clear();
+
+			for (u8 b : data)
+			{
+				fmt::append(out, "%02x ", b);
+			}
+
+			do_not_optimize(out.data());
+		}
+
+		state.set_bytes_processed(state.iterations() * sizeof(data));
+	}
+
+	struct serial_payload
+	{
+		u64 id;
+		u32 flags;
+		std::string name;
+		std::vector<u32> words;
+	};
+
+	// Savestate-like mix: scalars, a string and a bulk vector, written then read back
+	RPCS3_BENCH(serial_round_trip)
+	{
+		std::mt19937 rng(0x5eed);
+
+		std::vector<serial_payload> items(64);
+
+		for (auto& item : items)
+		{
+			item.id = rng();
+			item.flags = rng();
+			item.name = fmt::format("object_%u", item.id % 1000);
+			item.words.resize(64 + rng() % 64);
+
+			for (u32& w : item.words)
+			{
+				w = rng();
+			}
+		}
+
+		u64 bytes = 0;
+
+		while (state.keep_running())
+		{
+			utils::serial ar;
+
+			for (auto& item : items)
+			{
+				ar(item.id, item.flags, item.name, item.words);
+			}
+
+			bytes += ar.data.size();
+			ar.set_reading_state();
+
+			for (usz i = 0; i < items.size(); i++)
+			{
+				serial_payload out{};
+				ar(out.id, out.flags, out.name, out.words);
+				do_not_optimize(out.words.data());
+			}
+		}
+
+		state.set_bytes_processed(bytes);
+	}
+
+	// 256MB zstd savestate stream made of 16MB frames (as flushed by breathe)
+	static const std::vector<u8>& get_zstd_savestate()
+	{
+		static const std::vector<u8> s_data = []()
+		{
+			fs::file file = fs::make_stream<std::vector<u8>>();
+
+			utils::serial ar;
+			ar.m_file_handler = make_compressed_zstd_serialization_file_handler(file);
+
+			std::mt19937 rng(0x5eed);
+
+			for (u64 i = 0; i < 0x200'0000; i++)
+			{
+				// Partially compressible
+				ar(i % 7 ? u64{i / 64} : u64{rng()});
+				ar.breathe();
+			}
+
+			ar.m_file_handler->finalize(ar);
+
+			file.seek(0);
+			return file.to_vector<u8>();
+		}();
+
+		return s_data;
+	}
+
+	static void run_zstd_load(state& state, bool seek_table)
+	{
+		std::vector<u8> data = get_zstd_savestate();
+
+		if (!seek_table)
+		{
+			// Strip the trailing seek table (skippable frame), as written by older versions
+			const u32 frame_count = read_from_ptr<le_t<u32>>(data, data.size() - 9);
+			data.resize(data.size() - (8 + frame_count * 8 + 9));
+		}
+
+		u64 bytes = 0;
+
+		while (state.keep_running())
+		{
+			utils::serial ar;
+			ar.set_reading_state();
+			ar.m_file_handler = make_compressed_zstd_serialization_file_handler(fs::make_stream(std::vector<u8>(data)));
+
+			u64 sum = 0;
+
+			for (u64 i = 0; i < 0x200'0000; i++)
+			{
+				sum += ar.pop<u64>();
+				ar.breathe();
+			}
+
+			do_not_optimize(sum);
+			bytes += ar.pos;
+			ar.m_file_handler->finalize(ar);
+		}
+
+		state.set_bytes_processed(bytes);
+	}
+
+	// Savestate load with parallel frame decompression
+	RPCS3_BENCH(serial_zstd_load)
+	{
+		run_zstd_load(state, true);
+	}
+
+	// Savestate load of a stream without a seek table (single threaded streaming decompression)
+	RPCS3_BENCH(serial_zstd_load_sequential)
+	{
+		run_zstd_load(state, false);
+	}
+}
@@ -0,0 +1,200 @@
+#include "bench.h"
+
+#include "Utilities/File.h"
+
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+#pragma GCC diagnostic ignored "-Wextra"
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+#endif
+extern "C"
+{
+#include "libavcodec/avcodec.h"
+#include "libswscale/swscale.h"
+}
+#ifdef _MSC_VER
+#pragma warning(pop)
+#else
+#pragma GCC diagnostic pop
+#endif
+
+#include <cstring>
+#include <memory>
+
+extern void vdec_convert_picture(std::vector<SwsContext*>& sws, std::vector<u8>& alpha_plane, const AVFrame& frame, u32 format_type, u8 alpha, u8* out, u32 max_slices);
+
+// Decodes an MPEG-2 (.m2v) or H.264 (.264/.h264) elementary stream passed with --param=video=<file>
+// and measures the work done by cellVdecGetPicture for each picture (ARGB output).
+namespace bench
+{
+	struct frame_deleter
+	{
+		void operator()(AVFrame* frame) const
+		{
+			av_frame_free(&frame);
+		}
+	};
+
+	struct video_corpus
+	{
+		std::vector<std::unique_ptr<AVFrame, frame_deleter>> frames;
+		usz picture_size = 0;
+	};
+
+	static constexpr usz s_max_frames = 120;
+
+	// CELL_VDEC_PICFMT_ARGB32_ILV (cellVdec.h needs the whole guest memory headers)
+	static constexpr u32 s_picfmt_argb32 = 0;
+
+	static const video_corpus& get_video_corpus()
+	{
+		static const video_corpus s_corpus = []()
+		{
+			video_corpus result;
+
+			const std::string path{get_param("video")};
+
+			fs::file file;
+
+			if (path.empty() || !file.open(path))
+			{
+				return result;
+			}
+
+			const AVCodecID codec_id = path.ends_with(".m2v") ? AV_CODEC_ID_MPEG2VIDEO : AV_CODEC_ID_H264;
+			const AVCodec* codec = avcodec_find_decoder(codec_id);
+			AVCodecContext* ctx = codec ? avcodec_alloc_context3(codec) : nullptr;
+			AVCodecParserContext* parser = av_parser_init(codec_id);
+			AVPacket* packet = av_packet_alloc();
+
+			if (ctx && parser && packet && avcodec_open2(ctx, codec, nullptr) == 0)
+			{
+				std::vector<u8> data = file.to_vector<u8>();
+
+				// The parser may read past the end of its input
+				data.resize(data.size() + 64);
+
+				const auto receive = [&]()
+				{
+					while (result.frames.size() < s_max_frames)
+					{
+						std::unique_ptr<AVFrame, frame_deleter> frame(av_frame_alloc());
+
+						if (avcodec_receive_frame(ctx, frame.get()) < 0)
+						{
+							break;
+						}
+
+						if (frame->format == AV_PIX_FMT_YUV420P || frame->format == AV_PIX_FMT_YUVJ420P)
+						{
+							result.picture_size = std::max<usz>(result.picture_size, usz{frame->width * 4u} * frame->height);
+							result.frames.emplace_back(std::move(frame));
+						}
+					}
+				};
+
+				for (usz pos = 0, end = data.size() - 64; pos < end && result.frames.size() < s_max_frames;)
+				{
+					const int used = av_parser_parse2(parser, ctx, &packet->data, &packet->size, data.data() + pos, ::narrow<int>(end - pos), AV_NOPTS_VALUE, AV_NOPTS_VALUE, 0);
+
+					if (used < 0)
+					{
+						break;
+					}
+
+					pos += used;
+
+					if (packet->size && avcodec_send_packet(ctx, packet) == 0)
+					{
+						receive();
+					}
+				}
+
+				// Drain the decoder
+				avcodec_send_packet(ctx, nullptr);
+				receive();
+			}
+
+			av_packet_free(&packet);
+			av_parser_close(parser);
+			avcodec_free_context(&ctx);
+			return result;
+		}();
+
+		return s_corpus;
+	}
+
+	static void convert_corpus(state& state, u32 max_slices)
+	{
+		const auto& corpus = get_video_corpus();
+
+		if (corpus.frames.empty())
+		{
+			state.skip("no decodable frames, pass --param=video=<file.m2v|file.264>");
+			return;
+		}
+
+		std::vector<SwsContext*> sws;
+		std::vector<u8> alpha_plane;
+		std::vector<u8> out(corpus.picture_size);
+
+		while (state.keep_running())
+		{
+			for (const auto& frame : corpus.frames)
+			{
+				vdec_convert_picture(sws, alpha_plane, *frame, s_picfmt_argb32, 0xff, out.data(), max_slices);
+				clobber_memory();
+			}
+		}
+
+		for (SwsContext* context : sws)
+		{
+			sws_freeContext(context);
+		}
+
+		state.set_items_processed(state.iterations() * corpus.frames.size());
+		state.set_bytes_processed(state.iterations() * corpus.frames.size() * corpus.picture_size);
+	}
+
+	// Conversion in the guest call on a single thread (previous behaviour, and fallback when the format changes)
+	RPCS3_BENCH(vdec_get_picture_convert)
+	{
+		convert_corpus(state, 1);
+	}
+
+	// Same conversion split into slices on the task pool
+	RPCS3_BENCH(vdec_get_picture_convert_sliced)
+	{
+		convert_corpus(state, 4);
+	}
+
+	// Picture already converted by the decoder thread, the guest call only copies it
+	RPCS3_BENCH(vdec_get_picture_converted_ahead)
+	{
+		const auto& corpus = get_video_corpus();
+
+		if (corpus.frames.empty())
+		{
+			state.skip("no decodable frames, pass --param=video=<file.m2v|file.264>");
+			return;
+		}
+
+		std::vector<u8> picture(corpus.picture_size);
+		std::vector<u8> out(corpus.picture_size);
+
+		while (state.keep_running())
+		{
+			for (usz i = 0; i < corpus.frames.size(); i++)
+			{
+				std::memcpy(out.data(), picture.data(), picture.size());
+				clobber_memory();
+			}
+		}
+
+		state.set_items_processed(state.iterations() * corpus.frames.size());
+		state.set_bytes_processed(state.iterations() * corpus.frames.size() * corpus.picture_size);
+	}
+}
@@ -0,0 +1,1180 @@
+#pragma once
+
+#include "Emu/RSX/Common/surface_utils.h"
+#include "Emu/RSX/Common/texture_cache.h"
+#include "Emu/RSX/Common/TextureUtils.h"
+#include "Emu/RSX/RSXTexture.h"
+#include "Emu/Memory/vm.h"
+#include "Emu/System.h"
+#include "Emu/system_config.h"
+#include "util/asm.hpp"
+
+#include <deque>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Headless texture cache: a CPU backend for rsx::texture_cache where images are host buffers and all transfers are memcpy,
+// and a harness replaying sequences of texture cache calls against RSX local memory.
+// No GPU is required, the renderer object only exists to answer the queries made by the texture cache and is never started.
+namespace rsx::mock
+{
+	struct image;
+	struct image_view;
+	struct render_target;
+	class cached_texture_section;
+	class texture_cache;
+
+	// Counts the work submitted by the texture cache
+	struct command_list
+	{
+		u32 uploads = 0;       // Images uploaded from guest memory
+		u32 copies = 0;        // Image to image transfers
+		u32 dma_transfers = 0; // Image readbacks for flushing
+		u32 barriers = 0;
+	};
+
+	struct texture_cache_traits
+	{
+		using commandbuffer_type      = mock::command_list;
+		using section_storage_type    = mock::cached_texture_section;
+		using texture_cache_type      = mock::texture_cache;
+		using texture_cache_base_type = rsx::texture_cache<texture_cache_type, texture_cache_traits>;
+		using image_resource_type     = mock::image*;
+		using image_view_type         = mock::image_view*;
+		using image_storage_type      = mock::image;
+		using texture_format          = u32;
+		using viewable_image_type     = mock::image*;
+	};
+
+	struct image_view
+	{
+		mock::image* const img;
+		const texture_channel_remap_t remap;
+
+		mock::image* image() const
+		{
+			return img;
+		}
+
+		u32 encoded_component_map() const
+		{
+			return remap.encoded;
+		}
+	};
+
+	// Image contents are kept in the guest layout (no format conversion), only the base level is stored
+	struct image
+	{
+		const u32 gcm_format;
+		const u16 m_width;
+		const u16 m_height;
+		const u16 m_depth; // Layers or slices
+		const u16 mipmaps;
+		const rsx::texture_dimension_extended type;
+		const rsx::format_class m_format_class;
+
+		std::vector<u8> data;
+		std::vector<std::unique_ptr<image_view>> views;
+
+		image(u32 gcm_format, u16 width, u16 height, u16 depth, u16 mipmaps, rsx::texture_dimension_extended type)
+			: gcm_format(gcm_format)
+			, m_width(width)
+			, m_height(height)
+			, m_depth(depth)
+			, mipmaps(mipmaps)
+			, type(type)
+			, m_format_class(rsx::classify_format(gcm_format))
+			, data(usz{slice_size()} * m_depth)
+		{
+		}
+
+		image(const image&) = delete;
+
+		virtual ~image() = default;
+
+		u16 width() const
+		{
+			return m_width;
+		}
+
+		u16 height() const
+		{
+			return m_height;
+		}
+
+		u16 depth() const
+		{
+			return m_depth;
+		}
+
+		rsx::format_class format_class() const
+		{
+			return m_format_class;
+		}
+
+		u8 samples() const
+		{
+			return 1;
+		}
+
+		u32 block_size() const
+		{
+			return rsx::get_format_block_size_in_texel(gcm_format);
+		}
+
+		u32 bpp() const
+		{
+			return rsx::get_format_block_size_in_bytes(gcm_format);
+		}
+
+		u32 pitch() const
+		{
+			return utils::aligned_div<u32>(m_width, block_size()) * bpp();
+		}
+
+		u32 rows() const
+		{
+			return utils::aligned_div<u32>(m_height, block_size());
+		}
+
+		u32 slice_size() const
+		{
+			return pitch() * rows();
+		}
+
+		u8* slice(u32 index)
+		{
+			return data.data() + usz{slice_size()} * index;
+		}
+
+		image_view* get_view(const texture_channel_remap_t& remap)
+		{
+			for (const auto& view : views)
+			{
+				if (view->remap.control_map == remap.control_map && view->remap.channel_map == remap.channel_map)
+				{
+					return view.get();
+				}
+			}
+
+			return views.emplace_back(std::make_unique<image_view>(this, remap)).get();
+		}
+
+		// Nearest-neighbour copy of a rectangle in texels, the formats must have the same block size
+		void copy_from(const image& src, u32 src_slice, u16 src_x, u16 src_y, u16 src_w, u16 src_h, u32 dst_slice, u16 dst_x, u16 dst_y, u16 dst_w, u16 dst_h)
+		{
+			const u32 block = block_size();
+			const u32 block_bytes = std::min(bpp(), src.bpp());
+
+			if (!src_w || !src_h || !dst_w || !dst_h || src_slice >= src.m_depth || dst_slice >= m_depth)
+			{
+				return;
+			}
+
+			const u8* src_base = src.data.data() + usz{src.slice_size()} * src_slice;
+			u8* dst_base = slice(dst_slice);
+
+			for (u32 y = dst_y / block; y < std::min<u32>(dst_y + dst_h, m_height) / block; y++)
+			{
+				const u32 sy = (src_y + (y * block - dst_y) * src_h / dst_h) / block;
+
+				if (sy >= src.rows())
+				{
+					break;
+				}
+
+				for (u32 x = dst_x / block; x < std::min<u32>(dst_x + dst_w, m_width) / block; x++)
+				{
+					const u32 sx = (src_x + (x * block - dst_x) * src_w / dst_w) / block;
+
+					if (sx * src.bpp() >= src.pitch())
+					{
+						break;
+					}
+
+					std::memcpy(dst_base + y * pitch() + x * bpp(), src_base + sy * src.pitch() + sx * src.bpp(), block_bytes);
+				}
+			}
+		}
+	};
+
+	struct render_target : public image, public rsx::render_target_descriptor<mock::image*>
+	{
+		render_target(u32 gcm_format, u16 width, u16 height, u32 pitch)
+			: image(gcm_format, width, height, 1, 1, rsx::texture_dimension_extended::texture_dimension_2d)
+		{
+			surface_width = width;
+			surface_height = height;
+			native_pitch = image::pitch();
+			rsx_pitch = pitch;
+		}
+
+		mock::image* get_surface(rsx::surface_access /*access_type*/) override
+		{
+			return this;
+		}
+
+		bool is_depth_surface() const override
+		{
+			return format_class() != RSX_FORMAT_CLASS_COLOR;
+		}
+
+		void memory_barrier(mock::command_list& cmd, rsx::surface_access /*access*/)
+		{
+			cmd.barriers++;
+		}
+	};
+
+	static inline render_target* as_rtt(mock::image* t)
+	{
+		return ensure(dynamic_cast<render_target*>(t));
+	}
+
+	class cached_texture_section : public rsx::cached_texture_section<mock::cached_texture_section, mock::texture_cache_traits>
+	{
+		using baseclass = rsx::cached_texture_section<mock::cached_texture_section, mock::texture_cache_traits>;
+		friend baseclass;
+
+		mock::image* vram_texture = nullptr;
+		std::unique_ptr<mock::image> managed_texture;
+
+		// Readback of the image in the guest layout
+		std::vector<u8> dma_buffer;
+
+	public:
+		using baseclass::cached_texture_section;
+
+		void create(u16 w, u16 h, u16 depth, u16 mipmaps, mock::image* image, u32 rsx_pitch, bool managed)
+		{
+			ensure(!exists() || !is_managed() || vram_texture == image);
+
+			if (vram_texture != image && !managed_texture && get_protection() == utils::protection::no)
+			{
+				// In-place image swap, still locked
+				as_rtt(vram_texture)->on_swap_out();
+
+				if (!managed)
+				{
+					as_rtt(image)->on_swap_in(is_locked());
+				}
+			}
+
+			vram_texture = image;
+
+			if (managed)
+			{
+				managed_texture.reset(vram_texture);
+			}
+			else
+			{
+				ensure(!managed_texture);
+			}
+
+			if (auto rtt = dynamic_cast<mock::render_target*>(image))
+			{
+				swizzled = (rtt->raster_type != rsx::surface_raster_type::linear);
+			}
+
+			flushed = false;
+			synchronized = false;
+			sync_timestamp = 0ull;
+
+			ensure(rsx_pitch);
+
+			this->rsx_pitch = rsx_pitch;
+			this->width = w;
+			this->height = h;
+			this->real_pitch = 0;
+			this->depth = depth;
+			this->mipmaps = mipmaps;
+
+			baseclass::on_section_resources_created();
+		}
+
+		void set_dimensions(u32 width, u32 height, u32 /*depth*/, u32 pitch)
+		{
+			this->width = width;
+			this->height = height;
+			rsx_pitch = pitch;
+		}
+
+		void dma_transfer(mock::command_list& cmd, mock::image* src, const areai& /*src_area*/, const utils::address_range& /*valid_range*/, u32 pitch)
+		{
+			cmd.dma_transfers++;
+
+			dma_buffer.assign(src->data.begin(), src->data.begin() + src->slice_size());
+			real_pitch = src->pitch();
+			rsx_pitch = pitch;
+
+			synchronized = true;
+			sync_timestamp = rsx::get_shared_tag();
+		}
+
+		void copy_texture(mock::command_list& cmd, bool miss)
+		{
+			ensure(exists());
+
+			if (!miss) [[likely]]
+			{
+				baseclass::on_speculative_flush();
+			}
+			else
+			{
+				baseclass::on_miss();
+			}
+
+			mock::image* target_texture = vram_texture;
+
+			if (context == rsx::texture_upload_context::framebuffer_storage)
+			{
+				target_texture = as_rtt(vram_texture)->get_surface(rsx::surface_access::transfer_read);
+			}
+
+			dma_transfer(cmd, target_texture, {}, {}, rsx_pitch);
+		}
+
+		/**
+		 * Flush
+		 */
+		void* map_synchronized(u32 offset, u32 size)
+		{
+			AUDIT(synchronized);
+
+			ensure(offset + u64{size} <= dma_buffer.size());
+			return dma_buffer.data() + offset;
+		}
+
+		void finish_flush()
+		{
+		}
+
+		/**
+		 * Misc
+		 */
+		void destroy()
+		{
+			if (!is_locked() && dma_buffer.empty() && vram_texture == nullptr && !managed_texture)
+				//Already destroyed
+				return;
+
+			dma_buffer = {};
+			managed_texture.reset();
+			vram_texture = nullptr;
+
+			baseclass::on_section_resources_destroyed();
+		}
+
+		void sync_surface_memory(const std::vector<cached_texture_section*>& surfaces)
+		{
+			auto rtt = as_rtt(vram_texture);
+			rtt->sync_tag();
+
+			for (auto& surface : surfaces)
+			{
+				rtt->inherit_surface_contents(as_rtt(surface->vram_texture));
+			}
+		}
+
+		bool exists() const
+		{
+			return (vram_texture != nullptr);
+		}
+
+		bool is_managed() const
+		{
+			return !exists() || managed_texture;
+		}
+
+		u32 get_format() const
+		{
+			return vram_texture->gcm_format;
+		}
+
+		mock::image_view* get_view(const rsx::texture_channel_remap_t& remap)
+		{
+			return vram_texture->get_view(remap);
+		}
+
+		mock::image* get_raw_texture() const
+		{
+			return managed_texture.get();
+		}
+
+		mock::render_target* get_render_target() const
+		{
+			return as_rtt(vram_texture);
+		}
+
+		mock::image_view* get_raw_view()
+		{
+			return vram_texture->get_view(rsx::default_remap_vector);
+		}
+
+		bool is_depth_texture() const
+		{
+			return vram_texture->format_class() != RSX_FORMAT_CLASS_COLOR;
+		}
+
+		bool has_compatible_format(mock::image* tex) const
+		{
+			return tex->gcm_format == vram_texture->gcm_format;
+		}
+	};
+
+	class texture_cache : public rsx::texture_cache<mock::texture_cache, mock::texture_cache_traits>
+	{
+	private:
+		using baseclass = rsx::texture_cache<mock::texture_cache, mock::texture_cache_traits>;
+		friend baseclass;
+
+		struct temporary_image_t : public mock::image, public rsx::ref_counted
+		{
+			using mock::image::image;
+		};
+
+		std::vector<std::unique_ptr<temporary_image_t>> m_temporary_surfaces;
+
+		const u32 max_cached_image_pool_size = 256;
+
+	private:
+		void clear()
+		{
+			baseclass::clear();
+			m_temporary_surfaces.clear();
+		}
+
+		mock::image_view* create_temporary_subresource_impl(mock::command_list& cmd, mock::image* src, u32 gcm_format, rsx::texture_dimension_extended type,
+			u16 x, u16 y, u16 width, u16 height, u16 depth, u16 mipmaps, const rsx::texture_channel_remap_t& remap, bool copy)
+		{
+			if (gcm_format == RSX_GCM_FORMAT_IGNORED)
+			{
+				gcm_format = ensure(src)->gcm_format;
+			}
+
+			const u16 layers = type == rsx::texture_dimension_extended::texture_dimension_cubemap ? 6 : depth;
+			auto& dst = m_temporary_surfaces.emplace_back(std::make_unique<temporary_image_t>(gcm_format, width, height, layers, mipmaps, type));
+			dst->add_ref();
+
+			if (copy && src)
+			{
+				cmd.copies++;
+				dst->copy_from(*src, 0, x, y, width, height, 0, 0, 0, width, height);
+			}
+
+			return dst->get_view(remap);
+		}
+
+		void copy_transfer_regions_impl(mock::command_list& cmd, mock::image* dst, const std::vector<copy_region_descriptor>& sources) const
+		{
+			for (const auto& region : sources)
+			{
+				if (!region.src)
+				{
+					continue;
+				}
+
+				cmd.copies++;
+				dst->copy_from(*region.src, 0, region.src_x, region.src_y, region.src_w, region.src_h, region.dst_z, region.dst_x, region.dst_y, region.dst_w, region.dst_h);
+			}
+		}
+
+		mock::image* get_template_from_collection_impl(const std::vector<copy_region_descriptor>& sections_to_transfer) const
+		{
+			for (const auto& section : sections_to_transfer)
+			{
+				if (section.src)
+				{
+					return section.src;
+				}
+			}
+
+			return nullptr;
+		}
+
+	protected:
+		mock::image_view* create_temporary_subresource_view(mock::command_list& cmd, mock::image** src, u32 gcm_format, u16 x, u16 y, u16 w, u16 h,
+			const rsx::texture_channel_remap_t& remap_vector) override
+		{
+			return create_temporary_subresource_impl(cmd, *src, gcm_format, rsx::texture_dimension_extended::texture_dimension_2d, x, y, w, h, 1, 1, remap_vector, true);
+		}
+
+		mock::image_view* create_temporary_subresource_view(mock::command_list& cmd, mock::image* src, u32 gcm_format, u16 x, u16 y, u16 w, u16 h,
+			const rsx::texture_channel_remap_t& remap_vector) override
+		{
+			return create_temporary_subresource_impl(cmd, src, gcm_format, rsx::texture_dimension_extended::texture_dimension_2d, x, y, w, h, 1, 1, remap_vector, true);
+		}
+
+		mock::image_view* generate_cubemap_from_images(mock::command_list& cmd, u32 gcm_format, u16 size, const std::vector<copy_region_descriptor>& sources, const rsx::texture_channel_remap_t& remap_vector) override
+		{
+			auto result = create_temporary_subresource_impl(cmd, get_template_from_collection_impl(sources), gcm_format, rsx::texture_dimension_extended::texture_dimension_cubemap, 0, 0, size, size, 1, 1, remap_vector, false);
+
+			copy_transfer_regions_impl(cmd, result->image(), sources);
+			return result;
+		}
+
+		mock::image_view* generate_3d_from_2d_images(mock::command_list& cmd, u32 gcm_format, u16 width, u16 height, u16 depth, const std::vector<copy_region_descriptor>& sources, const rsx::texture_channel_remap_t& remap_vector) override
+		{
+			auto result = create_temporary_subresource_impl(cmd, get_template_from_collection_impl(sources), gcm_format, rsx::texture_dimension_extended::texture_dimension_3d, 0, 0, width, height, depth, 1, remap_vector, false);
+
+			copy_transfer_regions_impl(cmd, result->image(), sources);
+			return result;
+		}
+
+		mock::image_view* generate_atlas_from_images(mock::command_list& cmd, u32 gcm_format, u16 width, u16 height, const std::vector<copy_region_descriptor>& sections_to_copy,
+			const rsx::texture_channel_remap_t& remap_vector) override
+		{
+			auto result = create_temporary_subresource_impl(cmd, get_template_from_collection_impl(sections_to_copy), gcm_format, rsx::texture_dimension_extended::texture_dimension_2d, 0, 0, width, height, 1, 1, remap_vector, false);
+
+			copy_transfer_regions_impl(cmd, result->image(), sections_to_copy);
+			return result;
+		}
+
+		mock::image_view* generate_2d_mipmaps_from_images(mock::command_list& cmd, u32 gcm_format, u16 width, u16 height, const std::vector<copy_region_descriptor>& sections_to_copy,
+			const rsx::texture_channel_remap_t& remap_vector) override
+		{
+			const auto mipmaps = ::narrow<u16>(sections_to_copy.size());
+			auto result = create_temporary_subresource_impl(cmd, get_template_from_collection_impl(sections_to_copy), gcm_format, rsx::texture_dimension_extended::texture_dimension_2d, 0, 0, width, height, 1, mipmaps, remap_vector, false);
+
+			// Only the base level is stored
+			for (const auto& region : sections_to_copy)
+			{
+				if (region.src && region.level == 0)
+				{
+					cmd.copies++;
+					result->image()->copy_from(*region.src, 0, region.src_x, region.src_y, region.src_w, region.src_h, 0, region.dst_x, region.dst_y, region.dst_w, region.dst_h);
+				}
+			}
+
+			return result;
+		}
+
+		void release_temporary_subresource(mock::image_view* view) override
+		{
+			for (auto& e : m_temporary_surfaces)
+			{
+				if (e.get() == view->image())
+				{
+					e->release();
+					return;
+				}
+			}
+		}
+
+		void update_image_contents(mock::command_list& cmd, mock::image_view* dst, mock::image* src, u16 width, u16 height) override
+		{
+			cmd.copies++;
+			dst->image()->copy_from(*src, 0, 0, 0, width, height, 0, 0, 0, width, height);
+		}
+
+		cached_texture_section* create_new_texture(mock::command_list& /*cmd*/, const utils::address_range& rsx_range, u16 width, u16 height, u16 depth, u16 mipmaps, u32 pitch,
+			u32 gcm_format, rsx::texture_upload_context context, rsx::texture_dimension_extended type, bool swizzled, rsx::component_order swizzle_flags, rsx::flags32_t /*flags*/) override
+		{
+			const rsx::image_section_attributes_t search_desc = { .gcm_format = gcm_format, .width = width, .height = height, .depth = depth, .mipmaps = mipmaps };
+			const bool allow_dirty = (context != rsx::texture_upload_context::framebuffer_storage);
+			auto& cached = *find_cached_texture(rsx_range, search_desc, true, true, allow_dirty);
+			ensure(!cached.is_locked());
+
+			mock::image* image = nullptr;
+
+			if (cached.exists())
+			{
+				// Try and reuse this image data
+				image = cached.get_raw_texture();
+
+				if (!image || cached.get_image_type() != type)
+				{
+					// Type mismatch, discard
+					cached.destroy();
+					image = nullptr;
+				}
+				else
+				{
+					ensure(cached.is_managed());
+
+					cached.set_dimensions(width, height, depth, pitch);
+
+					// Clear the image before use if it is not going to be uploaded wholly from CPU
+					if (context != rsx::texture_upload_context::shader_read)
+					{
+						std::fill(image->data.begin(), image->data.end(), u8{0});
+					}
+				}
+			}
+
+			if (!image)
+			{
+				ensure(!cached.exists());
+
+				const u16 layers = type == rsx::texture_dimension_extended::texture_dimension_cubemap ? 6 : depth;
+				image = new mock::image(gcm_format, width, height, layers, mipmaps, type);
+
+				// Prepare section
+				cached.reset(rsx_range);
+				cached.set_image_type(type);
+				cached.set_gcm_format(gcm_format);
+				cached.create(width, height, depth, mipmaps, image, pitch, true);
+			}
+
+			cached.set_view_flags(swizzle_flags);
+			cached.set_context(context);
+			cached.set_swizzled(swizzled);
+			cached.set_dirty(false);
+
+			if (context != rsx::texture_upload_context::blit_engine_dst)
+			{
+				AUDIT(cached.get_memory_read_flags() != rsx::memory_read_flags::flush_always);
+				read_only_range = cached.get_min_max(read_only_range, rsx::section_bounds::locked_range);
+				cached.protect(utils::protection::ro);
+			}
+			else
+			{
+				//NOTE: Protection is handled by the caller
+				cached.set_dimensions(width, height, depth, (rsx_range.length() / height));
+				no_access_range = cached.get_min_max(no_access_range, rsx::section_bounds::locked_range);
+			}
+
+			update_cache_tag();
+			return &cached;
+		}
+
+		cached_texture_section* create_nul_section(
+			mock::command_list& /*cmd*/,
+			const utils::address_range& rsx_range,
+			const rsx::image_section_attributes_t& attrs,
+			const rsx::GCM_tile_reference& /*tile*/,
+			bool /*memory_load*/) override
+		{
+			auto& cached = *find_cached_texture(rsx_range, { .gcm_format = RSX_GCM_FORMAT_IGNORED }, true, false, false);
+			ensure(!cached.is_locked());
+
+			// Prepare section
+			cached.reset(rsx_range);
+			cached.create_dma_only(attrs.width, attrs.height, attrs.pitch);
+			cached.set_dirty(false);
+
+			no_access_range = cached.get_min_max(no_access_range, rsx::section_bounds::locked_range);
+			update_cache_tag();
+			return &cached;
+		}
+
+		cached_texture_section* upload_image_from_cpu(mock::command_list& cmd, const utils::address_range& rsx_range, u16 width, u16 height, u16 depth, u16 mipmaps, u32 pitch, u32 gcm_format,
+			rsx::texture_upload_context context, const std::vector<rsx::subresource_layout>& subresource_layout, rsx::texture_dimension_extended type, bool input_swizzled) override
+		{
+			auto section = create_new_texture(cmd, rsx_range, width, height, depth, mipmaps, pitch, gcm_format, context, type, input_swizzled,
+				rsx::component_order::default_, 0);
+
+			auto image = section->get_raw_texture();
+			cmd.uploads++;
+
+			// Raw copy of the base level of each layer, rows are repacked to the image pitch
+			for (const auto& layout : subresource_layout)
+			{
+				if (layout.level != 0)
+				{
+					continue;
+				}
+
+				const u32 src_pitch = layout.pitch_in_block * image->bpp();
+				const u32 row_length = std::min(src_pitch, image->pitch());
+				const u32 rows = std::min<u32>(layout.height_in_block, image->rows());
+				const u8* src = layout.data.data();
+
+				for (u32 slice = 0; slice < layout.depth; slice++)
+				{
+					const u32 dst_slice = layout.layer + slice;
+
+					if (dst_slice >= image->depth())
+					{
+						break;
+					}
+
+					for (u32 row = 0; row < rows; row++)
+					{
+						const usz src_offset = (usz{slice} * layout.height_in_block + row) * src_pitch;
+
+						if (src_offset + row_length > layout.data.size())
+						{
+							break;
+						}
+
+						std::memcpy(image->slice(dst_slice) + row * image->pitch(), src + src_offset, row_length);
+					}
+				}
+			}
+
+			section->last_write_tag = rsx::get_shared_tag();
+			return section;
+		}
+
+		void set_component_order(cached_texture_section& section, u32 /*gcm_format*/, rsx::component_order flags) override
+		{
+			section.set_view_flags(flags);
+		}
+
+		void insert_texture_barrier(mock::command_list& cmd, mock::image*, bool) override
+		{
+			cmd.barriers++;
+		}
+
+		bool render_target_format_is_compatible(mock::image* tex, u32 gcm_format) override
+		{
+			return tex->gcm_format == gcm_format;
+		}
+
+		void prepare_for_dma_transfers(mock::command_list&) override
+		{}
+
+		void cleanup_after_dma_transfers(mock::command_list&) override
+		{}
+
+	public:
+
+		using baseclass::texture_cache;
+
+		void destroy() override
+		{
+			clear();
+		}
+
+		bool is_depth_texture(u32 rsx_address, u32 rsx_size) override
+		{
+			reader_lock lock(m_cache_mutex);
+
+			auto &block = m_storage.block_for(rsx_address);
+
+			if (block.get_locked_count() == 0)
+				return false;
+
+			for (auto& tex : block)
+			{
+				if (tex.is_dirty())
+					continue;
+
+				if (!tex.overlaps(rsx_address, rsx::section_bounds::full_range))
+					continue;
+
+				if ((rsx_address + rsx_size - tex.get_section_base()) <= tex.get_section_size())
+					return tex.is_depth_texture();
+			}
+
+			return false;
+		}
+
+		void on_frame_end() override
+		{
+			trim_sections();
+
+			if (m_storage.m_unreleased_texture_objects >= m_max_zombie_objects)
+			{
+				purge_unreleased_sections();
+			}
+
+			if (m_temporary_surfaces.size() > max_cached_image_pool_size)
+			{
+				std::erase_if(m_temporary_surfaces, [](const auto& e) { return !e->has_refs(); });
+			}
+
+			baseclass::on_frame_end();
+		}
+
+		// Eviction entry point used by the backends on allocation failures
+		bool on_memory_pressure(rsx::problem_severity severity)
+		{
+			std::lock_guard lock(m_cache_mutex);
+			return handle_memory_pressure(severity);
+		}
+
+		// Number of live (locked and not dirty) sections
+		u32 get_locked_sections_count()
+		{
+			reader_lock lock(m_cache_mutex);
+
+			u32 count = 0;
+
+			for (auto& block : m_storage)
+			{
+				count += block.get_locked_count();
+			}
+
+			return count;
+		}
+
+		cached_texture_section* find_section(const utils::address_range& range)
+		{
+			reader_lock lock(m_cache_mutex);
+
+			for (auto* section : find_texture_from_range(range))
+			{
+				if (section->get_section_range() == range && !section->is_dirty())
+				{
+					return section;
+				}
+			}
+
+			return nullptr;
+		}
+	};
+
+	// Render target cache stand-in with no bound surfaces: framebuffer memory is only known to the texture cache through lock_memory_region
+	struct surface_store
+	{
+		using surface_type = mock::render_target*;
+		using surface_overlap_info = rsx::surface_overlap_info_t<surface_type>;
+
+		u64 write_tag = 1ull;
+
+		bool address_is_bound(u32 /*address*/) const
+		{
+			return false;
+		}
+
+		surface_type get_surface_at(u32 /*address*/)
+		{
+			return nullptr;
+		}
+
+		std::vector<surface_overlap_info> get_merged_texture_memory_region(mock::command_list&, u32, u32, u32, u32, u8, rsx::surface_access)
+		{
+			return {};
+		}
+
+		void check_for_duplicates(std::vector<surface_overlap_info>&)
+		{
+		}
+	};
+
+	// Placeholder renderer, only queried for the local memory size and the ROP timestamp
+	class renderer final : public rsx::thread
+	{
+	public:
+		renderer(u32 local_size)
+		{
+			local_mem_size = local_size;
+		}
+
+		u64 get_cycles() override
+		{
+			return 0;
+		}
+
+		f64 get_display_refresh_rate() const override
+		{
+			return 60.;
+		}
+
+		void on_init_thread() override
+		{
+		}
+
+		void flip(const display_flip_info_t& /*info*/) override
+		{
+		}
+	};
+
+	// Process-wide state: guest memory with RSX local memory mapped and the placeholder renderer
+	struct environment
+	{
+		static constexpr u32 local_size = 0x10000000;
+
+		environment()
+		{
+			Emu.SetTestMode();
+
+			// Section protection is applied immediately, framebuffer memory is always written back
+			g_cfg.video.renderer.set(video_renderer::null);
+			g_cfg.video.disable_async_host_memory_manager.set(true);
+			g_cfg.video.write_color_buffers.set(true);
+
+			if (!vm::get(vm::main))
+			{
+				vm::init();
+			}
+
+			ensure(vm::falloc(rsx::constants::local_mem_base, local_size, vm::video));
+
+			if (!g_fxo->is_init())
+			{
+				g_fxo->reset();
+			}
+
+			ensure(g_fxo->init<rsx::thread, renderer>(local_size));
+		}
+
+		static environment& get()
+		{
+			static environment s_env;
+			return s_env;
+		}
+
+		// Guest memory access bypassing the page protection set by the texture cache
+		static u8* local_ptr(u32 offset)
+		{
+			return vm::get_super_ptr<u8>(rsx::constants::local_mem_base + offset);
+		}
+	};
+
+	enum class op_type : u8
+	{
+		upload,     // upload <offset> <width> <height> <pitch> <gcm format> [mipmaps]: sample a 2D texture (pitch 0 = swizzled)
+		write,      // write <offset> <size>: CPU write, faulting sections are invalidated before the memory changes
+		invalidate, // invalidate <offset> <size> [read|write|deferred_read|deferred_write|unmap]
+		lock,       // lock <offset> <width> <height> <pitch> <gcm format>: render target drawn to and locked as framebuffer memory
+		flush,      // flush: flush_all on every pending deferred invalidation
+		frame,      // frame: end of frame
+	};
+
+	struct op
+	{
+		op_type type{};
+		u32 offset = 0; // Offset in local memory
+		u32 size = 0;
+		u16 width = 0;
+		u16 height = 0;
+		u32 pitch = 0;
+		u32 format = 0;
+		u16 mipmaps = 1;
+		rsx::invalidation_cause cause = rsx::invalidation_cause::write;
+	};
+
+	// Parses a trace, one operation per line ('#' starts a comment). Throws on malformed lines.
+	static inline std::vector<op> parse_trace(std::string_view text)
+	{
+		std::vector<op> result;
+
+		for (usz line_no = 1; !text.empty(); line_no++)
+		{
+			const usz eol = std::min(text.find('\n'), text.size());
+			std::string_view line = text.substr(0, eol);
+			text.remove_prefix(std::min(eol + 1, text.size()));
+
+			if (const usz comment = line.find('#'); comment != umax)
+			{
+				line = line.substr(0, comment);
+			}
+
+			std::vector<std::string> args;
+
+			for (const auto& arg : fmt::split(line, {" ", "\t", "\r"}))
+			{
+				args.push_back(arg);
+			}
+
+			if (args.empty())
+			{
+				continue;
+			}
+
+			auto number = [&](usz index, u32 def = umax) -> u32
+			{
+				if (index >= args.size())
+				{
+					if (def != umax)
+					{
+						return def;
+					}
+
+					fmt::throw_exception("Trace line %u: missing argument %u", line_no, index);
+				}
+
+				return ::narrow<u32>(std::stoull(args[index], nullptr, 0));
+			};
+
+			op& o = result.emplace_back();
+			const std::string& name = args[0];
+
+			if (name == "upload" || name == "lock")
+			{
+				o.type = name == "upload" ? op_type::upload : op_type::lock;
+				o.offset = number(1);
+				o.width = ::narrow<u16>(number(2));
+				o.height = ::narrow<u16>(number(3));
+				o.pitch = number(4);
+				o.format = number(5);
+				o.mipmaps = ::narrow<u16>(number(6, 1));
+			}
+			else if (name == "write" || name == "invalidate")
+			{
+				o.type = name == "write" ? op_type::write : op_type::invalidate;
+				o.offset = number(1);
+				o.size = number(2);
+
+				const std::string cause = args.size() > 3 ? args[3] : "write";
+
+				if (cause == "read") o.cause = rsx::invalidation_cause::read;
+				else if (cause == "write") o.cause = rsx::invalidation_cause::write;
+				else if (cause == "deferred_read") o.cause = rsx::invalidation_cause::deferred_read;
+				else if (cause == "deferred_write") o.cause = rsx::invalidation_cause::deferred_write;
+				else if (cause == "unmap") o.cause = rsx::invalidation_cause::unmap;
+				else fmt::throw_exception("Trace line %u: unknown invalidation cause '%s'", line_no, cause);
+			}
+			else if (name == "flush")
+			{
+				o.type = op_type::flush;
+			}
+			else if (name == "frame")
+			{
+				o.type = op_type::frame;
+			}
+			else
+			{
+				fmt::throw_exception("Trace line %u: unknown operation '%s'", line_no, name);
+			}
+		}
+
+		return result;
+	}
+
+	struct replay_stats
+	{
+		u64 uploads = 0;
+		u64 upload_misses = 0;
+		u64 dedup_hits = 0;     // Misses answered by an image with the same content hash
+		u64 invalidations = 0;
+		u64 violations = 0;     // Invalidations that hit cached sections
+		u64 flushed_sections = 0;
+		u64 locks = 0;
+		u64 frames = 0;
+	};
+
+	class harness
+	{
+		std::vector<std::unique_ptr<render_target>> m_render_targets; // Must outlive the cache sections referencing them
+		std::deque<texture_cache::thrashed_set> m_pending_flushes;
+		std::array<u32, 0x10000 / 4> m_registers{};
+
+	public:
+		texture_cache cache;
+		surface_store rtts;
+		command_list cmd;
+		replay_stats stats;
+
+		harness()
+		{
+			environment::get();
+		}
+
+		~harness()
+		{
+			m_pending_flushes.clear();
+			cache.destroy();
+		}
+
+		texture_cache::sampled_image_descriptor upload(u32 offset, u16 width, u16 height, u32 pitch, u32 format, u16 mipmaps = 1)
+		{
+			// Texture unit 0 state, as set by NV4097_SET_TEXTURE_* methods
+			const u32 gcm_format = format | (pitch ? CELL_GCM_TEXTURE_LN : 0);
+			const u32 dimension = 2;
+			const u32 location = CELL_GCM_LOCATION_LOCAL + 1;
+			const u32 no_border = 1;
+
+			m_registers[NV4097_SET_TEXTURE_OFFSET] = offset;
+			m_registers[NV4097_SET_TEXTURE_FORMAT] = location | (no_border << 3) | (dimension << 4) | (gcm_format << 8) | (u32{mipmaps} << 16);
+			m_registers[NV4097_SET_TEXTURE_ADDRESS] = 1 | (1 << 8) | (1 << 16); // Wrap
+			m_registers[NV4097_SET_TEXTURE_CONTROL1] = RSX_TEXTURE_REMAP_IDENTITY;
+			m_registers[NV4097_SET_TEXTURE_IMAGE_RECT] = (u32{width} << 16) | height;
+			m_registers[NV4097_SET_TEXTURE_CONTROL3] = pitch | (1 << 20);
+
+			const u32 misses = cache.get_texture_upload_misses_this_frame();
+			const u32 dedup_hits = cache.get_texture_upload_dedup_hits_this_frame();
+			auto result = cache.upload_texture(cmd, rsx::fragment_texture(0, m_registers), rtts);
+
+			stats.uploads++;
+			stats.upload_misses += cache.get_texture_upload_misses_this_frame() - misses;
+			stats.dedup_hits += cache.get_texture_upload_dedup_hits_this_frame() - dedup_hits;
+			return result;
+		}
+
+		texture_cache::thrashed_set invalidate(u32 offset, u32 size, rsx::invalidation_cause cause)
+		{
+			const auto range = utils::address_range::start_length(rsx::constants::local_mem_base + offset, size);
+			auto result = cache.invalidate_range(cmd, range, cause);
+
+			stats.invalidations++;
+			stats.violations += result.violation_handled;
+
+			if (cause.deferred_flush() && !result.sections_to_flush.empty())
+			{
+				m_pending_flushes.push_back(result);
+			}
+
+			return result;
+		}
+
+		// CPU write of a byte pattern
+		void write(u32 offset, u32 size, u8 value)
+		{
+			invalidate(offset, size, rsx::invalidation_cause::write);
+			std::memset(environment::local_ptr(offset), value, size);
+		}
+
+		// Render target drawn with a byte pattern and locked as framebuffer memory
+		render_target& lock(u32 offset, u16 width, u16 height, u32 pitch, u32 format, u8 value = 0xcd)
+		{
+			const auto range = utils::address_range::start_length(rsx::constants::local_mem_base + offset, pitch * height);
+
+			render_target* rtt = nullptr;
+
+			for (const auto& e : m_render_targets)
+			{
+				if (e->base_addr == range.start && e->width() == width && e->height() == height && e->rsx_pitch == pitch && e->gcm_format == format)
+				{
+					rtt = e.get();
+					break;
+				}
+			}
+
+			if (!rtt)
+			{
+				rtt = m_render_targets.emplace_back(std::make_unique<render_target>(format, width, height, pitch)).get();
+				rtt->base_addr = range.start;
+				rtt->memory_range = range;
+			}
+
+			std::fill(rtt->data.begin(), rtt->data.end(), value);
+
+			cache.lock_memory_region(cmd, rtt, range, true, width, height, pitch);
+
+			// Draw after locking
+			rtt->last_use_tag = rsx::get_shared_tag();
+
+			stats.locks++;
+			return *rtt;
+		}
+
+		void flush()
+		{
+			while (!m_pending_flushes.empty())
+			{
+				auto& data = m_pending_flushes.front();
+
+				stats.flushed_sections += data.sections_to_flush.size();
+				cache.flush_all(cmd, data);
+				m_pending_flushes.pop_front();
+			}
+		}
+
+		void end_frame()
+		{
+			flush();
+			cache.on_frame_end();
+			stats.frames++;
+		}
+
+		void replay(const std::vector<op>& ops)
+		{
+			for (const op& o : ops)
+			{
+				switch (o.type)
+				{
+				case op_type::upload: upload(o.offset, o.width, o.height, o.pitch, o.format, o.mipmaps); break;
+				case op_type::write: write(o.offset, o.size, static_cast<u8>(stats.invalidations)); break;
+				case op_type::invalidate: invalidate(o.offset, o.size, o.cause); break;
+				case op_type::lock: lock(o.offset, o.width, o.height, o.pitch, o.format); break;
+				case op_type::flush: flush(); break;
+				case op_type::frame: end_frame(); break;
+				}
+			}
+		}
+	};
+}
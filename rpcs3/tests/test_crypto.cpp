@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include "Crypto/aes.h"
+#include "Crypto/sha1.h"
+#include "Crypto/utils.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace crypto
+{
+	static std::vector<u8> from_hex(std::string_view hex)
+	{
+		std::vector<u8> result(hex.size() / 2);
+		hex_to_bytes(result.data(), hex.data(), static_cast<unsigned int>(hex.size()));
+		return result;
+	}
+
+	static std::vector<u8> random_bytes(usz size, u32 seed)
+	{
+		std::mt19937 rng(seed);
+		std::vector<u8> result(size);
+
+		for (u8& b : result)
+		{
+			b = static_cast<u8>(rng());
+		}
+
+		return result;
+	}
+
+	static std::vector<u8> sha1_of(const std::vector<u8>& data)
+	{
+		std::vector<u8> result(20);
+		sha1(data.data(), data.size(), result.data());
+		return result;
+	}
+
+	// NIST SP 800-38A test vectors
+	static const std::vector<u8> s_key = from_hex("2b7e151628aed2a6abf7158809cf4f3c");
+	static const std::vector<u8> s_plaintext = from_hex(
+		"6bc1bee22e409f96e93d7e117393172a"
+		"ae2d8a571e03ac9c9eb76fac45af8e51"
+		"30c81c46a35ce411e5fbc1191a0a52ef"
+		"f69f2445df4f9b17ad2b417be66c3710");
+
+	TEST(Crypto, SHA1KnownAnswers)
+	{
+		EXPECT_EQ(sha1_of({}), from_hex("da39a3ee5e6b4b0d3255bfef95601890afd80709"));
+		EXPECT_EQ(sha1_of({'a', 'b', 'c'}), from_hex("a9993e364706816aba3e25717850c26c9cd0d89d"));
+
+		const std::string_view two_blocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+		EXPECT_EQ(sha1_of({two_blocks.begin(), two_blocks.end()}), from_hex("84983e441c3bd26ebaae4aa1f95129e5e54670f1"));
+
+		EXPECT_EQ(sha1_of(std::vector<u8>(1000000, 'a')), from_hex("34aa973cd4c4daa4f61eeb2bdbad27316534016f"));
+	}
+
+	TEST(Crypto, SHA1MatchesPortableBlockFunction)
+	{
+		const auto data = random_bytes(0x10000 + 37, 1);
+		const usz whole_blocks = data.size() / 64 * 64;
+
+		// Reference: every block through the portable sha1_process
+		sha1_context ref;
+		sha1_starts(&ref);
+
+		for (usz i = 0; i < whole_blocks; i += 64)
+		{
+			sha1_process(&ref, data.data() + i);
+		}
+
+		sha1_context ctx;
+		sha1_starts(&ctx);
+		sha1_update(&ctx, data.data(), whole_blocks);
+		EXPECT_EQ(std::memcmp(ctx.state, ref.state, sizeof(ref.state)), 0);
+
+		// Odd sized updates mix buffered blocks with bulk runs
+		u8 chunked[20], whole[20];
+		sha1_starts(&ctx);
+
+		for (usz pos = 0, step = 1; pos < data.size(); pos += step, step = step * 3 % 1000 + 1)
+		{
+			sha1_update(&ctx, data.data() + pos, std::min(step, data.size() - pos));
+		}
+
+		sha1_finish(&ctx, chunked);
+		sha1(data.data(), data.size(), whole);
+		EXPECT_EQ(std::memcmp(chunked, whole, 20), 0);
+	}
+
+	TEST(Crypto, AESCBCKnownAnswers)
+	{
+		const auto expected = from_hex(
+			"7649abac8119b246cee98e9b12e9197d"
+			"5086cb9b507219ee95db113a917678b2"
+			"73bed6b8e3c1743b7116e69e22229516"
+			"3ff1caa1681fac09120eca307586e1a7");
+
+		auto iv = from_hex("000102030405060708090a0b0c0d0e0f");
+		std::vector<u8> out(s_plaintext.size());
+
+		aes_context ctx;
+		aes_setkey_enc(&ctx, s_key.data(), 128);
+		aes_crypt_cbc(&ctx, AES_ENCRYPT, out.size(), iv.data(), s_plaintext.data(), out.data());
+		EXPECT_EQ(out, expected);
+
+		// In place
+		iv = from_hex("000102030405060708090a0b0c0d0e0f");
+		aes_setkey_dec(&ctx, s_key.data(), 128);
+		aes_crypt_cbc(&ctx, AES_DECRYPT, out.size(), iv.data(), out.data(), out.data());
+		EXPECT_EQ(out, s_plaintext);
+		EXPECT_EQ(iv, from_hex("3ff1caa1681fac09120eca307586e1a7"));
+	}
+
+	TEST(Crypto, AESCBCDecryptMatchesBlockwise)
+	{
+		const auto key = random_bytes(16, 2);
+		const auto iv = random_bytes(16, 3);
+
+		// Lengths around the 8 block batches
+		for (usz blocks : {1, 7, 8, 9, 16, 17, 100})
+		{
+			const auto cipher = random_bytes(blocks * 16, static_cast<u32>(blocks));
+
+			aes_context ctx;
+			aes_setkey_dec(&ctx, key.data(), 128);
+
+			// Reference: one block at a time, as the code did before
+			std::vector<u8> expected(cipher.size());
+			std::vector<u8> chain = iv;
+
+			for (usz i = 0; i < cipher.size(); i += 16)
+			{
+				aes_crypt_ecb(&ctx, AES_DECRYPT, cipher.data() + i, expected.data() + i);
+
+				for (usz j = 0; j < 16; j++)
+				{
+					expected[i + j] ^= chain[j];
+				}
+
+				std::memcpy(chain.data(), cipher.data() + i, 16);
+			}
+
+			std::vector<u8> out = cipher;
+			std::vector<u8> iv_out = iv;
+			aes_crypt_cbc(&ctx, AES_DECRYPT, out.size(), iv_out.data(), out.data(), out.data());
+
+			EXPECT_EQ(out, expected) << blocks << " blocks";
+			EXPECT_EQ(iv_out, chain) << blocks << " blocks";
+		}
+	}
+
+	TEST(Crypto, AESCTRKnownAnswers)
+	{
+		const auto expected = from_hex(
+			"874d6191b620e3261bef6864990db6ce"
+			"9806f66b7970fdff8617187bb9fffdff"
+			"5ae4df3edbd5d35e5b4f09020db03eab"
+			"1e031dda2fbe03d1792170a0f3009cee");
+
+		auto counter = from_hex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff");
+		u8 stream_block[16]{};
+		usz offset = 0;
+		std::vector<u8> out(s_plaintext.size());
+
+		aes_context ctx;
+		aes_setkey_enc(&ctx, s_key.data(), 128);
+		aes_crypt_ctr(&ctx, out.size(), &offset, counter.data(), stream_block, s_plaintext.data(), out.data());
+
+		EXPECT_EQ(out, expected);
+		EXPECT_EQ(offset, 0u);
+		EXPECT_EQ(counter, from_hex("f0f1f2f3f4f5f6f7f8f9fafbfcfdff03"));
+	}
+
+	TEST(Crypto, AESCTRMatchesBlockwise)
+	{
+		const auto key = random_bytes(16, 4);
+		const auto data = random_bytes(0x1000 + 5, 5);
+
+		aes_context ctx;
+		aes_setkey_enc(&ctx, key.data(), 128);
+
+		// Counter close to a carry into the upper half
+		const auto initial_counter = from_hex("0123456789abcdeffffffffffffffffa");
+
+		// Reference: one keystream block at a time
+		std::vector<u8> expected = data;
+		std::vector<u8> counter = initial_counter;
+
+		for (usz i = 0; i < data.size(); i += 16)
+		{
+			u8 stream[16];
+			aes_crypt_ecb(&ctx, AES_ENCRYPT, counter.data(), stream);
+
+			for (usz j = 0; j < 16 && i + j < data.size(); j++)
+			{
+				expected[i + j] ^= stream[j];
+			}
+
+			for (usz j = 16; j > 0 && ++counter[j - 1] == 0; j--)
+			{
+			}
+		}
+
+		// Resumed at unaligned offsets between calls
+		std::vector<u8> out = data;
+		counter = initial_counter;
+		u8 stream_block[16]{};
+		usz offset = 0;
+
+		for (usz pos = 0, step = 3; pos < data.size(); pos += step, step = step * 5 % 300 + 1)
+		{
+			const usz length = std::min(step, data.size() - pos);
+			aes_crypt_ctr(&ctx, length, &offset, counter.data(), stream_block, out.data() + pos, out.data() + pos);
+		}
+
+		EXPECT_EQ(out, expected);
+		EXPECT_EQ(offset, data.size() % 16);
+	}
+}
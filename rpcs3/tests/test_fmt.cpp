@@ -191,6 +191,43 @@ namespace fmt
 		EXPECT_EQ("drow drow drow"s, fmt::replace_all("word word word", "word", "drow", -1));
 	}
 
+	TEST(StrUtil, ReplaceAllList)
+	{
+		const std::pair<std::string_view, std::string> list[] =
+		{
+			{ "$$", "$" },
+			{ "$0", "a" },
+			{ "$01", "b" },
+			{ "a", "$0" },
+		};
+
+		EXPECT_EQ(""s, fmt::replace_all(""s, list));
+		EXPECT_EQ("x = 1;"s, fmt::replace_all("x = 1;"s, list));
+		EXPECT_EQ("x = a1;"s, fmt::replace_all("x = $01;"s, list)); // first listed pattern wins
+		EXPECT_EQ("$0"s, fmt::replace_all("$$0"s, list)); // replaced text is not rescanned
+		EXPECT_EQ("$0$0"s, fmt::replace_all("aa"s, list));
+		EXPECT_EQ("$"s, fmt::replace_all("$"s, list));
+
+		int calls = 0;
+		const std::pair<std::string_view, std::function<std::string()>> func_list[] =
+		{
+			{ "$i", [&]() { return std::to_string(calls++); } },
+		};
+
+		EXPECT_EQ("0 1 2"s, fmt::replace_all("$i $i $i"s, func_list)); // evaluated in order of appearance
+		EXPECT_EQ(3, calls);
+		EXPECT_EQ("$"s, fmt::replace_all("$"s, func_list));
+		EXPECT_EQ(3, calls);
+
+		const std::vector<std::pair<std::string, std::string>> vec_list =
+		{
+			{ "ab", "x" },
+			{ "b", "yy" },
+		};
+
+		EXPECT_EQ("xyyx"s, fmt::replace_all("abbab"s, vec_list));
+	}
+
 	TEST(StrUtil, Split)
 	{
 		using vec = std::vector<std::string>;
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "Emu/game_library_index.h"
+#include "Utilities/File.h"
+
+namespace utils
+{
+	// One title with PARAM.SFO and a content directory, removed again at the end of the test
+	struct game_library_fixture
+	{
+		std::string root = fs::get_temp_dir() + "rpcs3_test_games/";
+		std::string game = root + "BLUS00001";
+		std::string index_path = root + "index.dat";
+
+		game_library_fixture()
+		{
+			fs::remove_all(root, false, true);
+			fs::create_path(game + "/USRDIR");
+			write_sfo("Test Game", 1000);
+			fs::write_file(game + "/USRDIR/EBOOT.BIN", fs::rewrite, std::string(100, 'e'));
+		}
+
+		~game_library_fixture()
+		{
+			fs::remove_all(root);
+		}
+
+		// Explicit modification times, the file system may only have a resolution of seconds
+		void write_sfo(const std::string& title, s64 mtime) const
+		{
+			psf::registry sfo;
+			sfo.emplace("TITLE_ID", psf::string(10, "BLUS00001"));
+			sfo.emplace("TITLE", psf::string(128, title));
+			sfo.emplace("CATEGORY", psf::string(4, "HG"));
+			sfo.emplace("APP_VER", psf::string(8, "01.00"));
+			fs::write_file(game + "/PARAM.SFO", fs::rewrite, psf::save_object(sfo));
+			fs::utime(game + "/PARAM.SFO", mtime, mtime);
+		}
+
+		void save_index() const
+		{
+			game_library_index index(index_path);
+			ASSERT_NE(index.get(game, 1), nullptr);
+			ASSERT_NE(index.calc_size_on_disk(game), umax);
+			ASSERT_TRUE(index.save());
+		}
+	};
+
+	TEST(GameLibraryIndex, LoadsOnFirstUse)
+	{
+		game_library_fixture fixture;
+		fixture.save_index();
+
+		game_library_index index(fixture.index_path);
+		const auto entries = index.get_entries();
+		ASSERT_EQ(entries.size(), 1u);
+
+		// Unchanged, served from the index
+		const auto entry = index.get(fixture.game, 1);
+		EXPECT_EQ(entry, entries.at(fixture.game));
+		EXPECT_EQ(psf::get_string(entry->sfo, "TITLE"), "Test Game");
+		EXPECT_EQ(index.get_size_on_disk(fixture.game), 100u + fs::file(fixture.game + "/PARAM.SFO").size());
+		EXPECT_FALSE(index.is_dirty());
+	}
+
+	TEST(GameLibraryIndex, InvalidatedByModificationTime)
+	{
+		game_library_fixture fixture;
+		fixture.save_index();
+
+		fixture.write_sfo("Updated Game", 2000);
+		fs::write_file(fixture.game + "/USRDIR/DATA.BIN", fs::rewrite, std::string(50, 'd'));
+		fs::utime(fixture.game + "/USRDIR", 3000, 3000);
+
+		game_library_index index(fixture.index_path);
+		const auto old_entry = index.get_entries().at(fixture.game);
+
+		// Size of the game is unknown until calculated again
+		EXPECT_EQ(index.get_size_on_disk(fixture.game), umax);
+
+		const auto entry = index.get(fixture.game, 1);
+		EXPECT_NE(entry, old_entry);
+		EXPECT_EQ(psf::get_string(entry->sfo, "TITLE"), "Updated Game");
+		EXPECT_EQ(entry->sfo_mtime, 2000);
+		EXPECT_TRUE(index.is_dirty());
+	}
+
+	TEST(GameLibraryIndex, RejectsDamagedFile)
+	{
+		game_library_fixture fixture;
+		fixture.save_index();
+
+		const std::vector<u8> data = fs::file(fixture.index_path).to_vector<u8>();
+		ASSERT_GT(data.size(), 64u);
+
+		std::vector<u8> corrupt = data;
+		corrupt[data.size() / 2] ^= 0x5a;
+
+		const std::vector<std::vector<u8>> damaged
+		{
+			{data.begin(), data.begin() + data.size() / 2}, // Truncated
+			{data.begin(), data.begin() + 8}, // Truncated prefix
+			std::move(corrupt),
+			std::vector<u8>(data.size(), 0xff),
+		};
+
+		for (const std::vector<u8>& contents : damaged)
+		{
+			ASSERT_TRUE(fs::write_file(fixture.index_path, fs::rewrite, contents));
+
+			// Rebuilt from the game directory instead
+			game_library_index index(fixture.index_path);
+			EXPECT_TRUE(index.get_entries().empty());
+			EXPECT_EQ(index.get_size_on_disk(fixture.game), umax);
+			EXPECT_EQ(psf::get_string(index.get(fixture.game, 1)->sfo, "TITLE"), "Test Game");
+		}
+	}
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include "Emu/Memory/vm_reservation_stats.h"
+
+namespace vm
+{
+	static constexpr u32 s_ppu_id = 0x01000000;
+	static constexpr u32 s_spu_id = 0x02000003;
+
+	struct reservation_stats_guard
+	{
+		reservation_stats_guard(u32 interval)
+		{
+			reservation_stats_reset(interval);
+		}
+
+		~reservation_stats_guard()
+		{
+			reservation_stats_reset(0);
+		}
+	};
+
+	TEST(ReservationStats, DisabledByDefault)
+	{
+		reservation_stats_reset(0);
+
+		EXPECT_FALSE(reservation_stats_sample());
+
+		reservation_stats_record(reservation_sample{.addr = 0x10000, .cpu_id = s_ppu_id, .event = reservation_event::store_failure});
+		EXPECT_TRUE(reservation_stats_collect().empty());
+	}
+
+	TEST(ReservationStats, SamplingInterval)
+	{
+		reservation_stats_guard guard(4);
+
+		u32 sampled = 0;
+
+		for (u32 i = 0; i < 400; i++)
+		{
+			sampled += reservation_stats_sample();
+		}
+
+		EXPECT_EQ(sampled, 100u);
+	}
+
+	TEST(ReservationStats, AccumulatePerLine)
+	{
+		reservation_stats_guard guard(1);
+
+		// Same 128-byte line through different addresses
+		reservation_stats_record(reservation_sample{.addr = 0x20000, .pc = 0x100, .cpu_id = s_spu_id, .event = reservation_event::store_success});
+		reservation_stats_record(reservation_sample{.addr = 0x2007c, .pc = 0x200, .cpu_id = s_spu_id, .event = reservation_event::store_failure, .tx_aborts = 3, .tx_status = 1u << 2, .waiters = 2});
+		reservation_stats_record(reservation_sample{.addr = 0x20040, .pc = 0x300, .cpu_id = s_spu_id, .event = reservation_event::load, .retries = 5, .ticks = 1000});
+		reservation_stats_record(reservation_sample{.addr = 0x20000, .pc = 0x11e4, .cpu_id = s_spu_id, .event = reservation_event::lr_wait, .busy_wait = true, .ticks = 500});
+		reservation_stats_record(reservation_sample{.addr = 0x20000, .pc = 0x11e4, .cpu_id = s_spu_id, .event = reservation_event::lr_wait, .ticks = 700});
+
+		// Another line, accessed by PPU only
+		reservation_stats_record(reservation_sample{.addr = 0x20080, .pc = 0x10200, .cpu_id = s_ppu_id, .event = reservation_event::store_success, .waiters = 1});
+
+		const auto lines = reservation_stats_collect();
+		ASSERT_EQ(lines.size(), 2u);
+
+		const auto& hot = lines[0];
+		EXPECT_EQ(hot.addr, 0x20000u);
+		EXPECT_TRUE(hot.spu);
+		EXPECT_FALSE(hot.ppu);
+		EXPECT_EQ(hot.stores, 2u);
+		EXPECT_EQ(hot.store_failures, 1u);
+		EXPECT_EQ(hot.tx_aborts, 3u);
+		EXPECT_EQ(hot.tx_conflicts, 1u);
+		EXPECT_EQ(hot.tx_capacity, 0u);
+		EXPECT_EQ(hot.loads, 1u);
+		EXPECT_EQ(hot.load_retries, 5u);
+		EXPECT_EQ(hot.load_ticks, 1000u);
+		EXPECT_EQ(hot.lr_busy_waits, 1u);
+		EXPECT_EQ(hot.lr_busy_wait_ticks, 500u);
+		EXPECT_EQ(hot.lr_waits, 1u);
+		EXPECT_EQ(hot.lr_wait_ticks, 700u);
+		EXPECT_EQ(hot.max_waiters, 2u);
+
+		// The PC of the failing store is kept
+		EXPECT_EQ(hot.pc, 0x200u);
+		EXPECT_EQ(hot.cpu_id, s_spu_id);
+
+		const auto& cold = lines[1];
+		EXPECT_EQ(cold.addr, 0x20080u);
+		EXPECT_TRUE(cold.ppu);
+		EXPECT_FALSE(cold.spu);
+		EXPECT_EQ(cold.stores, 1u);
+		EXPECT_EQ(cold.store_failures, 0u);
+		EXPECT_EQ(cold.pc, 0x10200u);
+	}
+
+	TEST(ReservationStats, SortedByContention)
+	{
+		reservation_stats_guard guard(1);
+
+		for (u32 i = 0; i < 8; i++)
+		{
+			const u32 addr = 0x30000 + i * 128;
+
+			for (u32 j = 0; j <= i; j++)
+			{
+				reservation_stats_record(reservation_sample{.addr = addr, .cpu_id = s_ppu_id, .event = reservation_event::store_failure});
+			}
+		}
+
+		const auto lines = reservation_stats_collect();
+		ASSERT_EQ(lines.size(), 8u);
+
+		for (u32 i = 0; i < 8; i++)
+		{
+			EXPECT_EQ(lines[i].addr, 0x30000 + (7 - i) * 128);
+			EXPECT_EQ(lines[i].store_failures, 8u - i);
+		}
+
+		const std::string table = reservation_stats_table(lines, 3);
+		EXPECT_NE(table.find("Top 3 of 8"), umax);
+		EXPECT_NE(table.find("0x00030380"), umax);
+		EXPECT_EQ(table.find("0x00030000"), umax);
+
+		// CSV is sorted by address, one row per line plus the header
+		const std::string csv = reservation_stats_csv(lines);
+		EXPECT_EQ(std::count(csv.begin(), csv.end(), '\n'), 9);
+		EXPECT_LT(csv.find("0x00030000"), csv.find("0x00030380"));
+	}
+}
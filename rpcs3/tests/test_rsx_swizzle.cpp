@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+
+#include "Emu/RSX/rsx_utils.h"
+
+#include <array>
+#include <random>
+#include <vector>
+
+namespace rsx
+{
+	// Previous per-texel implementation, the kernels must produce identical results
+	template <typename T, bool input_is_swizzled>
+	static void reference_linear_swizzle(const void* input_pixels, void* output_pixels, u16 width, u16 height, u32 pitch)
+	{
+		const u32 log2width = ceil_log2(width);
+		const u32 log2height = ceil_log2(height);
+
+		u32 x_mask = 0x55555555;
+		u32 y_mask = 0xAAAAAAAA;
+
+		u32 limit_mask = (log2width < log2height) ? log2width : log2height;
+		limit_mask = 1 << (limit_mask << 1);
+
+		x_mask = (x_mask | ~(limit_mask - 1));
+		y_mask = (y_mask & (limit_mask - 1));
+
+		u32 offs_y = 0;
+		u32 offs_x = 0;
+		u32 offs_x0 = 0;
+		const u32 y_incr = limit_mask;
+
+		const u32 pitch_in_blocks = pitch / sizeof(T);
+		u32 row_offset = 0;
+
+		for (int y = 0; y < height; ++y, row_offset += pitch_in_blocks)
+		{
+			offs_x = offs_x0;
+
+			for (int x = 0; x < width; ++x)
+			{
+				if constexpr (input_is_swizzled)
+				{
+					static_cast<T*>(output_pixels)[row_offset + x] = static_cast<const T*>(input_pixels)[offs_y + offs_x];
+				}
+				else
+				{
+					static_cast<T*>(output_pixels)[offs_y + offs_x] = static_cast<const T*>(input_pixels)[row_offset + x];
+				}
+
+				offs_x = (offs_x - x_mask) & x_mask;
+			}
+
+			offs_y = (offs_y - y_mask) & y_mask;
+
+			if (offs_y == 0)
+			{
+				offs_x0 += y_incr;
+			}
+		}
+	}
+
+	template <typename T>
+	static void reference_linear_swizzle_3d(const void* input_pixels, void* output_pixels, u16 width, u16 height, u16 depth)
+	{
+		if (depth == 1)
+		{
+			reference_linear_swizzle<T, true>(input_pixels, output_pixels, width, height, width * sizeof(T));
+			return;
+		}
+
+		auto src = static_cast<const T*>(input_pixels);
+		auto dst = static_cast<T*>(output_pixels);
+
+		const u32 log2_w = ceil_log2(width);
+		const u32 log2_h = ceil_log2(height);
+		const u32 log2_d = ceil_log2(depth);
+
+		for (u32 z = 0; z < depth; ++z)
+		{
+			for (u32 y = 0; y < height; ++y)
+			{
+				for (u32 x = 0; x < width; ++x)
+				{
+					*dst++ = src[calculate_z_index(x, y, z, log2_w, log2_h, log2_d)];
+				}
+			}
+		}
+	}
+
+	static std::vector<u8> make_random_bytes(usz size)
+	{
+		std::mt19937 rng(static_cast<u32>(size));
+		std::vector<u8> data(size);
+
+		for (u8& v : data)
+		{
+			v = static_cast<u8>(rng());
+		}
+
+		return data;
+	}
+
+	template <usz Size>
+	static void test_swizzle_2d(u16 width, u16 height, u32 pitch_in_texels)
+	{
+		using texel = std::array<u8, Size>;
+
+		const usz swizzled_size = (usz{1} << (ceil_log2(width) + ceil_log2(height))) * Size;
+		const usz linear_size = usz{pitch_in_texels} * height * Size;
+		const u32 pitch = pitch_in_texels * Size;
+
+		// Swizzled to linear
+		{
+			const std::vector<u8> src = make_random_bytes(swizzled_size);
+			std::vector<u8> expected(linear_size, 0xcd);
+			std::vector<u8> result(linear_size, 0xcd);
+
+			reference_linear_swizzle<texel, true>(src.data(), expected.data(), width, height, pitch);
+			convert_linear_swizzle<texel, true>(src.data(), result.data(), width, height, pitch);
+
+			EXPECT_EQ(expected, result) << "deswizzle " << width << "x" << height << " pitch=" << pitch << " texel=" << Size;
+		}
+
+		// Linear to swizzled
+		{
+			const std::vector<u8> src = make_random_bytes(linear_size);
+			std::vector<u8> expected(swizzled_size, 0xcd);
+			std::vector<u8> result(swizzled_size, 0xcd);
+
+			reference_linear_swizzle<texel, false>(src.data(), expected.data(), width, height, pitch);
+			convert_linear_swizzle<texel, false>(src.data(), result.data(), width, height, pitch);
+
+			EXPECT_EQ(expected, result) << "swizzle " << width << "x" << height << " pitch=" << pitch << " texel=" << Size;
+		}
+	}
+
+	template <usz Size>
+	static void test_swizzle_3d(u16 width, u16 height, u16 depth)
+	{
+		using texel = std::array<u8, Size>;
+
+		const usz swizzled_size = (usz{1} << (ceil_log2(width) + ceil_log2(height) + ceil_log2(depth))) * Size;
+		const usz linear_size = usz{width} * height * depth * Size;
+
+		const std::vector<u8> src = make_random_bytes(swizzled_size);
+		std::vector<u8> expected(linear_size, 0xcd);
+		std::vector<u8> result(linear_size, 0xcd);
+
+		reference_linear_swizzle_3d<texel>(src.data(), expected.data(), width, height, depth);
+		convert_linear_swizzle_3d<texel>(src.data(), result.data(), width, height, depth);
+
+		EXPECT_EQ(expected, result) << "deswizzle " << width << "x" << height << "x" << depth << " texel=" << Size;
+	}
+
+	template <typename F>
+	static void for_each_texel_size(F&& func)
+	{
+		func.template operator()<1>();
+		func.template operator()<2>();
+		func.template operator()<4>();
+		func.template operator()<8>();
+		func.template operator()<16>();
+	}
+
+	TEST(RSXSwizzle, Surface2D)
+	{
+		static constexpr std::array<std::array<u16, 2>, 16> sizes
+		{{
+			{1, 1}, {1, 16}, {16, 1}, {2, 2}, {2, 8}, {8, 2}, {3, 5}, {4, 4},
+			{6, 10}, {16, 16}, {64, 16}, {16, 64}, {100, 60}, {128, 128}, {256, 32}, {32, 256},
+		}};
+
+		for_each_texel_size([&]<usz Size>()
+		{
+			for (const auto& [width, height] : sizes)
+			{
+				test_swizzle_2d<Size>(width, height, width);
+				test_swizzle_2d<Size>(width, height, width + 3);
+			}
+		});
+	}
+
+	TEST(RSXSwizzle, Surface2DLarge)
+	{
+		// Big enough to be split into slices
+		test_swizzle_2d<1>(4096, 2048, 4096);
+		test_swizzle_2d<4>(1024, 1024, 1024);
+		test_swizzle_2d<4>(2048, 512, 2048);
+		test_swizzle_2d<16>(512, 512, 600);
+	}
+
+	TEST(RSXSwizzle, Volume3D)
+	{
+		static constexpr std::array<std::array<u16, 3>, 10> sizes
+		{{
+			{1, 1, 2}, {2, 2, 2}, {4, 4, 2}, {1, 8, 8}, {8, 1, 8}, {3, 5, 7},
+			{16, 8, 4}, {4, 16, 32}, {32, 32, 1}, {64, 64, 64},
+		}};
+
+		for_each_texel_size([&]<usz Size>()
+		{
+			for (const auto& [width, height, depth] : sizes)
+			{
+				test_swizzle_3d<Size>(width, height, depth);
+			}
+		});
+	}
+}
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include "rsx_texture_cache_mock.h"
+
+namespace rsx::mock
+{
+	static constexpr u32 s_argb8 = CELL_GCM_TEXTURE_A8R8G8B8;
+
+	static u32 texel_at(const texture_cache::sampled_image_descriptor& desc, u32 x, u32 y)
+	{
+		const mock::image* img = ensure(desc.image_handle)->image();
+		u32 value;
+		std::memcpy(&value, img->data.data() + y * img->pitch() + x * 4, 4);
+		return value;
+	}
+
+	TEST(RSXTextureCache, UploadHitAfterMiss)
+	{
+		harness h;
+		std::memset(environment::local_ptr(0x100000), 0x11, 64 * 256);
+
+		const auto first = h.upload(0x100000, 64, 64, 256, s_argb8);
+		ASSERT_NE(first.image_handle, nullptr);
+		EXPECT_EQ(h.cmd.uploads, 1u);
+		EXPECT_EQ(h.stats.upload_misses, 1u);
+		EXPECT_EQ(texel_at(first, 63, 63), 0x11111111u);
+
+		// Same descriptor, served from the cache
+		const auto second = h.upload(0x100000, 64, 64, 256, s_argb8);
+		EXPECT_EQ(second.image_handle, first.image_handle);
+		EXPECT_EQ(h.cmd.uploads, 1u);
+		EXPECT_EQ(h.stats.upload_misses, 1u);
+		EXPECT_EQ(h.cache.get_locked_sections_count(), 1u);
+	}
+
+	TEST(RSXTextureCache, WriteInvalidatesSection)
+	{
+		harness h;
+		std::memset(environment::local_ptr(0x200000), 0x22, 32 * 128);
+
+		h.upload(0x200000, 32, 32, 128, s_argb8);
+		ASSERT_NE(h.cache.find_section(utils::address_range::start_length(rsx::constants::local_mem_base + 0x200000, 32 * 128)), nullptr);
+
+		// Writing anywhere in the section unlocks it, the next sample uploads the new data
+		h.write(0x200000 + 16 * 128, 4, 0x33);
+		EXPECT_EQ(h.stats.violations, 1u);
+		EXPECT_EQ(h.cache.get_locked_sections_count(), 0u);
+
+		const auto desc = h.upload(0x200000, 32, 32, 128, s_argb8);
+		EXPECT_EQ(h.cmd.uploads, 2u);
+		EXPECT_EQ(texel_at(desc, 0, 16), 0x33333333u);
+		EXPECT_EQ(texel_at(desc, 1, 16), 0x22222222u);
+
+		// Writes outside of the section are not violations
+		h.write(0x300000, 0x1000, 0);
+		EXPECT_EQ(h.stats.violations, 1u);
+	}
+
+	TEST(RSXTextureCache, AccessViolation)
+	{
+		harness h;
+
+		h.upload(0x500000, 32, 32, 128, s_argb8);
+		h.upload(0x900000, 32, 32, 128, s_argb8);
+
+		// Between both textures but in a memory block without locked sections
+		EXPECT_FALSE(h.cache.invalidate_address(h.cmd, rsx::constants::local_mem_base + 0x700000, rsx::invalidation_cause::deferred_write).violation_handled);
+
+		// Same block as a texture but another page
+		EXPECT_FALSE(h.cache.invalidate_address(h.cmd, rsx::constants::local_mem_base + 0x580000, rsx::invalidation_cause::deferred_write).violation_handled);
+		EXPECT_EQ(h.cache.get_locked_sections_count(), 2u);
+
+		EXPECT_TRUE(h.cache.invalidate_address(h.cmd, rsx::constants::local_mem_base + 0x500100, rsx::invalidation_cause::deferred_write).violation_handled);
+		EXPECT_EQ(h.cache.get_locked_sections_count(), 1u);
+		EXPECT_EQ(h.cache.get_num_write_faults_this_frame(), 1u);
+
+		// Unlocked blocks are skipped again
+		EXPECT_FALSE(h.cache.invalidate_address(h.cmd, rsx::constants::local_mem_base + 0x500100, rsx::invalidation_cause::deferred_write).violation_handled);
+	}
+
+	TEST(RSXTextureCache, FlushFramebufferMemory)
+	{
+		harness h;
+		std::memset(environment::local_ptr(0x400000), 0, 64 * 256);
+
+		h.lock(0x400000, 64, 64, 256, s_argb8, 0xab);
+
+		// A CPU read of framebuffer memory must write the render target back
+		const auto result = h.invalidate(0x400000, 4, rsx::invalidation_cause::deferred_read);
+		EXPECT_TRUE(result.violation_handled);
+		EXPECT_EQ(result.sections_to_flush.size(), 1u);
+
+		h.flush();
+		EXPECT_EQ(h.cmd.dma_transfers, 1u);
+		EXPECT_EQ(h.stats.flushed_sections, 1u);
+		EXPECT_EQ(environment::local_ptr(0x400000)[0], 0xab);
+		EXPECT_EQ(environment::local_ptr(0x400000)[64 * 256 - 1], 0xab);
+	}
+
+	TEST(RSXTextureCache, FrameEndPurgesUnreleasedSections)
+	{
+		harness h;
+
+		for (u32 i = 0; i < 80; i++)
+		{
+			h.upload(0x800000 + i * 0x4000, 32, 32, 128, s_argb8);
+		}
+
+		EXPECT_EQ(h.cache.get_locked_sections_count(), 80u);
+
+		// Invalidated sections keep their images until they are reused or purged
+		h.invalidate(0x800000, 80 * 0x4000, rsx::invalidation_cause::write);
+		EXPECT_EQ(h.cache.get_locked_sections_count(), 0u);
+		EXPECT_GE(h.cache.get_unreleased_textures_count(), 64u);
+
+		h.end_frame();
+		EXPECT_EQ(h.cache.get_unreleased_textures_count(), 0u);
+		EXPECT_EQ(h.cache.get_texture_memory_in_use(), 0u);
+	}
+
+	TEST(RSXTextureCache, DeduplicateReuploads)
+	{
+		g_cfg.video.deduplicate_texture_uploads.set(true);
+
+		harness h;
+		std::memset(environment::local_ptr(0x600000), 0x44, 64 * 256);
+
+		const auto first = h.upload(0x600000, 64, 64, 256, s_argb8);
+		EXPECT_EQ(h.cmd.uploads, 1u);
+
+		// Invalidated and streamed in again with the same data, the previous image is revived
+		h.write(0x600000, 4, 0x44);
+		EXPECT_EQ(h.cache.get_locked_sections_count(), 0u);
+
+		const auto second = h.upload(0x600000, 64, 64, 256, s_argb8);
+		EXPECT_EQ(second.image_handle->image(), first.image_handle->image());
+		EXPECT_EQ(h.cmd.uploads, 1u);
+		EXPECT_EQ(h.stats.dedup_hits, 1u);
+		EXPECT_EQ(h.cache.get_locked_sections_count(), 1u);
+
+		// Same data at another address is copied from the existing image
+		std::memcpy(environment::local_ptr(0x680000), environment::local_ptr(0x600000), 64 * 256);
+
+		const auto moved = h.upload(0x680000, 64, 64, 256, s_argb8);
+		EXPECT_NE(moved.image_handle->image(), first.image_handle->image());
+		EXPECT_EQ(h.cmd.uploads, 1u);
+		EXPECT_EQ(h.cmd.copies, 1u);
+		EXPECT_EQ(h.stats.dedup_hits, 2u);
+		EXPECT_EQ(texel_at(moved, 63, 63), 0x44444444u);
+
+		// Different data is uploaded
+		h.write(0x600000, 4, 0x55);
+
+		const auto changed = h.upload(0x600000, 64, 64, 256, s_argb8);
+		EXPECT_EQ(h.cmd.uploads, 2u);
+		EXPECT_EQ(texel_at(changed, 0, 0), 0x55555555u);
+		EXPECT_EQ(texel_at(changed, 1, 0), 0x44444444u);
+		EXPECT_EQ(h.cache.get_texture_upload_dedup_hits_this_frame(), 2u);
+		EXPECT_EQ(h.cache.get_texture_upload_dedup_misses_this_frame(), 2u);
+
+		g_cfg.video.deduplicate_texture_uploads.set(false);
+	}
+
+	TEST(RSXTextureCache, TraceReplay)
+	{
+		const auto ops = parse_trace(
+			"# texture streaming\n"
+			"upload 0x1000000 64 64 256 0x85\n"
+			"upload 0x1000000 64 64 256 0x85 # hit\n"
+			"write 0x1000000 16\n"
+			"upload 0x1000000 64 64 256 0x85\n"
+			"\n"
+			"lock 0x1100000 32 32 128 0x85\n"
+			"invalidate 0x1100000 128 deferred_read\n"
+			"flush\n"
+			"frame\n");
+
+		ASSERT_EQ(ops.size(), 8u);
+		EXPECT_EQ(ops[0].type, op_type::upload);
+		EXPECT_EQ(ops[0].offset, 0x1000000u);
+		EXPECT_EQ(ops[0].format, s_argb8);
+		EXPECT_EQ(ops[0].mipmaps, 1u);
+		EXPECT_EQ(ops[5].cause, rsx::invalidation_cause::deferred_read);
+
+		harness h;
+		h.replay(ops);
+
+		EXPECT_EQ(h.stats.uploads, 3u);
+		EXPECT_EQ(h.stats.upload_misses, 2u);
+		EXPECT_EQ(h.stats.locks, 1u);
+		EXPECT_EQ(h.stats.flushed_sections, 1u);
+		EXPECT_EQ(h.stats.frames, 1u);
+
+		EXPECT_ANY_THROW(parse_trace("upload 0x1000\n"));
+		EXPECT_ANY_THROW(parse_trace("draw 0 0\n"));
+	}
+}
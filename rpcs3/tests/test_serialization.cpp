@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include "util/serialization_ext.hpp"
+#include "Utilities/File.h"
+
+namespace utils
+{
+	static constexpr u64 s_value_count = 0x40000;
+	static constexpr u64 s_values_per_frame = 0x4000;
+
+	static u64 value_at(u64 index)
+	{
+		return index * 0x9e3779b97f4a7c15 >> 40;
+	}
+
+	// Savestate-like zstd stream made of many frames (one per breathe)
+	static std::vector<u8> write_zstd_stream()
+	{
+		fs::file file = fs::make_stream<std::vector<u8>>();
+
+		{
+			serial ar;
+			ar.m_file_handler = make_compressed_zstd_serialization_file_handler(file);
+
+			for (u64 i = 0; i < s_value_count; i++)
+			{
+				ar(value_at(i));
+
+				if (i % s_values_per_frame == s_values_per_frame - 1)
+				{
+					ar.breathe(true);
+				}
+			}
+
+			ar.m_file_handler->finalize(ar);
+		}
+
+		file.seek(0);
+		return file.to_vector<u8>();
+	}
+
+	static void open_zstd_reader(serial& ar, std::vector<u8> data)
+	{
+		ar.set_reading_state();
+		ar.m_file_handler = make_compressed_zstd_serialization_file_handler(fs::make_stream(std::move(data)));
+	}
+
+	// Remove the trailing skippable frame, as written by older versions
+	static std::vector<u8> strip_seek_table(std::vector<u8> data)
+	{
+		const u32 frame_count = read_from_ptr<le_t<u32>>(data, data.size() - 9);
+		data.resize(data.size() - (8 + frame_count * 8 + 9));
+		return data;
+	}
+
+	TEST(Serialization, ZstdSeekTable)
+	{
+		const std::vector<u8> data = write_zstd_stream();
+
+		ASSERT_GT(data.size(), 9u);
+		EXPECT_EQ(read_from_ptr<le_t<u32>>(data, data.size() - 4), 0x8F92EAB1u);
+		EXPECT_EQ(read_from_ptr<le_t<u32>>(data, data.size() - 9), s_value_count / s_values_per_frame);
+
+		serial ar;
+		open_zstd_reader(ar, data);
+
+		for (u64 i = 0; i < s_value_count; i++)
+		{
+			if (ar.pop<u64>() != value_at(i))
+			{
+				FAIL() << "Mismatch at index " << i;
+			}
+
+			ar.breathe();
+		}
+
+		// Exact size is known from the seek table
+		EXPECT_EQ(ar.get_size(), s_value_count * sizeof(u64));
+		EXPECT_TRUE(ar.m_file_handler->is_valid());
+	}
+
+	TEST(Serialization, ZstdSeek)
+	{
+		serial ar;
+		open_zstd_reader(ar, write_zstd_stream());
+
+		// Forwards over many frames, into the middle of a frame, then backwards
+		for (u64 index : {u64{1}, s_value_count - 3, s_values_per_frame * 5 + 7, u64{0}, s_value_count / 2})
+		{
+			ar.seek_pos(index * sizeof(u64), true);
+			EXPECT_EQ(ar.pop<u64>(), value_at(index)) << index;
+			EXPECT_EQ(ar.pop<u64>(), value_at(index + 1)) << index;
+		}
+
+		EXPECT_TRUE(ar.m_file_handler->is_valid());
+
+		// Without cleanup, backwards out of the loaded data
+		serial ar2;
+		open_zstd_reader(ar2, write_zstd_stream());
+
+		ar2.seek_pos((s_value_count - 2) * sizeof(u64), true);
+		EXPECT_EQ(ar2.pop<u64>(), value_at(s_value_count - 2));
+		ar2.seek_pos(sizeof(u64));
+		EXPECT_EQ(ar2.pop<u64>(), value_at(1));
+		EXPECT_TRUE(ar2.m_file_handler->is_valid());
+	}
+
+	TEST(Serialization, ZstdWithoutSeekTable)
+	{
+		const std::vector<u8> data = strip_seek_table(write_zstd_stream());
+
+		serial ar;
+		open_zstd_reader(ar, data);
+
+		for (u64 i = 0; i < s_value_count; i++)
+		{
+			if (ar.pop<u64>() != value_at(i))
+			{
+				FAIL() << "Mismatch at index " << i;
+			}
+
+			ar.breathe();
+		}
+
+		// Sequential streams can only skip forwards
+		serial ar2;
+		open_zstd_reader(ar2, data);
+		ar2.seek_pos(s_values_per_frame * 3 * sizeof(u64), true);
+		EXPECT_EQ(ar2.pop<u64>(), value_at(s_values_per_frame * 3));
+	}
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include "Utilities/Thread.h"
+
+namespace utils
+{
+	TEST(TaskPool, RunsEverySlot)
+	{
+		// Repeated short jobs are served by the same parked workers
+		for (u32 i = 0; i < 100; i++)
+		{
+			atomic_t<u32> mask = 0;
+
+			const auto job = task_pool::submit("Test Job", 8, task_priority::normal, [&](task_job&, u32 slot)
+			{
+				mask |= 1u << slot;
+			});
+
+			EXPECT_TRUE(job->join());
+			EXPECT_TRUE(job->is_finished());
+			EXPECT_EQ(mask, 0xffu);
+		}
+	}
+
+	TEST(TaskPool, CancelRetiresUnclaimedSlots)
+	{
+		atomic_t<u32> started = 0;
+		atomic_t<u32> release = 0;
+
+		// Occupy every pool thread so the next job cannot start
+		const u32 threads = task_pool::get_thread_limit();
+
+		const auto blocker = task_pool::submit("Test Blocker", threads, task_priority::high, [&](task_job&, u32)
+		{
+			started++;
+
+			while (!release)
+			{
+				release.wait(0);
+			}
+		});
+
+		while (started != threads)
+		{
+			std::this_thread::yield();
+		}
+
+		atomic_t<u32> ran = 0;
+
+		const auto job = task_pool::submit("Test Cancelled", 4, task_priority::normal, [&](task_job&, u32)
+		{
+			ran++;
+		});
+
+		job->cancel();
+
+		// Must not wait for slots which will never run
+		EXPECT_FALSE(job->join());
+		EXPECT_TRUE(job->is_finished());
+		EXPECT_EQ(ran, 0u);
+
+		release = 1;
+		release.notify_all();
+		EXPECT_TRUE(blocker->join());
+	}
+}
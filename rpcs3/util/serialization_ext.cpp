@@ -787,6 +787,13 @@ struct compressed_zstd_stream_data
 	lf_queue<std::vector<u8>> m_queued_data_to_write;
 };
 
+// Seek table layout of the zstd seekable format (contrib/seekable_format in the zstd repository):
+// skippable frame header, 8-byte entries (compressed and decompressed frame sizes) and a 9-byte footer
+static constexpr u32 s_zstd_skippable_magic = 0x184D2A5E;
+static constexpr u32 s_zstd_seekable_magic = 0x8F92EAB1;
+static constexpr usz s_zstd_seek_header_size = 8;
+static constexpr usz s_zstd_seek_footer_size = 9;
+
 void compressed_zstd_serialization_file_handler::initialize(utils::serial& ar)
 {
 	if (!m_stream)
@@ -811,6 +818,7 @@ void compressed_zstd_serialization_file_handler::initialize(utils::serial& ar)
 
 		m_compression_threads.clear();
 		m_file_writer_thread.reset();
+		m_seek_table.clear();
 
 		// Make sure at least one thread is free
 		// Limit thread count in order to make sure memory limits are under control (TODO: scale with RAM size)
@@ -840,6 +848,10 @@ void compressed_zstd_serialization_file_handler::initialize(utils::serial& ar)
 		m_stream->m_zs = ZSTD_createDStream();
 		m_read_inited = true;
 		m_errored = false;
+
+		// Streams without a seek table (older savestates) are decompressed sequentially
+		m_decoded_frames.clear();
+		m_seekable = load_seek_table();
 	}
 }
 
@@ -957,12 +969,12 @@ bool compressed_zstd_serialization_file_handler::handle_file_op(utils::serial& a
 		return false;
 	}
 
-	// TODO: Investigate if this optimization is worth an implementation for compressed stream
-	// if (ar.data.empty() && pos != ar.pos)
-	// {
-	// 	// Relocate instead of over-fetch
-	// 	ar.seek_pos(pos);
-	// }
+	if (m_seekable && (pos < ar.data_offset || pos > ar.data_offset + ar.data.size()))
+	{
+		// Relocate instead of over-fetch (or reading backwards), any frame can be decompressed on its own
+		ar.data_offset = pos;
+		ar.data.clear();
+	}
 
 	const usz read_pre_buffer = utils::sub_saturate<usz>(ar.data_offset, pos);
 
@@ -1012,6 +1024,11 @@ usz compressed_zstd_serialization_file_handler::read_at(utils::serial& ar, usz r
 
 	initialize(ar);
 
+	if (m_seekable)
+	{
+		return read_frames_at(read_pos, static_cast<u8*>(data), size);
+	}
+
 	auto& m_zd = m_stream->m_zd;
 
 	const usz total_to_read = size;
@@ -1100,9 +1117,293 @@ usz compressed_zstd_serialization_file_handler::read_at(utils::serial& ar, usz r
 	return read_size;
 }
 
+usz compressed_zstd_serialization_file_handler::read_frames_at(usz read_pos, u8* data, usz size)
+{
+	usz read_size = 0;
+
+	while (read_size < size && read_pos + read_size < m_stream_size)
+	{
+		const usz pos = read_pos + read_size;
+
+		// Find the last frame starting at or before pos (the first frame always starts at 0)
+		const auto it = std::upper_bound(m_seek_table.begin(), m_seek_table.end(), pos, [](usz value, const seek_frame_t& frame)
+		{
+			return value < frame.data_offset;
+		});
+
+		const usz index = (it - m_seek_table.begin()) - 1;
+		const seek_frame_t& frame = m_seek_table[index];
+
+		const std::vector<u8>* decoded = nullptr;
+
+		if (!m_decoded_frames.empty() && index >= m_decoded_frames.front().first && index - m_decoded_frames.front().first < m_decoded_frames.size())
+		{
+			decoded = &m_decoded_frames[index - m_decoded_frames.front().first].second;
+		}
+		else
+		{
+			decoded = decode_frames(index);
+		}
+
+		if (!decoded)
+		{
+			m_errored = true;
+			sys_log.error("Failure of compressed data reading. (frame=%d, read_pos=0x%x, file_offset=0x%x)", index, pos, frame.file_offset);
+			break;
+		}
+
+		const usz offset = pos - frame.data_offset;
+		const usz count = std::min<usz>(size - read_size, decoded->size() - offset);
+
+		std::memcpy(data + read_size, decoded->data() + offset, count);
+		read_size += count;
+
+		if (offset + count == decoded->size() && index == m_decoded_frames.front().first)
+		{
+			// Frame is consumed, release its memory
+			m_decoded_frames.pop_front();
+		}
+	}
+
+	return read_size;
+}
+
+std::pair<std::shared_ptr<compressed_zstd_serialization_file_handler::decode_batch_t>, shared_ptr<task_job>> compressed_zstd_serialization_file_handler::start_decode_batch(usz first)
+{
+	// Decompress a frame per thread, limit memory usage of a batch to 128MB (two batches may be held at once)
+	const usz max_frames = std::clamp<usz>(utils::get_thread_count(), 1, 16);
+
+	usz last = first;
+
+	for (u64 batch_size = 0; last < m_seek_table.size() && last - first < max_frames; last++)
+	{
+		batch_size += m_seek_table[last].decompressed_size;
+
+		if (last != first && batch_size > 0x800'0000)
+		{
+			break;
+		}
+	}
+
+	const u64 file_start = m_seek_table[first].file_offset;
+	const u64 file_end = m_seek_table[last - 1].file_offset + m_seek_table[last - 1].compressed_size;
+
+	auto batch = std::make_shared<decode_batch_t>();
+	batch->frames.assign(m_seek_table.begin() + first, m_seek_table.begin() + last);
+	batch->compressed.resize(file_end - file_start);
+
+	if (m_file->read_at(file_start, batch->compressed.data(), batch->compressed.size()) != batch->compressed.size())
+	{
+		return {};
+	}
+
+	for (usz i = first; i < last; i++)
+	{
+		batch->decoded.emplace_back(i, std::vector<u8>(m_seek_table[i].decompressed_size));
+	}
+
+	// The job only references the batch, so it may outlive the handler
+	auto job = task_pool::submit("CompressedRead", ::narrow<u32>(last - first), task_priority::high, [batch](task_job& job, u32)
+	{
+		ZSTD_DCtx* ctx = ZSTD_createDCtx();
+
+		for (usz i = batch->next++; i < batch->frames.size() && !job.is_cancelled(); i = batch->next++)
+		{
+			const seek_frame_t& frame = batch->frames[i];
+			std::vector<u8>& out = batch->decoded[i].second;
+
+			const usz res = ZSTD_decompressDCtx(ctx, out.data(), out.size(), batch->compressed.data() + (frame.file_offset - batch->frames[0].file_offset), frame.compressed_size);
+
+			if (ZSTD_isError(res) || res != out.size())
+			{
+				batch->failed = true;
+			}
+		}
+
+		ZSTD_freeDCtx(ctx);
+	});
+
+	return {std::move(batch), std::move(job)};
+}
+
+void compressed_zstd_serialization_file_handler::cancel_prefetch()
+{
+	if (m_prefetch_job)
+	{
+		m_prefetch_job->cancel();
+		m_prefetch_job->join();
+	}
+
+	m_prefetch_job.reset();
+	m_prefetch.reset();
+}
+
+const std::vector<u8>* compressed_zstd_serialization_file_handler::decode_frames(usz first)
+{
+	m_decoded_frames.clear();
+
+	std::shared_ptr<decode_batch_t> batch;
+	shared_ptr<task_job> job;
+
+	if (m_prefetch && m_prefetch->decoded.front().first == first)
+	{
+		// Sequential read: the batch has been decompressed while the previous one was consumed
+		batch = std::move(m_prefetch);
+		job = std::move(m_prefetch_job);
+	}
+	else
+	{
+		cancel_prefetch();
+		std::tie(batch, job) = start_decode_batch(first);
+	}
+
+	if (!batch)
+	{
+		return nullptr;
+	}
+
+	// Take the frames not claimed by the pool yet instead of waiting idle
+	job->help();
+
+	if (!job->join() || batch->failed)
+	{
+		return nullptr;
+	}
+
+	m_decoded_frames = std::move(batch->decoded);
+
+	if (const usz next = m_decoded_frames.back().first + 1; next < m_seek_table.size())
+	{
+		std::tie(m_prefetch, m_prefetch_job) = start_decode_batch(next);
+	}
+
+	return &m_decoded_frames.front().second;
+}
+
+bool compressed_zstd_serialization_file_handler::load_seek_table()
+{
+	m_seek_table.clear();
+	m_stream_size = 0;
+
+	const u64 file_size = m_file->size();
+
+	if (file_size < s_zstd_seek_header_size + s_zstd_seek_footer_size)
+	{
+		return false;
+	}
+
+	u8 footer[s_zstd_seek_footer_size];
+
+	if (m_file->read_at(file_size - sizeof(footer), footer, sizeof(footer)) != sizeof(footer) || read_from_ptr<le_t<u32>>(footer, 5) != s_zstd_seekable_magic)
+	{
+		return false;
+	}
+
+	const u32 frame_count = read_from_ptr<le_t<u32>>(footer);
+	const u8 descriptor = footer[4];
+
+	if (descriptor & 0x7f)
+	{
+		// Reserved bits
+		return false;
+	}
+
+	// Optional checksum per entry
+	const usz entry_size = descriptor & 0x80 ? 12 : 8;
+	const u64 table_size = s_zstd_seek_header_size + u64{frame_count} * entry_size + s_zstd_seek_footer_size;
+
+	if (!frame_count || table_size > file_size)
+	{
+		return false;
+	}
+
+	std::vector<u8> table(table_size);
+
+	if (m_file->read_at(file_size - table_size, table.data(), table.size()) != table.size() ||
+		read_from_ptr<le_t<u32>>(table) != s_zstd_skippable_magic || read_from_ptr<le_t<u32>>(table, 4) != table_size - s_zstd_seek_header_size)
+	{
+		return false;
+	}
+
+	u64 file_offset = 0;
+	u64 data_offset = 0;
+
+	for (u32 i = 0; i < frame_count; i++)
+	{
+		const usz entry = s_zstd_seek_header_size + i * entry_size;
+		const u32 compressed_size = read_from_ptr<le_t<u32>>(table, entry);
+		const u32 decompressed_size = read_from_ptr<le_t<u32>>(table, entry + 4);
+
+		m_seek_table.push_back(seek_frame_t{file_offset, data_offset, compressed_size, decompressed_size});
+
+		file_offset += compressed_size;
+		data_offset += decompressed_size;
+	}
+
+	if (file_offset != file_size - table_size)
+	{
+		// Frames were appended after the table, or the file is truncated
+		sys_log.warning("Ignoring mismatching seek table of compressed stream. (frames=%d, file_size=0x%x, table_size=0x%x)", frame_count, file_size, table_size);
+		m_seek_table.clear();
+		return false;
+	}
+
+	m_stream_size = data_offset;
+	return true;
+}
+
+void compressed_zstd_serialization_file_handler::write_seek_table()
+{
+	if (m_seek_table.empty() || m_seek_table.size() >= u32{umax})
+	{
+		return;
+	}
+
+	for (const seek_frame_t& frame : m_seek_table)
+	{
+		if (frame.compressed_size > u32{umax} || frame.decompressed_size > u32{umax})
+		{
+			// Entries are 32-bit (also fails if the frame content size is unknown), the stream can still be read sequentially
+			sys_log.warning("Compressed stream is written without a seek table. (compressed_size=0x%x, decompressed_size=0x%x)", frame.compressed_size, frame.decompressed_size);
+			return;
+		}
+	}
+
+	std::vector<u8> table(s_zstd_seek_header_size + m_seek_table.size() * 8 + s_zstd_seek_footer_size);
+
+	write_to_ptr<le_t<u32>>(table, 0, s_zstd_skippable_magic);
+	write_to_ptr<le_t<u32>>(table, 4, ::narrow<u32>(table.size() - s_zstd_seek_header_size));
+
+	for (usz i = 0; i < m_seek_table.size(); i++)
+	{
+		write_to_ptr<le_t<u32>>(table, s_zstd_seek_header_size + i * 8, static_cast<u32>(m_seek_table[i].compressed_size));
+		write_to_ptr<le_t<u32>>(table, s_zstd_seek_header_size + i * 8 + 4, static_cast<u32>(m_seek_table[i].decompressed_size));
+	}
+
+	const usz footer = table.size() - s_zstd_seek_footer_size;
+
+	write_to_ptr<le_t<u32>>(table, footer, static_cast<u32>(m_seek_table.size()));
+	table[footer + 4] = 0; // No checksums
+	write_to_ptr<le_t<u32>>(table, footer + 5, s_zstd_seekable_magic);
+
+	m_file->write(table);
+}
+
 void compressed_zstd_serialization_file_handler::skip_until(utils::serial& ar)
 {
-	ensure(!ar.is_writing() && ar.pos >= ar.data_offset);
+	ensure(!ar.is_writing());
+
+	initialize(ar);
+
+	if (m_seekable && (ar.pos < ar.data_offset || ar.pos > ar.data_offset + ar.data.size()))
+	{
+		// Relocate, decompression can start at any frame without reading the data inbetween
+		ar.data_offset = ar.pos;
+		ar.data.clear();
+		return;
+	}
+
+	ensure(ar.pos >= ar.data_offset);
 
 	if (ar.pos > ar.data_offset)
 	{
@@ -1126,6 +1427,10 @@ void compressed_zstd_serialization_file_handler::finalize(utils::serial& ar)
 		//ZSTD_decompressEnd(m_stream->m_zd);
 		ensure(ZSTD_freeDCtx(m_zd));
 		m_read_inited = false;
+		m_seekable = false;
+		cancel_prefetch();
+		m_seek_table.clear();
+		m_decoded_frames.clear();
 		return;
 	}
 
@@ -1212,8 +1517,14 @@ void compressed_zstd_serialization_file_handler::finalize(utils::serial& ar)
 		(*m_file_writer_thread)();
 	}
 
+	if (!m_errored)
+	{
+		write_seek_table();
+	}
+
 	m_compression_threads.clear();
 	m_file_writer_thread.reset();
+	m_seek_table.clear();
 
 	m_stream_data = {};
 	m_write_inited = false;
@@ -1298,6 +1609,12 @@ void compressed_zstd_serialization_file_handler::file_writer_thread_op()
 		}
 
 		m_file->write(*data);
+
+		// Frames are written in order, record them for the seek table
+		const u64 file_offset = m_seek_table.empty() ? 0 : m_seek_table.back().file_offset + m_seek_table.back().compressed_size;
+		const u64 data_offset = m_seek_table.empty() ? 0 : m_seek_table.back().data_offset + m_seek_table.back().decompressed_size;
+
+		m_seek_table.push_back(seek_frame_t{file_offset, data_offset, data->size(), ZSTD_getFrameContentSize(data->data(), data->size())});
 	}
 }
 
@@ -1310,6 +1627,12 @@ usz compressed_zstd_serialization_file_handler::get_size(const utils::serial& ar
 
 	const usz memory_available = ar.data_offset + ar.data.size();
 
+	if (m_seekable)
+	{
+		// Exact size from the seek table
+		return std::max<usz>(m_stream_size, memory_available);
+	}
+
 	if (memory_available >= recommended || !*m_file)
 	{
 		// Avoid calling size() if possible
@@ -183,7 +183,39 @@ private:
 	std::shared_ptr<compressed_zstd_stream_data> m_stream;
 	std::unique_ptr<named_thread<std::function<void()>>> m_file_writer_thread;
 
+	// Every compressed block is an independent zstd frame, the seek table (zstd seekable format) is appended on finalize
+	struct seek_frame_t
+	{
+		u64 file_offset;
+		u64 data_offset;
+		u64 compressed_size;
+		u64 decompressed_size;
+	};
+
+	// Frames decompressed by the task pool, the batch following the one being read is decompressed ahead
+	struct decode_batch_t
+	{
+		std::vector<seek_frame_t> frames;
+		std::vector<u8> compressed;
+		std::deque<std::pair<usz, std::vector<u8>>> decoded;
+		atomic_t<usz> next = 0;
+		atomic_t<bool> failed = false;
+	};
+
+	std::vector<seek_frame_t> m_seek_table;
+	std::deque<std::pair<usz, std::vector<u8>>> m_decoded_frames;
+	std::shared_ptr<decode_batch_t> m_prefetch;
+	shared_ptr<task_job> m_prefetch_job;
+	usz m_stream_size = 0;
+	bool m_seekable = false;
+
 	usz read_at(utils::serial& ar, usz read_pos, void* data, usz size);
+	usz read_frames_at(usz read_pos, u8* data, usz size);
+	const std::vector<u8>* decode_frames(usz first);
+	std::pair<std::shared_ptr<decode_batch_t>, shared_ptr<task_job>> start_decode_batch(usz first);
+	void cancel_prefetch();
+	bool load_seek_table();
+	void write_seek_table();
 	void initialize(utils::serial& ar);
 	void stream_data_prepare_thread_op();
 	void file_writer_thread_op();
@@ -35,6 +35,8 @@ namespace utils
 
 	bool has_clwb();
 
+	bool has_sha();
+
 	bool has_invariant_tsc();
 
 	bool has_fma3();
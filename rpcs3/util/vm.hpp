@@ -114,6 +114,16 @@ namespace utils
 			return m_size;
 		}
 
+		// Get file descriptor (file mapping handle on Windows)
+		native_handle get_handle() const
+		{
+#ifdef _WIN32
+			return m_handle;
+#else
+			return m_file;
+#endif
+		}
+
 		// Flags are unspecified, consider it userdata
 		u32 flags() const
 		{